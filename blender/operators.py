@@ -14,7 +14,7 @@ import bmesh
 from .preferences import load_interface
 
 
-def _get_convex_hull(obj, operator):
+def _get_convex_hull(obj):
     """
     Compute the convex hull of obj's mesh in local space with scale applied.
 
@@ -25,8 +25,8 @@ def _get_convex_hull(obj, operator):
     Returns:
         (vertices, faces) where vertices is a list of (x, y, z) tuples in local
         space and faces is a list of (i0, i1, i2) index triples (CCW winding).
-        Returns (None, None) if obj has no mesh data or the hull exceeds the
-        simulation's geometry limits (64 vertices / 32 triangular faces).
+        Returns (None, None) if obj has no mesh data. Hulls of any size are
+        supported.
     """
     if obj.type != 'MESH' or not obj.data or not obj.data.vertices:
         return None, None
@@ -60,14 +60,6 @@ def _get_convex_hull(obj, operator):
     finally:
         bm.free()
 
-    if len(vertices) > 64 or len(tri_faces) > 32:
-        operator.report(
-            {'WARNING'},
-            f"{obj.name}: convex hull has {len(vertices)} vertices / "
-            f"{len(tri_faces)} faces (limits: 64 / 32). Collision mesh skipped.",
-        )
-        return None, None
-
     return vertices, tri_faces
 
 
@@ -121,7 +113,7 @@ class PHYSICS_ENGINE_OT_run(bpy.types.Operator):
             self.report({'ERROR'}, err or "An unknown error occured")
             return {'CANCELLED'}
 
-        PhysicsObject, sim_run = result
+        PhysicsObject, Simulation = result
 
         objects = [obj for obj in context.scene.objects if obj.physics_engine.enabled]
         if not objects:
@@ -157,7 +149,7 @@ class PHYSICS_ENGINE_OT_run(bpy.types.Operator):
                 vy=obj.physics_engine.velocity[1],
                 vz=obj.physics_engine.velocity[2],
             )
-            verts, faces = _get_convex_hull(obj, self)
+            verts, faces = _get_convex_hull(obj)
             if verts is not None and faces is not None:
                 sim_obj.set_mesh(verts, faces)
             sim_objects.append(sim_obj)
@@ -170,17 +162,20 @@ class PHYSICS_ENGINE_OT_run(bpy.types.Operator):
         total = end - start
         wm.progress_begin(0, total)
 
-        # Advance the simulation one step per frame and record the resulting positions.
-        for i, frame in enumerate(range(start + 1, end + 1)):
-            sim_run(sim_objects, time_step, num_steps=1)
-            for obj, sim_obj in zip(objects, sim_objects):
-                obj.location = (
-                    sim_obj.position.x,
-                    sim_obj.position.y,
-                    sim_obj.position.z,
-                )
-                obj.keyframe_insert(data_path="location", frame=frame)
-            wm.progress_update(i)
+        # Advance the simulation one step per frame and record the resulting
+        # positions. One context serves the whole bake, so buffers and solver
+        # state carry over between frames.
+        with Simulation(sim_objects) as sim:
+            for i, frame in enumerate(range(start + 1, end + 1)):
+                sim.step(time_step, num_steps=1)
+                for obj, sim_obj in zip(objects, sim.objects):
+                    obj.location = (
+                        sim_obj.position.x,
+                        sim_obj.position.y,
+                        sim_obj.position.z,
+                    )
+                    obj.keyframe_insert(data_path="location", frame=frame)
+                wm.progress_update(i)
 
         wm.progress_end()
 
@@ -21,10 +21,10 @@ def load_interface():
     Import and return the simulation interface from the Physics Engine project.
 
     Ensures the configured project root is on ``sys.path``, then imports
-    ``PhysicsObject`` and ``sim_run`` from ``interface.nbody``.
+    ``PhysicsObject`` and ``Simulation`` from ``interface.nbody``.
 
     Returns:
-        tuple: ``((PhysicsObject, sim_run), None)`` on success, or
+        tuple: ``((PhysicsObject, Simulation), None)`` on success, or
                ``(None, error_message)`` if the root is unset or the import fails.
     """
     prefs = get_prefs()
@@ -34,8 +34,8 @@ def load_interface():
     if root not in sys.path:
         sys.path.insert(0, root)
     try:
-        from interface.nbody import PhysicsObject, sim_run
-        return (PhysicsObject, sim_run), None
+        from interface.nbody import PhysicsObject, Simulation
+        return (PhysicsObject, Simulation), None
     except FileNotFoundError as e:
         return None, str(e)
     except ImportError as e:
@@ -6,7 +6,7 @@ Build the library first:
     # produces build/src/logic/nbody_sim.so
 
 Usage:
-    from interface.nbody import Vec3, PhysicsObject, sim_run
+    from interface.nbody import Vec3, PhysicsObject, register_mesh, sim_run
 
     sun   = PhysicsObject(mass=1.989e30, x=0, y=0, z=0)
     earth = PhysicsObject(mass=5.972e24, x=1.496e11, y=0, z=0,
@@ -22,9 +22,6 @@ import ctypes
 import ctypes.util
 from pathlib import Path
 
-PHYS_MAX_VERTICES = 64
-PHYS_MAX_FACES    = 32
-
 
 def _preload_cuda() -> None:
     # libnbody_sim.so embeds CUDA device code whose __cudaRegisterFatBinary
@@ -80,14 +77,12 @@ class PhysicsObject(ctypes.Structure):
         ("velocity",     Vec3),
         ("acceleration", Vec3),
         ("force",        Vec3),
-        # Convex mesh geometry (local space, centred at origin).
-        # _pad fields match compiler alignment of Vec3 after int fields.
-        ("vertex_count", ctypes.c_int),
+        # Registered collision mesh id (see register_mesh); 0 = no mesh.
+        # _pad0 matches compiler alignment of the double that follows.
+        ("mesh_id",      ctypes.c_int),
         ("_pad0",        ctypes.c_int),
-        ("local_verts",  Vec3 * PHYS_MAX_VERTICES),
-        ("face_count",   ctypes.c_int),
-        ("_pad1",        ctypes.c_int),
-        ("face_indices", (ctypes.c_int * 3) * PHYS_MAX_FACES),
+        # Gravitational softening length (m); 0 = use the solver's global length.
+        ("softening",    ctypes.c_double),
     ]
 
     def __init__(
@@ -95,6 +90,7 @@ class PhysicsObject(ctypes.Structure):
         mass: float,
         x: float = 0.0, y: float = 0.0, z: float = 0.0,
         vx: float = 0.0, vy: float = 0.0, vz: float = 0.0,
+        softening: float = 0.0,
     ):
         super().__init__()
         self.mass         = mass
@@ -102,6 +98,7 @@ class PhysicsObject(ctypes.Structure):
         self.velocity     = Vec3(vx, vy, vz)
         self.acceleration = Vec3(0.0, 0.0, 0.0)
         self.force        = Vec3(0.0, 0.0, 0.0)
+        self.softening    = softening
 
     def set_mesh(
         self,
@@ -111,6 +108,9 @@ class PhysicsObject(ctypes.Structure):
         """
         Attach convex mesh geometry in local space (centred at origin).
 
+        The mesh is registered with register_mesh(), so objects given the same
+        vertices and faces share one stored copy.
+
         CONVEX GEOMETRY ONLY: collision detection uses the Separating Axis
         Theorem, which is only correct for convex meshes. Concave objects must
         be reduced to their convex hull before calling this method. Passing
@@ -120,20 +120,7 @@ class PhysicsObject(ctypes.Structure):
             vertices: List of (x, y, z) tuples — local-space vertex positions.
             faces:    List of (i0, i1, i2) index triples, CCW winding outward.
         """
-        if len(vertices) > PHYS_MAX_VERTICES:
-            raise ValueError(f"Too many vertices: {len(vertices)} > {PHYS_MAX_VERTICES}")
-        if len(faces) > PHYS_MAX_FACES:
-            raise ValueError(f"Too many faces: {len(faces)} > {PHYS_MAX_FACES}")
-
-        self.vertex_count = len(vertices)
-        for i, (x, y, z) in enumerate(vertices):
-            self.local_verts[i] = Vec3(x, y, z)
-
-        self.face_count = len(faces)
-        for i, (i0, i1, i2) in enumerate(faces):
-            self.face_indices[i][0] = i0
-            self.face_indices[i][1] = i1
-            self.face_indices[i][2] = i2
+        self.mesh_id = register_mesh(vertices, faces)
 
     def __repr__(self) -> str:
         return (
@@ -146,7 +133,64 @@ class PhysicsObject(ctypes.Structure):
 
 _lib = _load_lib()
 
-_lib.sim_run.restype  = None
+_lib.mesh_register.restype  = ctypes.c_int
+_lib.mesh_register.argtypes = [
+    ctypes.POINTER(Vec3),                # verts
+    ctypes.c_int,                        # vertex_count
+    ctypes.POINTER(ctypes.c_int * 3),    # faces
+    ctypes.c_int,                        # face_count
+]
+_lib.mesh_registry_clear.restype  = None
+_lib.mesh_registry_clear.argtypes = []
+
+# Geometry already registered in this process, keyed by its contents, so
+# objects sharing a hull also share its id.
+_mesh_ids: dict = {}
+
+
+def register_mesh(
+    vertices: list[tuple[float, float, float]],
+    faces:    list[tuple[int, int, int]],
+) -> int:
+    """
+    Store a convex mesh once in the library's mesh registry and return its id.
+
+    Identical geometry registered again returns the existing id. Assign the id
+    to PhysicsObject.mesh_id (or use PhysicsObject.set_mesh) to give a body
+    collision geometry.
+
+    Args:
+        vertices: List of (x, y, z) tuples — local-space vertex positions.
+        faces:    List of (i0, i1, i2) index triples, CCW winding outward.
+
+    Meshes of any size are accepted; each is stored in the library's shared
+    vertex and face pools.
+
+    Raises:
+        ValueError: if the mesh is empty or a face index is out of range.
+    """
+    key = (tuple(tuple(v) for v in vertices), tuple(tuple(f) for f in faces))
+    if key in _mesh_ids:
+        return _mesh_ids[key]
+
+    verts = (Vec3 * max(len(vertices), 1))(*(Vec3(x, y, z) for x, y, z in vertices))
+    tris  = ((ctypes.c_int * 3) * max(len(faces), 1))(
+        *((ctypes.c_int * 3)(i0, i1, i2) for i0, i1, i2 in faces)
+    )
+    mesh_id = _lib.mesh_register(verts, len(vertices), tris, len(faces))
+    if mesh_id < 0:
+        raise ValueError("Invalid mesh: empty, or a face index is out of range")
+
+    _mesh_ids[key] = mesh_id
+    return mesh_id
+
+
+def clear_meshes() -> None:
+    """Forget every registered mesh. Objects must not keep old ids afterwards."""
+    _lib.mesh_registry_clear()
+    _mesh_ids.clear()
+
+_lib.sim_run.restype  = ctypes.c_int
 _lib.sim_run.argtypes = [
     ctypes.POINTER(PhysicsObject),  # objects
     ctypes.c_int,                   # count
@@ -170,14 +214,92 @@ def sim_run(
         objects:    List of PhysicsObject instances.
         time_step:  Duration of each tick in seconds.
         num_steps:  Number of ticks to simulate.
+
+    Raises:
+        MemoryError: if the library could not allocate its buffers.
     """
     n = len(objects)
     arr = (PhysicsObject * n)(*objects)
-    _lib.sim_run(arr, ctypes.c_int(n), ctypes.c_double(time_step), ctypes.c_int(num_steps))
+    rc = _lib.sim_run(arr, ctypes.c_int(n), ctypes.c_double(time_step),
+                      ctypes.c_int(num_steps))
+    if rc != 0:
+        raise MemoryError("Simulation buffers could not be allocated")
     for i in range(n):
         objects[i] = arr[i]
 
 
+_lib.sim_context_create.restype  = ctypes.c_void_p
+_lib.sim_context_create.argtypes = [ctypes.c_void_p]  # config (NULL = defaults)
+_lib.sim_context_destroy.restype  = None
+_lib.sim_context_destroy.argtypes = [ctypes.c_void_p]
+_lib.sim_context_invalidate.restype  = None
+_lib.sim_context_invalidate.argtypes = [ctypes.c_void_p]
+_lib.sim_step.restype  = ctypes.c_int
+_lib.sim_step.argtypes = [
+    ctypes.c_void_p,                # ctx
+    ctypes.POINTER(PhysicsObject),  # objects
+    ctypes.c_int,                   # count
+    ctypes.c_double,                # time_step
+    ctypes.c_int,                   # num_steps
+]
+
+
+class Simulation:
+    """
+    A scene stepped incrementally, e.g. one tick per animation frame.
+
+    Owns a native SimContext and a single copy of the objects, so each step()
+    is one library call with no per-call setup. Read results from
+    ``objects``, whose entries view the simulated state directly.
+
+    Usable as a context manager; otherwise call close() when done.
+    """
+
+    def __init__(self, objects: list[PhysicsObject]):
+        """
+        Args:
+            objects: Initial bodies. Copied; the list itself is not modified.
+
+        Raises:
+            MemoryError: if the native context could not be created.
+        """
+        self.objects = (PhysicsObject * len(objects))(*objects)
+        self._ctx = _lib.sim_context_create(None)
+        if not self._ctx:
+            raise MemoryError("Could not create simulation context")
+
+    def step(self, time_step: float, num_steps: int = 1) -> None:
+        """
+        Advance the scene by num_steps ticks of size time_step (seconds).
+
+        Raises:
+            MemoryError: if the library could not grow its buffers.
+        """
+        rc = _lib.sim_step(self._ctx, self.objects, len(self.objects),
+                           ctypes.c_double(time_step), ctypes.c_int(num_steps))
+        if rc != 0:
+            raise MemoryError("Simulation buffers could not be allocated")
+
+    def invalidate(self) -> None:
+        """Call after editing ``objects`` between steps."""
+        _lib.sim_context_invalidate(self._ctx)
+
+    def close(self) -> None:
+        """Release the native context. Safe to call more than once."""
+        if self._ctx:
+            _lib.sim_context_destroy(self._ctx)
+            self._ctx = None
+
+    def __enter__(self) -> "Simulation":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+    def __del__(self) -> None:
+        self.close()
+
+
 if __name__ == "__main__":
     sun   = PhysicsObject(mass=1.989e30, x=0, y=0, z=0)
     earth = PhysicsObject(mass=5.972e24, x=1.496e11, y=0, z=0,
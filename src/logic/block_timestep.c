@@ -0,0 +1,194 @@
+/**
+ * @file block_timestep.c
+ * @brief Hierarchical block timestep integrator.
+ *
+ * @author Steven Kight
+ */
+
+#include "block_timestep.h"
+#include "hermite.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void block_state_init(BlockState *state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void block_state_free(BlockState *state) {
+    free(state->t_last);
+    free(state->level);
+    free(state->active);
+    free(state->mass);
+    free(state->soft);
+    free(state->acc);
+    free(state->jerk);
+    free(state->pos);
+    free(state->vel);
+    free(state->acc_new);
+    free(state->jerk_new);
+    block_state_init(state);
+}
+
+/* Grow every per-body buffer to hold at least @p count entries. */
+static int block_state_reserve(BlockState *state, int count) {
+    if (count <= state->capacity) return 0;
+
+    block_state_free(state);
+
+    const size_t n = (size_t)count;
+    state->t_last   = malloc(n * sizeof(long long));
+    state->level    = malloc(n * sizeof(int));
+    state->active   = malloc(n * sizeof(int));
+    state->mass     = malloc(n * sizeof(double));
+    state->soft     = malloc(n * sizeof(double));
+    state->acc      = malloc(n * sizeof(Vec3));
+    state->jerk     = malloc(n * sizeof(Vec3));
+    state->pos      = malloc(n * sizeof(Vec3));
+    state->vel      = malloc(n * sizeof(Vec3));
+    state->acc_new  = malloc(n * sizeof(Vec3));
+    state->jerk_new = malloc(n * sizeof(Vec3));
+
+    if (!state->t_last || !state->level || !state->active || !state->mass ||
+        !state->soft || !state->acc || !state->jerk || !state->pos ||
+        !state->vel || !state->acc_new || !state->jerk_new) {
+        block_state_free(state);
+        return -1;
+    }
+
+    state->capacity = count;
+    return 0;
+}
+
+/*
+ * Level wanted by Aarseth's criterion Δt = η |a| / |ȧ|: the smallest k with
+ * time_step / 2^k ≤ Δt. Bodies with no jerk (isolated or in uniform motion)
+ * take the whole tick.
+ */
+static int block_level_for(Vec3 a, Vec3 j, double time_step, double eta,
+                           int max_level) {
+    const double jj = vec3_magnitude(j);
+    if (jj <= 0.0) return 0;
+
+    const double dt = eta * vec3_magnitude(a) / jj;
+    if (dt >= time_step) return 0;
+    if (!(dt > 0.0)) return max_level;
+
+    const int k = (int)ceil(log2(time_step / dt));
+    return k < max_level ? k : max_level;
+}
+
+int block_tick(BlockState *state, PhysicsObject *objects, int count,
+               double time_step, int max_level, double eta, int resync,
+               const GravityConfig *gravity, SimStats *stats) {
+    if (count <= 0) return 0;
+    if (block_state_reserve(state, count) != 0) return -1;
+
+    if (max_level < 0) max_level = 0;
+    if (max_level > BLOCK_MAX_LEVEL) max_level = BLOCK_MAX_LEVEL;
+
+    const GravitySoftening kind = gravity ? gravity->softening : GRAVITY_SOFTENING_NONE;
+    const double length         = gravity ? gravity->softening_length : 0.0;
+
+    // Integer time: one unit is the finest step, one tick is 2^max_level units.
+    const long long tick_units = 1LL << max_level;
+    const double    unit       = time_step / (double)tick_units;
+
+    for (int i = 0; i < count; i++) {
+        state->t_last[i] = 0;
+        state->mass[i]   = objects[i].mass;
+        state->soft[i]   = objects[i].softening;
+        state->pos[i]    = objects[i].position;
+        state->vel[i]    = objects[i].velocity;
+    }
+
+    if (resync || !state->synced) {
+        gravity_acc_jerk(state->pos, state->vel, state->mass, state->soft,
+                         count, NULL, count, kind, length,
+                         state->acc, state->jerk);
+        for (int i = 0; i < count; i++) {
+            state->level[i] = block_level_for(state->acc[i], state->jerk[i],
+                                              time_step, eta, max_level);
+        }
+        state->synced = 1;
+        if (stats) stats->force_evaluations += count;
+    } else {
+        // Levels carried over from a tick with a finer max_level.
+        for (int i = 0; i < count; i++) {
+            if (state->level[i] > max_level) state->level[i] = max_level;
+        }
+    }
+
+    for (;;) {
+        // Next substep: the earliest time any body is due.
+        long long t_next = tick_units + 1;
+        for (int i = 0; i < count; i++) {
+            const long long due = state->t_last[i] + (tick_units >> state->level[i]);
+            if (due < t_next) t_next = due;
+        }
+        if (t_next > tick_units) break;
+
+        int n_active  = 0;
+        int finest    = 0;
+        for (int i = 0; i < count; i++) {
+            if (state->t_last[i] + (tick_units >> state->level[i]) == t_next) {
+                state->active[n_active++] = i;
+                if (state->level[i] > finest) finest = state->level[i];
+            }
+        }
+
+        // Predict every body to t_next from its own last step.
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++) {
+            const double dt = (double)(t_next - state->t_last[i]) * unit;
+            hermite_predict(objects[i].position, objects[i].velocity,
+                            state->acc[i], state->jerk[i], dt,
+                            &state->pos[i], &state->vel[i]);
+        }
+
+        gravity_acc_jerk(state->pos, state->vel, state->mass, state->soft,
+                         count, state->active, n_active, kind, length,
+                         state->acc_new, state->jerk_new);
+
+        // Correct the active bodies and choose their next level.
+        #pragma omp parallel for schedule(static)
+        for (int k = 0; k < n_active; k++) {
+            const int i = state->active[k];
+            const double dt = (double)(tick_units >> state->level[i]) * unit;
+            const Vec3 a1 = state->acc_new[i];
+
+            hermite_correct(objects[i].position, objects[i].velocity,
+                            state->acc[i], state->jerk[i],
+                            a1, state->jerk_new[i], dt,
+                            &objects[i].position, &objects[i].velocity);
+
+            state->acc[i]    = a1;
+            state->jerk[i]   = state->jerk_new[i];
+            state->t_last[i] = t_next;
+
+            const int want = block_level_for(a1, state->jerk[i], time_step, eta, max_level);
+            const int cur  = state->level[i];
+            if (want > cur) {
+                state->level[i] = want;
+            } else if (want < cur && t_next % (tick_units >> (cur - 1)) == 0) {
+                state->level[i] = cur - 1;
+            }
+        }
+
+        if (stats) {
+            const double dt_min = (double)(tick_units >> finest) * unit;
+            stats->steps++;
+            stats->force_evaluations += n_active;
+            if (stats->min_time_step <= 0.0 || dt_min < stats->min_time_step) {
+                stats->min_time_step = dt_min;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        objects[i].acceleration = state->acc[i];
+        objects[i].force        = (Vec3){0.0, 0.0, 0.0};
+    }
+    return 0;
+}
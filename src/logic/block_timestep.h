@@ -0,0 +1,104 @@
+/**
+ * @file block_timestep.h
+ * @brief Hierarchical (block) individual timesteps for the simulation loop.
+ *
+ * Each body advances on its own power-of-two fraction of the tick,
+ *
+ *   Δt_i = time_step / 2^k_i,   0 ≤ k_i ≤ max_level
+ *
+ * so bodies in a tight orbit take many small steps while distant field bodies
+ * take one, and only the bodies due at a given substep ("active" bodies) have
+ * their force evaluated. Time is counted in integer units of the finest step
+ * time_step / 2^max_level, so every body is exactly synchronised at each tick
+ * boundary and collisions can be resolved there as in the shared-step loop.
+ *
+ * Each substep is a predict–evaluate–correct cycle:
+ *
+ *   1. Predict every body to the substep time with its last a and ȧ
+ *      (hermite_predict()).
+ *   2. Evaluate a and ȧ on the active bodies against all predicted bodies
+ *      (gravity_acc_jerk()).
+ *   3. Correct the active bodies with the fourth-order Hermite corrector
+ *      (hermite_correct()).
+ *   4. Pick the next level from Aarseth's criterion Δt = η |a| / |ȧ|. A body
+ *      may move to a finer level at any time but to a coarser one only one
+ *      level at a time, and only when the current time is a multiple of the
+ *      coarser step, so the block hierarchy stays aligned.
+ *
+ * Forces are summed directly with the softening from the scene's
+ * GravityConfig; the approximate solvers do not evaluate jerk and are not used
+ * by this integrator.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef BLOCK_TIMESTEP_H
+#define BLOCK_TIMESTEP_H
+
+#include "sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLOCK_MAX_LEVEL 30  /* integer time units must fit 2^level in int64 with headroom */
+
+/**
+ * @brief Per-body block-step state carried across ticks.
+ *
+ * All arrays hold @c capacity entries and are indexed like the PhysicsObject
+ * array. Zero-initialise (or call block_state_init()) before first use; the
+ * buffers are reused across ticks and only grow.
+ */
+typedef struct {
+    int        capacity;
+    int        synced;    /**< 1 once acc/jerk hold valid values for the objects. */
+    long long *t_last;    /**< Time of each body's last step, in finest units. */
+    int       *level;     /**< Current level k_i of each body. */
+    int       *active;    /**< Indices of the bodies due at the current substep. */
+    double    *mass;
+    double    *soft;      /**< Per-body softening lengths (PhysicsObject::softening). */
+    Vec3      *acc;       /**< a at t_last (m/s²). */
+    Vec3      *jerk;      /**< ȧ at t_last (m/s³). */
+    Vec3      *pos;       /**< Predicted positions at the current substep. */
+    Vec3      *vel;       /**< Predicted velocities at the current substep. */
+    Vec3      *acc_new;   /**< Freshly evaluated a for active bodies. */
+    Vec3      *jerk_new;  /**< Freshly evaluated ȧ for active bodies. */
+} BlockState;
+
+/** Zero-initialise @p state. */
+void block_state_init(BlockState *state);
+
+/** Release the buffers owned by @p state and reset it. */
+void block_state_free(BlockState *state);
+
+/**
+ * @brief Advance every object by one tick of @p time_step with block steps.
+ *
+ * When @p resync is set (or on first use) a and ȧ are re-evaluated for every
+ * body and all levels are chosen afresh — required after anything outside
+ * this integrator, such as a collision response, has changed velocities. On
+ * return every object sits at the end of the tick with its acceleration field
+ * updated and its force reset to zero, matching object_step().
+ *
+ * @param state      Persistent block-step state.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param time_step  Tick length (s); the largest block step.
+ * @param max_level  Finest level, clamped to [0, BLOCK_MAX_LEVEL].
+ * @param eta        Accuracy parameter η of the step criterion.
+ * @param resync     Non-zero to re-evaluate all forces before stepping.
+ * @param gravity    Softening source; the solver selection is ignored.
+ * @param stats      Counters to accumulate into, or NULL.
+ * @return           0 on success, -1 if the state buffers could not be allocated
+ *                   (objects are left unchanged).
+ */
+int block_tick(BlockState *state, PhysicsObject *objects, int count,
+               double time_step, int max_level, double eta, int resync,
+               const GravityConfig *gravity, SimStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOCK_TIMESTEP_H */
@@ -7,17 +7,17 @@
 
 #include "aabb.h"
 
-AABB aabb_from_object(const PhysicsObject *obj) {
-    if (obj->vertex_count == 0) {
+AABB aabb_from_body(const CollisionBody *body) {
+    if (body->vertex_count == 0) {
         /* No mesh — treat object as a point at its position. */
-        return (AABB){ .min = obj->position, .max = obj->position };
+        return (AABB){ .min = body->position, .max = body->position };
     }
 
-    Vec3 world = vec3_add(obj->local_verts[0], obj->position);
+    Vec3 world = vec3_add(body->verts[0], body->position);
     AABB box = { .min = world, .max = world };
 
-    for (int i = 1; i < obj->vertex_count; i++) {
-        world = vec3_add(obj->local_verts[i], obj->position);
+    for (int i = 1; i < body->vertex_count; i++) {
+        world = vec3_add(body->verts[i], body->position);
 
         if (world.x < box.min.x) box.min.x = world.x;
         if (world.y < box.min.y) box.min.y = world.y;
@@ -31,6 +31,11 @@ AABB aabb_from_object(const PhysicsObject *obj) {
     return box;
 }
 
+AABB aabb_from_object(const PhysicsObject *obj) {
+    CollisionBody body = collision_body_from_object(obj);
+    return aabb_from_body(&body);
+}
+
 int aabb_overlaps(AABB a, AABB b) {
     return a.max.x >= b.min.x && b.max.x >= a.min.x &&
            a.max.y >= b.min.y && b.max.y >= a.min.y &&
@@ -12,6 +12,7 @@
 
 #include "../../math/vec3.h"
 #include "../../models/object.h"
+#include "collision.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,14 +27,24 @@ typedef struct {
 /**
  * @brief Compute the world-space AABB of a PhysicsObject's convex mesh.
  *
- * Translates each local_vert by obj->position and computes the component-wise
- * min and max. If vertex_count is 0, returns a zero-size AABB at position.
+ * Translates each vertex of the registered mesh obj->mesh_id by obj->position
+ * and computes the component-wise min and max. If the object has no mesh
+ * (MESH_NONE), returns a zero-size AABB at position.
  *
  * @param obj  The object whose mesh is used.
  * @return     World-space AABB enclosing all vertices.
  */
 AABB aabb_from_object(const PhysicsObject *obj);
 
+/**
+ * @brief aabb_from_object() for a geometry view.
+ *
+ * @param body  View produced by collision_body_from_object() or
+ *              collision_body_from_world().
+ * @return      The world-space AABB of the viewed mesh.
+ */
+AABB aabb_from_body(const CollisionBody *body);
+
 /**
  * @brief Return 1 if two AABBs overlap on all three axes, 0 otherwise.
  *
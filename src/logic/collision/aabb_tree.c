@@ -0,0 +1,560 @@
+/**
+ * @file aabb_tree.c
+ * @brief Dynamic AABB tree implementation.
+ *
+ * Insertion, removal and balancing follow the incremental scheme of
+ * Catto's Box2D b2DynamicTree, with surface area as the 3-D cost.
+ *
+ * @author Steven Kight
+ */
+
+#include "aabb_tree.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void aabb_tree_init(AabbTree *tree) {
+    memset(tree, 0, sizeof(*tree));
+    tree->free_list = AABB_TREE_NULL;
+    tree->root      = AABB_TREE_NULL;
+    tree->count     = -1;
+}
+
+void aabb_tree_free(AabbTree *tree) {
+    free(tree->nodes);
+    free(tree->boxes);
+    free(tree->leaf);
+    for (int t = 0; t < tree->task_capacity; t++)
+        collision_pairs_free(&tree->task_pairs[t]);
+    free(tree->task_pairs);
+    free(tree->tasks);
+    aabb_tree_init(tree);
+}
+
+int aabb_tree_height(const AabbTree *tree) {
+    return tree->root == AABB_TREE_NULL ? -1 : tree->nodes[tree->root].height;
+}
+
+/* ------------------------------------------------------------------ */
+/* Boxes                                                                  */
+/* ------------------------------------------------------------------ */
+
+static AABB box_union(AABB a, AABB b) {
+    return (AABB){
+        .min = { fmin(a.min.x, b.min.x), fmin(a.min.y, b.min.y), fmin(a.min.z, b.min.z) },
+        .max = { fmax(a.max.x, b.max.x), fmax(a.max.y, b.max.y), fmax(a.max.z, b.max.z) },
+    };
+}
+
+static double box_area(AABB a) {
+    const double x = a.max.x - a.min.x, y = a.max.y - a.min.y, z = a.max.z - a.min.z;
+    return 2.0 * (x * y + y * z + z * x);
+}
+
+static int box_contains(AABB outer, AABB inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+           outer.min.z <= inner.min.z && inner.max.x <= outer.max.x &&
+           inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+static double box_extent(AABB a) {
+    return fmax(a.max.x - a.min.x, fmax(a.max.y - a.min.y, a.max.z - a.min.z));
+}
+
+/* Grow @p box by its own relative margin, but never by less than @p floor. */
+static AABB box_fatten(AABB box, double floor) {
+    const double m = fmax(AABB_TREE_FAT_MARGIN * box_extent(box), floor);
+    return (AABB){
+        .min = { box.min.x - m, box.min.y - m, box.min.z - m },
+        .max = { box.max.x + m, box.max.y + m, box.max.z + m },
+    };
+}
+
+static int extent_cmp(const void *a, const void *b) {
+    const double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Absolute margin floor, so point bodies (no mesh, zero extent) and very
+ * small ones do not leave their fat box on every tick: AABB_TREE_FAT_MARGIN
+ * times the median extent of the bodies that have one, or, when none does,
+ * times the mean spacing of the scene. 0 if the scratch cannot be allocated.
+ */
+static double margin_floor(const AABB *boxes, int count) {
+    if (count <= 0) return 0.0;
+    double *extents = malloc((size_t)count * sizeof(*extents));
+    if (!extents) return 0.0;
+
+    int sized = 0;
+    AABB bounds = boxes[0];
+    for (int i = 0; i < count; i++) {
+        const double e = box_extent(boxes[i]);
+        if (e > 0.0) extents[sized++] = e;
+        bounds = box_union(bounds, boxes[i]);
+    }
+
+    double scale;
+    if (sized > 0) {
+        qsort(extents, (size_t)sized, sizeof(*extents), extent_cmp);
+        scale = extents[sized / 2];
+    } else {
+        scale = box_extent(bounds) / cbrt((double)count);
+    }
+    free(extents);
+    return AABB_TREE_FAT_MARGIN * scale;
+}
+
+/* ------------------------------------------------------------------ */
+/* Node pool                                                              */
+/* ------------------------------------------------------------------ */
+
+/* Take a node from the free list or the end of the array (grown as needed). */
+static int alloc_node(AabbTree *tree) {
+    if (tree->free_list == AABB_TREE_NULL) {
+        if (tree->node_count == tree->node_capacity) {
+            int capacity = tree->node_capacity > 0 ? 2 * tree->node_capacity
+                                                   : AABB_TREE_INITIAL_NODES;
+            AabbTreeNode *grown = realloc(tree->nodes, (size_t)capacity * sizeof(*grown));
+            if (!grown) return AABB_TREE_NULL;
+            tree->nodes = grown;
+            tree->node_capacity = capacity;
+        }
+        tree->nodes[tree->node_count].parent = tree->free_list;
+        tree->free_list = tree->node_count++;
+    }
+
+    const int n = tree->free_list;
+    tree->free_list = tree->nodes[n].parent;
+    tree->nodes[n] = (AabbTreeNode){
+        .parent = AABB_TREE_NULL, .child1 = AABB_TREE_NULL, .child2 = AABB_TREE_NULL,
+        .height = 0, .body = AABB_TREE_NULL,
+    };
+    return n;
+}
+
+static void free_node(AabbTree *tree, int n) {
+    tree->nodes[n].parent = tree->free_list;
+    tree->nodes[n].height = -1;
+    tree->free_list = n;
+}
+
+/* ------------------------------------------------------------------ */
+/* Structure                                                              */
+/* ------------------------------------------------------------------ */
+
+/* Make @p to take @p from's place under @p parent (or as the root). */
+static void replace_child(AabbTree *tree, int parent, int from, int to) {
+    if (parent == AABB_TREE_NULL) {
+        tree->root = to;
+    } else if (tree->nodes[parent].child1 == from) {
+        tree->nodes[parent].child1 = to;
+    } else {
+        tree->nodes[parent].child2 = to;
+    }
+}
+
+static void refit(AabbTree *tree, int n) {
+    AabbTreeNode *node = &tree->nodes[n];
+    const AabbTreeNode *c1 = &tree->nodes[node->child1], *c2 = &tree->nodes[node->child2];
+    node->box    = box_union(c1->box, c2->box);
+    node->height = 1 + (c1->height > c2->height ? c1->height : c2->height);
+}
+
+/*
+ * If @p a's subtrees differ in height by more than one, rotate the taller
+ * child up into @p a's place. Returns the node now at that place.
+ */
+static int balance(AabbTree *tree, int a) {
+    AabbTreeNode *nodes = tree->nodes;
+    if (nodes[a].child1 == AABB_TREE_NULL || nodes[a].height < 2) return a;
+
+    const int b = nodes[a].child1, c = nodes[a].child2;
+    const int skew = nodes[c].height - nodes[b].height;
+    if (skew >= -1 && skew <= 1) return a;
+
+    // Rotate the taller child t up; a keeps its shorter child s and takes
+    // the shorter of t's children, t keeps the taller one.
+    const int t = skew > 1 ? c : b;
+    const int t1 = nodes[t].child1, t2 = nodes[t].child2;
+    const int keep = nodes[t1].height > nodes[t2].height ? t1 : t2;
+    const int give = keep == t1 ? t2 : t1;
+
+    nodes[t].parent = nodes[a].parent;
+    replace_child(tree, nodes[a].parent, a, t);
+    nodes[a].parent = t;
+    nodes[t].child1 = a;
+    nodes[t].child2 = keep;
+
+    if (t == c) nodes[a].child2 = give;
+    else        nodes[a].child1 = give;
+    nodes[give].parent = a;
+
+    refit(tree, a);
+    refit(tree, t);
+    return t;
+}
+
+/* Refit and rebalance every node from @p n up to the root. */
+static void fix_upwards(AabbTree *tree, int n) {
+    while (n != AABB_TREE_NULL) {
+        n = balance(tree, n);
+        refit(tree, n);
+        n = tree->nodes[n].parent;
+    }
+}
+
+/*
+ * Insert @p leaf next to the sibling that least increases total surface
+ * area: descending, the cost of pairing with a node is the area of the
+ * union plus the growth it forces on every ancestor.
+ */
+static int insert_leaf(AabbTree *tree, int leaf) {
+    if (tree->root == AABB_TREE_NULL) {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = AABB_TREE_NULL;
+        return 0;
+    }
+
+    const AABB box = tree->nodes[leaf].box;
+    int n = tree->root;
+    while (tree->nodes[n].child1 != AABB_TREE_NULL) {
+        const AabbTreeNode *node = &tree->nodes[n];
+        const double area     = box_area(node->box);
+        const double combined = box_area(box_union(node->box, box));
+        const double here     = 2.0 * combined;              // new parent of n
+        const double inherit  = 2.0 * (combined - area);     // growth of n's ancestors
+
+        double cost[2];
+        const int child[2] = { node->child1, node->child2 };
+        for (int k = 0; k < 2; k++) {
+            const AabbTreeNode *ch = &tree->nodes[child[k]];
+            const double grown = box_area(box_union(ch->box, box));
+            cost[k] = inherit + (ch->child1 == AABB_TREE_NULL ? grown : grown - box_area(ch->box));
+        }
+        if (here < cost[0] && here < cost[1]) break;
+        n = cost[0] < cost[1] ? child[0] : child[1];
+    }
+
+    const int sibling = n;
+    const int old_parent = tree->nodes[sibling].parent;
+    const int parent = alloc_node(tree);  // may move tree->nodes
+    if (parent == AABB_TREE_NULL) return -1;
+
+    AabbTreeNode *nodes = tree->nodes;
+    nodes[parent].parent = old_parent;
+    nodes[parent].child1 = sibling;
+    nodes[parent].child2 = leaf;
+    replace_child(tree, old_parent, sibling, parent);
+    nodes[sibling].parent = parent;
+    nodes[leaf].parent    = parent;
+
+    fix_upwards(tree, parent);
+    return 0;
+}
+
+/* Detach @p leaf, splicing its sibling into the parent's place. */
+static void remove_leaf(AabbTree *tree, int leaf) {
+    if (leaf == tree->root) {
+        tree->root = AABB_TREE_NULL;
+        return;
+    }
+
+    AabbTreeNode *nodes = tree->nodes;
+    const int parent = nodes[leaf].parent;
+    const int grandparent = nodes[parent].parent;
+    const int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2
+                                                     : nodes[parent].child1;
+
+    replace_child(tree, grandparent, parent, sibling);
+    nodes[sibling].parent = grandparent;
+    free_node(tree, parent);
+    fix_upwards(tree, grandparent);
+}
+
+/* ------------------------------------------------------------------ */
+/* Update                                                                 */
+/* ------------------------------------------------------------------ */
+
+static int reserve_bodies(AabbTree *tree, int count) {
+    if (count <= tree->body_capacity) return 0;
+
+    const size_t n = (size_t)count;
+    AABB *boxes = malloc(n * sizeof(*boxes));
+    int  *leaf  = malloc(n * sizeof(*leaf));
+    if (!boxes || !leaf) {
+        free(boxes); free(leaf);
+        return -1;
+    }
+    free(tree->boxes); free(tree->leaf);
+    tree->boxes = boxes;
+    tree->leaf  = leaf;
+    tree->body_capacity = count;
+    return 0;
+}
+
+/* Give body @p i a fresh leaf with its fat box and insert it. */
+static int insert_body(AabbTree *tree, int i) {
+    const int leaf = alloc_node(tree);
+    if (leaf == AABB_TREE_NULL) return -1;
+    tree->nodes[leaf].box  = box_fatten(tree->boxes[i], tree->min_margin);
+    tree->nodes[leaf].body = i;
+    tree->leaf[i] = leaf;
+    return insert_leaf(tree, leaf);
+}
+
+/*
+ * Renumber the live nodes in depth-first order, so each subtree occupies a
+ * contiguous run of the array and a traversal streams through memory
+ * instead of hopping between nodes placed in insertion order. Leaves the
+ * layout unchanged if the scratch cannot be allocated.
+ */
+static void relayout(AabbTree *tree) {
+    if (tree->root == AABB_TREE_NULL) return;
+
+    AabbTreeNode *packed = malloc((size_t)tree->node_capacity * sizeof(*packed));
+    int *stack = malloc(2 * (size_t)tree->node_count * sizeof(*stack));
+    if (!packed || !stack) {
+        free(packed); free(stack);
+        return;
+    }
+
+    // Stack entries are (old index, slot): slot is 2 * new parent index, plus
+    // 1 for a second child, or -1 for the root.
+    int placed = 0, top = 0;
+    stack[top++] = tree->root;
+    stack[top++] = -1;
+    while (top > 0) {
+        const int slot = stack[--top];
+        const int old  = stack[--top];
+        const int n    = placed++;
+
+        packed[n] = tree->nodes[old];
+        packed[n].parent = slot < 0 ? AABB_TREE_NULL : slot / 2;
+        if (slot >= 0) {
+            if (slot % 2) packed[slot / 2].child2 = n;
+            else          packed[slot / 2].child1 = n;
+        }
+        if (packed[n].child1 == AABB_TREE_NULL) {
+            tree->leaf[packed[n].body] = n;
+        } else {
+            // Pushed last, child1 is placed next.
+            stack[top++] = packed[n].child2;
+            stack[top++] = 2 * n + 1;
+            stack[top++] = packed[n].child1;
+            stack[top++] = 2 * n;
+        }
+    }
+    free(stack);
+
+    free(tree->nodes);
+    tree->nodes      = packed;
+    tree->node_count = placed;
+    tree->free_list  = AABB_TREE_NULL;
+    tree->root       = 0;
+    tree->since_layout = 0;
+}
+
+/* Empty the tree, keeping its buffers. */
+static void reset(AabbTree *tree) {
+    tree->node_count = 0;
+    tree->free_list  = AABB_TREE_NULL;
+    tree->root       = AABB_TREE_NULL;
+    tree->count      = -1;
+}
+
+int aabb_tree_update(AabbTree *tree, const CollisionBody *bodies, int count) {
+    if (count < 0) count = 0;
+    tree->reinserted = 0;
+    if (reserve_bodies(tree, count) != 0) {
+        aabb_tree_free(tree);
+        return -1;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++)
+        tree->boxes[i] = aabb_from_body(&bodies[i]);
+
+    if (count != tree->count) {
+        reset(tree);
+        tree->min_margin = margin_floor(tree->boxes, count);
+        for (int i = 0; i < count; i++) {
+            if (insert_body(tree, i) != 0) {
+                reset(tree);
+                return -1;
+            }
+        }
+        relayout(tree);
+        tree->count = count;
+        return 0;
+    }
+
+    // Steady state: only bodies that escaped their fat box move in the tree.
+    for (int i = 0; i < count; i++) {
+        const int leaf = tree->leaf[i];
+        if (box_contains(tree->nodes[leaf].box, tree->boxes[i])) continue;
+
+        remove_leaf(tree, leaf);
+        tree->nodes[leaf].box = box_fatten(tree->boxes[i], tree->min_margin);
+        if (insert_leaf(tree, leaf) != 0) {
+            reset(tree);
+            return -1;
+        }
+        tree->reinserted++;
+    }
+
+    tree->since_layout += tree->reinserted;
+    if (tree->since_layout > count / 4)
+        relayout(tree);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Query                                                                  */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Append the pair of leaves @p a and @p b if their bodies' tight boxes
+ * overlap. Returns -1 if @p sink cannot grow to hold it.
+ */
+static int leaf_pair(const AabbTree *tree, int a, int b, CollisionPairBuffer *sink) {
+    const int i = tree->nodes[a].body, j = tree->nodes[b].body;
+    if (!aabb_overlaps(tree->boxes[i], tree->boxes[j])) return 0;
+    if (sink->count == sink->capacity &&
+            collision_pairs_reserve(sink, sink->capacity > 0 ? 2 * sink->capacity : 64) != 0)
+        return -1;
+    sink->pairs[sink->count++] = (CollisionPair){ .index_a = i < j ? i : j,
+                                                  .index_b = i < j ? j : i };
+    return 0;
+}
+
+/*
+ * Pairs with one body under @p a and one under @p b (disjoint subtrees):
+ * descend the taller side while the boxes overlap. Returns -1 on
+ * allocation failure.
+ */
+static int cross_pairs(const AabbTree *tree, int a, int b, CollisionPairBuffer *sink) {
+    const AabbTreeNode *na = &tree->nodes[a], *nb = &tree->nodes[b];
+    if (!aabb_overlaps(na->box, nb->box)) return 0;
+
+    if (na->child1 == AABB_TREE_NULL && nb->child1 == AABB_TREE_NULL)
+        return leaf_pair(tree, a, b, sink);
+    if (nb->child1 == AABB_TREE_NULL ||
+            (na->child1 != AABB_TREE_NULL && na->height >= nb->height))
+        return cross_pairs(tree, na->child1, b, sink) != 0 ||
+               cross_pairs(tree, na->child2, b, sink) != 0 ? -1 : 0;
+    return cross_pairs(tree, a, nb->child1, sink) != 0 ||
+           cross_pairs(tree, a, nb->child2, sink) != 0 ? -1 : 0;
+}
+
+/* Pairs of bodies both under @p a: within each child, then across them. */
+static int self_pairs(const AabbTree *tree, int a, CollisionPairBuffer *sink) {
+    const AabbTreeNode *node = &tree->nodes[a];
+    if (node->child1 == AABB_TREE_NULL) return 0;
+
+    return self_pairs(tree, node->child1, sink) != 0 ||
+           self_pairs(tree, node->child2, sink) != 0 ||
+           cross_pairs(tree, node->child1, node->child2, sink) != 0 ? -1 : 0;
+}
+
+/*
+ * Split the traversal from the root into independent tasks, one level at
+ * a time, until there are about AABB_TREE_TASKS of them. Returns the task
+ * count, or -1 on allocation failure.
+ */
+static int split_tasks(AabbTree *tree) {
+    // Each round at most triples the list; size for the round that passes
+    // AABB_TREE_TASKS.
+    const int capacity = 3 * AABB_TREE_TASKS;
+    if (tree->task_capacity < capacity) {
+        AabbTreeTask *tasks = malloc(2 * (size_t)capacity * sizeof(*tasks));
+        CollisionPairBuffer *sinks = malloc((size_t)capacity * sizeof(*sinks));
+        if (!tasks || !sinks) {
+            free(tasks); free(sinks);
+            return -1;
+        }
+        for (int t = 0; t < capacity; t++)
+            collision_pairs_init(&sinks[t]);
+        free(tree->tasks);
+        tree->tasks = tasks;
+        tree->task_pairs = sinks;
+        tree->task_capacity = capacity;
+    }
+
+    AabbTreeTask *cur = tree->tasks, *next = tree->tasks + capacity;
+    int count = 0;
+    cur[count++] = (AabbTreeTask){ tree->root, tree->root, 0 };
+
+    const AabbTreeNode *nodes = tree->nodes;
+    for (int split = 1; split && count < AABB_TREE_TASKS;) {
+        int n = 0;
+        split = 0;
+        for (int t = 0; t < count; t++) {
+            const int a = cur[t].a, b = cur[t].b;
+            const AabbTreeNode *na = &nodes[a], *nb = &nodes[b];
+            if (a == b && na->child1 != AABB_TREE_NULL) {
+                next[n++] = (AabbTreeTask){ na->child1, na->child1, 0 };
+                next[n++] = (AabbTreeTask){ na->child2, na->child2, 0 };
+                next[n++] = (AabbTreeTask){ na->child1, na->child2, 0 };
+                split = 1;
+            } else if (a != b && !aabb_overlaps(na->box, nb->box)) {
+                split = 1;  // nothing to find
+            } else if (a != b && na->child1 != AABB_TREE_NULL && na->height >= nb->height) {
+                next[n++] = (AabbTreeTask){ na->child1, b, 0 };
+                next[n++] = (AabbTreeTask){ na->child2, b, 0 };
+                split = 1;
+            } else if (a != b && nb->child1 != AABB_TREE_NULL) {
+                next[n++] = (AabbTreeTask){ a, nb->child1, 0 };
+                next[n++] = (AabbTreeTask){ a, nb->child2, 0 };
+                split = 1;
+            } else {
+                next[n++] = cur[t];
+            }
+        }
+        AabbTreeTask *swap = cur; cur = next; next = swap;
+        count = n;
+    }
+
+    if (cur != tree->tasks)
+        memcpy(tree->tasks, cur, (size_t)count * sizeof(*cur));
+    return count;
+}
+
+int aabb_tree_query_pairs(AabbTree *tree, CollisionPairBuffer *out) {
+    out->count = 0;
+    if (tree->root == AABB_TREE_NULL) return 0;
+
+    const int tasks = split_tasks(tree);
+    if (tasks < 0) return -1;
+    AabbTreeTask *task = tree->tasks;
+    CollisionPairBuffer *sink = tree->task_pairs;
+    int failed = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(|:failed)
+    for (int t = 0; t < tasks; t++) {
+        sink[t].count = 0;
+        failed |= task[t].a == task[t].b
+                ? self_pairs(tree, task[t].a, &sink[t]) != 0
+                : cross_pairs(tree, task[t].a, task[t].b, &sink[t]) != 0;
+    }
+    if (failed) return -1;
+
+    // Concatenate in task order, so the output does not depend on scheduling.
+    long long total = 0;
+    for (int t = 0; t < tasks; t++) {
+        task[t].first = (int)total;
+        total += sink[t].count;
+    }
+    if (total > INT_MAX || collision_pairs_reserve(out, (int)total) != 0)
+        return -1;
+
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < tasks; t++)
+        memcpy(&out->pairs[task[t].first], sink[t].pairs,
+               (size_t)sink[t].count * sizeof(CollisionPair));
+
+    out->count = (int)total;
+    return out->count;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file aabb_tree.h
+ * @brief Dynamic AABB tree (bounding volume hierarchy) broad phase.
+ *
+ * Each body is a leaf holding a fat AABB: its tight box grown by
+ * AABB_TREE_FAT_MARGIN times its largest extent on every side, or by the
+ * same fraction of the median body extent if that is larger, so point
+ * bodies without a mesh still get a margin. Internal nodes hold the union
+ * of their two children. The tree is kept between
+ * updates: a body that moves but stays inside its fat box costs nothing,
+ * and one that leaves it is removed and reinserted, refitting only the
+ * boxes on its path to the root. Insertion picks the sibling that least
+ * grows the total surface area, and rotations on the way up keep the tree
+ * height-balanced, so queries stay O(log N) per body however bodies move.
+ *
+ * Like the octree pool, nodes live in one array addressed by integer index,
+ * which grows by doubling and recycles freed nodes through a free list. The
+ * array is renumbered in depth-first order after a rebuild, and again once
+ * reinsertions have scattered a quarter of the leaves, so traversals read
+ * nearby memory.
+ *
+ * The self-collision query descends the tree against itself, visiting only
+ * pairs of subtrees whose boxes overlap, so each pair of leaves is reached
+ * once, at their lowest common ancestor. It reports exactly the pairs whose
+ * tight AABBs overlap (touching counts).
+ *
+ * @author Steven Kight
+ */
+
+#ifndef AABB_TREE_H
+#define AABB_TREE_H
+
+#include "aabb.h"
+#include "collision.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AABB_TREE_NULL -1          /* sentinel: no node */
+#define AABB_TREE_FAT_MARGIN 0.25  /* fat-box margin / largest body extent */
+#define AABB_TREE_INITIAL_NODES 1024
+#define AABB_TREE_TASKS 256        /* subtree pairs the query aims to split into */
+
+/**
+ * @brief One node of the tree.
+ *
+ * A leaf has child1 == AABB_TREE_NULL and refers to @c body; an internal
+ * node has two children and body == AABB_TREE_NULL. Free nodes chain
+ * through @c parent.
+ */
+typedef struct {
+    AABB box;     /**< Fat box (leaf) or union of the children. */
+    int  parent;
+    int  child1;
+    int  child2;
+    int  height;  /**< 0 for a leaf, -1 for a free node. */
+    int  body;
+} AabbTreeNode;
+
+/** A pair of subtrees to search (a == b: pairs within one subtree). */
+typedef struct {
+    int a;
+    int b;
+    int first;  /**< Offset of the task's pairs in the query output. */
+} AabbTreeTask;
+
+/**
+ * @brief Tree, per-body boxes and scratch, kept between updates.
+ *
+ * Initialise with aabb_tree_init() and release with aabb_tree_free().
+ */
+typedef struct AabbTree {
+    AabbTreeNode *nodes;
+    int   node_capacity;
+    int   node_count;     /**< Nodes ever handed out (free ones included). */
+    int   free_list;      /**< First free node, or AABB_TREE_NULL. */
+    int   root;
+
+    int   count;          /**< Bodies in the tree (-1 = none yet). */
+    int   body_capacity;
+    AABB *boxes;          /**< Tight AABB of each body. */
+    int  *leaf;           /**< Leaf node of each body. */
+
+    AabbTreeTask *tasks;  /**< Scratch: query tasks (two lists of task_capacity). */
+    CollisionPairBuffer *task_pairs; /**< Scratch: each task's pairs, kept between queries. */
+    int   task_capacity;
+
+    double min_margin;    /**< Smallest fat-box margin, set on each rebuild. */
+    int   reinserted;     /**< Bodies reinserted by the last update. */
+    int   since_layout;   /**< Reinsertions since the nodes were last laid out. */
+} AabbTree;
+
+/** @brief Initialise an empty tree (no allocation until first update). */
+void aabb_tree_init(AabbTree *tree);
+
+/** @brief Release all buffers and reset @p tree to the empty state. */
+void aabb_tree_free(AabbTree *tree);
+
+/**
+ * @brief Bring the tree up to date with @p bodies.
+ *
+ * If @p count matches the previous update, body i is assumed to be the same
+ * body as before: its tight box is refreshed, and it is reinserted only if
+ * that box has left its fat box. Otherwise the tree is rebuilt by inserting
+ * every body.
+ *
+ * @param tree    Tree.
+ * @param bodies  Geometry views, one per body.
+ * @param count   Number of bodies.
+ * @return        0 on success, -1 on allocation failure (the tree is empty).
+ */
+int aabb_tree_update(AabbTree *tree, const CollisionBody *bodies, int count);
+
+/** @brief Height of the tree (0 for a single leaf, -1 when empty). */
+int aabb_tree_height(const AabbTree *tree);
+
+/**
+ * @brief Collect every pair of bodies whose tight AABBs overlap.
+ *
+ * The top of the self-traversal is split into independent subtree pairs,
+ * searched in parallel into buffers of their own and concatenated in task
+ * order, so the result is deterministic.
+ *
+ * @param tree  Tree from aabb_tree_update(); its scratch is reused.
+ * @param out   Receives the pairs (index_a < index_b); grown as needed.
+ * @return      out->count, the number of candidate pairs, or -1 if
+ *              @p out (or the scratch) cannot grow to hold them all.
+ */
+int aabb_tree_query_pairs(AabbTree *tree, CollisionPairBuffer *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AABB_TREE_H */
@@ -6,39 +6,257 @@
  */
 
 #include "collision.h"
+#include "aabb_tree.h"
 #include "octree.h"
 #include "sat.h"
+#include "spatial_hash.h"
+#include "sweep_prune.h"
+
+#include <stdlib.h>
+#include <string.h>
 
 /*
- * OctreePool is ~850 KB. Using a static instance avoids blowing the default
- * 8 MB Linux stack while keeping the allocation simple (no caller-managed
- * heap). This means collision_detect is NOT thread-safe if called from
- * multiple threads simultaneously — acceptable for the serial sim loop.
- * For a multi-threaded future, replace with a caller-provided pool parameter.
+ * Workspace behind collision_detect(), collision_detect_world() and a NULL
+ * workspace argument. Callers sharing it must not overlap; SimContext and
+ * the sim_run family each use their own.
  */
-static OctreePool s_pool;
+static CollisionWorkspace s_workspace;
 
-/* Heuristic: up to 8 broad-phase candidates per confirmed pair. */
-#define MAX_CANDIDATES 8192
+void collision_workspace_init(CollisionWorkspace *ws) {
+    memset(ws, 0, sizeof(*ws));
+}
 
-int collision_detect(const PhysicsObject *objects, int count,
-                     CollisionPair *pairs_out, int max_pairs) {
+void collision_workspace_free(CollisionWorkspace *ws) {
+    if (ws->pool) octree_pool_free(ws->pool);
+    if (ws->sweep) sweep_prune_free(ws->sweep);
+    if (ws->grid) spatial_hash_free(ws->grid);
+    if (ws->bvh) aabb_tree_free(ws->bvh);
+    free(ws->pool);
+    free(ws->sweep);
+    free(ws->grid);
+    free(ws->bvh);
+    collision_pairs_free(&ws->candidates);
+    free(ws->bodies);
+    collision_workspace_init(ws);
+}
+
+void collision_pairs_init(CollisionPairBuffer *buffer) {
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void collision_pairs_free(CollisionPairBuffer *buffer) {
+    free(buffer->pairs);
+    collision_pairs_init(buffer);
+}
+
+int collision_pairs_reserve(CollisionPairBuffer *buffer, int capacity) {
+    if (capacity <= buffer->capacity) return 0;
+    CollisionPair *grown = realloc(buffer->pairs, (size_t)capacity * sizeof(*grown));
+    if (!grown) return -1;
+    buffer->pairs    = grown;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+/* Create the (empty) octree pool on first use; its nodes grow during builds. */
+static int workspace_ready(CollisionWorkspace *ws) {
+    if (!ws->pool) {
+        ws->pool = malloc(sizeof(*ws->pool));
+        if (!ws->pool) return 0;
+        octree_pool_init(ws->pool);
+    }
+    return 1;
+}
+
+/* Create the (empty) sweep-and-prune state on first use. */
+static int sweep_ready(CollisionWorkspace *ws) {
+    if (!ws->sweep) {
+        ws->sweep = malloc(sizeof(*ws->sweep));
+        if (!ws->sweep) return 0;
+        sweep_prune_init(ws->sweep);
+    }
+    return 1;
+}
+
+/* Create the (empty) spatial hash grid on first use. */
+static int grid_ready(CollisionWorkspace *ws) {
+    if (!ws->grid) {
+        ws->grid = malloc(sizeof(*ws->grid));
+        if (!ws->grid) return 0;
+        spatial_hash_init(ws->grid);
+    }
+    return 1;
+}
+
+/* Create the (empty) AABB tree on first use. */
+static int bvh_ready(CollisionWorkspace *ws) {
+    if (!ws->bvh) {
+        ws->bvh = malloc(sizeof(*ws->bvh));
+        if (!ws->bvh) return 0;
+        aabb_tree_init(ws->bvh);
+    }
+    return 1;
+}
+
+void collision_workspace_set_broad_phase(CollisionWorkspace *ws,
+                                         CollisionBroadPhase broad) {
+    if (!ws) ws = &s_workspace;
+    ws->broad_phase = broad;
+}
+
+int collision_workspace_reserve(CollisionWorkspace *ws, int nodes, int candidates) {
+    if (!ws) ws = &s_workspace;
+    if (!workspace_ready(ws)) return -1;
+    if (octree_pool_reserve(ws->pool, nodes) != 0) return -1;
+    return collision_pairs_reserve(&ws->candidates, candidates);
+}
+
+void collision_workspace_usage(const CollisionWorkspace *ws, CollisionUsage *out) {
+    if (!ws) ws = &s_workspace;
+    out->node_capacity        = ws->pool ? ws->pool->capacity : 0;
+    out->node_high_water      = ws->pool ? ws->pool->high_water : 0;
+    out->candidate_capacity   = ws->candidates.capacity;
+    out->candidate_high_water = ws->candidate_high_water;
+    out->body_capacity        = ws->body_capacity;
+}
+
+static CollisionBody *reserve_bodies(CollisionWorkspace *ws, int count) {
+    if (count > ws->body_capacity) {
+        CollisionBody *grown = realloc(ws->bodies, (size_t)count * sizeof(*grown));
+        if (!grown) return NULL;
+        ws->bodies        = grown;
+        ws->body_capacity = count;
+    }
+    return ws->bodies;
+}
+
+/* Octree candidates into ws->candidates; returns their number. */
+static int octree_candidates(CollisionWorkspace *ws, const CollisionBody *bodies, int count) {
+    if (!workspace_ready(ws))
+        return 0;
+    octree_build(ws->pool, bodies, count);
+    return octree_query_pairs(ws->pool, &ws->candidates);
+}
+
+/*
+ * Phase 1: candidate pairs into ws->candidates; returns their number. If
+ * the selected sweep, grid or BVH cannot set up, update or query (out of
+ * memory), the octree finds the candidates for this tick instead.
+ */
+static int broad_phase(CollisionWorkspace *ws, const CollisionBody *bodies, int count) {
+    int n = -1;
+    switch (ws->broad_phase) {
+        case COLLISION_BROAD_SWEEP:
+            if (sweep_ready(ws) && sweep_prune_update(ws->sweep, bodies, count) == 0)
+                n = sweep_prune_query_pairs(ws->sweep, &ws->candidates);
+            break;
+        case COLLISION_BROAD_GRID:
+            if (grid_ready(ws) && spatial_hash_build(ws->grid, bodies, count) == 0)
+                n = spatial_hash_query_pairs(ws->grid, &ws->candidates);
+            break;
+        case COLLISION_BROAD_BVH:
+            if (bvh_ready(ws) && aabb_tree_update(ws->bvh, bodies, count) == 0)
+                n = aabb_tree_query_pairs(ws->bvh, &ws->candidates);
+            break;
+        default:
+            break;
+    }
+    if (n < 0)
+        n = octree_candidates(ws, bodies, count);
+    if (n > ws->candidate_high_water)
+        ws->candidate_high_water = n;
+    return n;
+}
+
+int collision_detect_bodies(CollisionWorkspace *ws,
+                            const CollisionBody *bodies, int count,
+                            CollisionPair *pairs_out, int max_pairs) {
     if (count <= 1 || !pairs_out || max_pairs <= 0)
         return 0;
 
     /* --- Phase 1: broad phase --- */
-    octree_build(&s_pool, objects, count);
-
-    static CollisionPair s_candidates[MAX_CANDIDATES];
-    int n_candidates = octree_query_pairs(&s_pool, s_candidates, MAX_CANDIDATES);
+    int n_candidates = broad_phase(ws, bodies, count);
 
     if (n_candidates == 0)
         return 0;
 
     /* --- Phase 2: narrow phase --- */
     int out_count = 0;
-    sat_test_pairs(objects, s_candidates, n_candidates,
+    sat_test_pairs(bodies, ws->candidates.pairs, n_candidates,
                    pairs_out, &out_count, max_pairs);
 
     return out_count;
 }
+
+/* Both phases over ws->bodies, sizing @p out from the candidate count. */
+static int detect_into(CollisionWorkspace *ws, int count, CollisionPairBuffer *out) {
+    int n_candidates = broad_phase(ws, ws->bodies, count);
+    if (n_candidates == 0)
+        return 0;
+
+    /* Every confirmed pair is a candidate, so this is always enough room;
+       on failure the existing capacity is used. */
+    collision_pairs_reserve(out, n_candidates);
+    sat_test_pairs(ws->bodies, ws->candidates.pairs, n_candidates,
+                   out->pairs, &out->count, out->capacity);
+    return out->count;
+}
+
+int collision_detect_ws(CollisionWorkspace *ws,
+                        const PhysicsObject *objects, int count,
+                        CollisionPairBuffer *out) {
+    if (!ws) ws = &s_workspace;
+    out->count = 0;
+    if (count <= 1)
+        return 0;
+
+    CollisionBody *bodies = reserve_bodies(ws, count);
+    if (!bodies) return 0;
+    for (int i = 0; i < count; i++)
+        bodies[i] = collision_body_from_object(&objects[i]);
+
+    return detect_into(ws, count, out);
+}
+
+int collision_detect_world_ws(CollisionWorkspace *ws, const PhysicsWorld *world,
+                              CollisionPairBuffer *out) {
+    if (!ws) ws = &s_workspace;
+    out->count = 0;
+    const int count = world->count;
+    if (count <= 1)
+        return 0;
+
+    CollisionBody *bodies = reserve_bodies(ws, count);
+    if (!bodies) return 0;
+    for (int i = 0; i < count; i++)
+        bodies[i] = collision_body_from_world(world, i);
+
+    return detect_into(ws, count, out);
+}
+
+int collision_detect(const PhysicsObject *objects, int count,
+                     CollisionPair *pairs_out, int max_pairs) {
+    if (count <= 1 || !pairs_out || max_pairs <= 0)
+        return 0;
+
+    CollisionBody *bodies = reserve_bodies(&s_workspace, count);
+    if (!bodies) return 0;
+    for (int i = 0; i < count; i++)
+        bodies[i] = collision_body_from_object(&objects[i]);
+
+    return collision_detect_bodies(&s_workspace, bodies, count, pairs_out, max_pairs);
+}
+
+int collision_detect_world(const PhysicsWorld *world,
+                           CollisionPair *pairs_out, int max_pairs) {
+    const int count = world->count;
+    if (count <= 1 || !pairs_out || max_pairs <= 0)
+        return 0;
+
+    CollisionBody *bodies = reserve_bodies(&s_workspace, count);
+    if (!bodies) return 0;
+    for (int i = 0; i < count; i++)
+        bodies[i] = collision_body_from_world(world, i);
+
+    return collision_detect_bodies(&s_workspace, bodies, count, pairs_out, max_pairs);
+}
@@ -2,9 +2,10 @@
  * @file collision.h
  * @brief Public interface for broad-phase + narrow-phase collision detection.
  *
- * collision_detect() is the single entry point. It sequences an octree
- * broad phase (AABB overlap) followed by a SAT narrow phase and writes the
- * confirmed colliding index pairs to a caller-allocated output buffer.
+ * collision_detect() is the single entry point. It sequences a broad phase
+ * (AABB overlap; an octree by default, sweep and prune, a spatial hash grid
+ * or a dynamic AABB tree) followed by a SAT narrow phase and writes the confirmed colliding
+ * index pairs to a caller-allocated output buffer.
  *
  * CONVEX GEOMETRY ONLY: the SAT narrow phase is mathematically valid only for
  * convex meshes. Concave objects must be decomposed into convex pieces (e.g.
@@ -21,6 +22,8 @@
 #define COLLISION_H
 
 #include "../../models/object.h"
+#include "../../models/mesh.h"
+#include "../../models/world.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +35,156 @@ typedef struct {
     int index_b;
 } CollisionPair;
 
+/**
+ * @brief Read-only view of one body's geometry for the collision pipeline.
+ *
+ * The broad and narrow phases read bodies only through this view, so they run
+ * unchanged over a PhysicsObject array or a PhysicsWorld. Views are rebuilt
+ * each call and point into the mesh registry.
+ */
+typedef struct {
+    Vec3        position;     /**< World-space origin of the mesh. */
+    const Vec3 *verts;        /**< Local-space vertices. */
+    const int (*faces)[3];    /**< Vertex index triples, CCW winding. */
+    int         vertex_count; /**< 0 = point (skipped by the narrow phase). */
+    int         face_count;
+} CollisionBody;
+
+/** View of registered mesh @p mesh_id placed at @p position. */
+static inline CollisionBody collision_body_make(Vec3 position, int mesh_id) {
+    const ObjectMesh *mesh = mesh_get(mesh_id);
+    if (!mesh) return (CollisionBody){ .position = position };
+    return (CollisionBody){
+        .position     = position,
+        .verts        = mesh_vertices(mesh),
+        .faces        = mesh_faces(mesh),
+        .vertex_count = mesh->vertex_count,
+        .face_count   = mesh->face_count,
+    };
+}
+
+/** View of a PhysicsObject's referenced mesh. */
+static inline CollisionBody collision_body_from_object(const PhysicsObject *obj) {
+    return collision_body_make(obj->position, obj->mesh_id);
+}
+
+/** View of body @p i of a PhysicsWorld. */
+static inline CollisionBody collision_body_from_world(const PhysicsWorld *world, int i) {
+    return collision_body_make(world->position[i], world->mesh_id[i]);
+}
+
+/**
+ * @brief Growable pair storage, reused across calls.
+ *
+ * Holds broad-phase candidates inside a CollisionWorkspace and confirmed
+ * pairs for the *_ws detection entry points, which size it from the
+ * candidate count so it tracks the number of contacts rather than the
+ * N(N−1)/2 worst case. Never shrinks; @c capacity is the high-water mark.
+ * Initialise with collision_pairs_init().
+ */
+typedef struct {
+    CollisionPair *pairs;    /**< Pairs; the first @c count are valid. */
+    int            count;    /**< Pairs written by the last call that filled it. */
+    int            capacity; /**< Entries allocated in @c pairs. */
+} CollisionPairBuffer;
+
+/** @brief Initialise an empty pair buffer (no allocation until first use). */
+void collision_pairs_init(CollisionPairBuffer *buffer);
+
+/** @brief Release the pair storage and reset @p buffer to the empty state. */
+void collision_pairs_free(CollisionPairBuffer *buffer);
+
+/**
+ * @brief Ensure room for at least @p capacity pairs, preserving stored pairs.
+ *
+ * @return 0 on success, -1 on allocation failure (the buffer is unchanged).
+ */
+int collision_pairs_reserve(CollisionPairBuffer *buffer, int capacity);
+
+struct OctreePool;
+struct SweepPrune;
+struct SpatialHash;
+struct AabbTree;
+
+/** Broad-phase algorithm used by a CollisionWorkspace. */
+typedef enum {
+    COLLISION_BROAD_OCTREE = 0, /**< Octree rebuilt every call (octree.h). */
+    COLLISION_BROAD_SWEEP,      /**< Sweep and prune, re-sorted incrementally (sweep_prune.h). */
+    COLLISION_BROAD_GRID,       /**< Hashed uniform grid for similarly sized bodies (spatial_hash.h). */
+    COLLISION_BROAD_BVH,        /**< Dynamic AABB tree, refitted incrementally (aabb_tree.h). */
+} CollisionBroadPhase;
+
+/**
+ * @brief Broad-phase pool and scratch buffers, reused across calls.
+ *
+ * collision_detect() and collision_detect_world() run on one module-level
+ * workspace. Callers that step the same scene repeatedly (SimContext) own a
+ * workspace instead, so nothing is shared between scenes. Initialise with
+ * collision_workspace_init(); buffers are allocated on first use, grow
+ * (amortised doubling) when a tick needs more room than any before it, and
+ * are released by collision_workspace_free(). Fields are internal to
+ * collision.c; read sizes through collision_workspace_usage().
+ */
+typedef struct {
+    CollisionBroadPhase broad_phase;  /**< Selected broad phase (default octree). */
+    struct OctreePool  *pool;         /**< Octree node pool (heap). */
+    struct SweepPrune  *sweep;        /**< Sweep-and-prune endpoint lists, kept between calls. */
+    struct SpatialHash *grid;         /**< Spatial hash grid (heap). */
+    struct AabbTree    *bvh;          /**< Dynamic AABB tree, kept between calls. */
+    CollisionPairBuffer candidates;   /**< Broad-phase candidate pairs. */
+    int                 candidate_high_water;
+    CollisionBody      *bodies;       /**< Geometry views for the current call. */
+    int                 body_capacity;
+} CollisionWorkspace;
+
+/** @brief Storage a workspace holds and the most of it any tick has used. */
+typedef struct {
+    int node_capacity;        /**< Octree nodes allocated. */
+    int node_high_water;      /**< Most nodes one octree build has used. */
+    int candidate_capacity;   /**< Candidate pairs allocated. */
+    int candidate_high_water; /**< Most candidates one broad phase produced. */
+    int body_capacity;        /**< Geometry views allocated. */
+} CollisionUsage;
+
+/** @brief Initialise an empty workspace (no allocation until first use). */
+void collision_workspace_init(CollisionWorkspace *ws);
+
+/** @brief Release all buffers and reset @p ws to the empty state. */
+void collision_workspace_free(CollisionWorkspace *ws);
+
+/**
+ * @brief Pre-size @p ws, e.g. from high-water marks of an earlier run.
+ *
+ * @param ws          Workspace, or NULL for the one shared with collision_detect().
+ * @param nodes       Octree nodes to allocate.
+ * @param candidates  Candidate pairs to allocate.
+ * @return            0 on success, -1 on allocation failure.
+ */
+int collision_workspace_reserve(CollisionWorkspace *ws, int nodes, int candidates);
+
+/**
+ * @brief Select the broad phase @p ws runs from its next call.
+ *
+ * Sweep and prune and the AABB tree keep their state between calls, so they
+ * pay off when one workspace sees the same scene tick after tick with little
+ * motion per tick. The spatial hash suits scenes of similarly sized bodies.
+ * Confirmed pairs are the same whichever is used. A tick on which the
+ * selected phase runs out of memory falls back to the octree.
+ *
+ * @param ws     Workspace, or NULL for the one shared with collision_detect().
+ * @param broad  Broad phase to use.
+ */
+void collision_workspace_set_broad_phase(CollisionWorkspace *ws,
+                                         CollisionBroadPhase broad);
+
+/**
+ * @brief Report the storage held by @p ws.
+ *
+ * @param ws   Workspace, or NULL for the one shared with collision_detect().
+ * @param out  Receives the sizes. Must not be NULL.
+ */
+void collision_workspace_usage(const CollisionWorkspace *ws, CollisionUsage *out);
+
 /**
  * @brief Detect all colliding pairs among count objects.
  *
@@ -40,7 +193,7 @@ typedef struct {
  * Phase 2 (narrow): runs SAT on each candidate and retains only true
  *   intersections.
  *
- * Objects with vertex_count == 0 are treated as points in the broad phase and
+ * Objects without a mesh (MESH_NONE) are treated as points in the broad phase and
  * skipped by the narrow phase (they produce no confirmed pairs).
  *
  * @param objects    Flat array of PhysicsObject. Must not be NULL.
@@ -52,6 +205,63 @@ typedef struct {
 int collision_detect(const PhysicsObject *objects, int count,
                      CollisionPair *pairs_out, int max_pairs);
 
+/**
+ * @brief collision_detect() over the bodies of a PhysicsWorld.
+ *
+ * Reads positions and the cold mesh array only; pair indices refer to world
+ * body indices.
+ *
+ * @param world      World to test. Must not be NULL.
+ * @param pairs_out  Caller-allocated buffer for confirmed collision pairs.
+ * @param max_pairs  Capacity of pairs_out; extra pairs are silently dropped.
+ * @return           Number of confirmed collision pairs written to pairs_out.
+ */
+int collision_detect_world(const PhysicsWorld *world,
+                           CollisionPair *pairs_out, int max_pairs);
+
+/**
+ * @brief collision_detect() into a growable pair buffer.
+ *
+ * @p out is grown to the broad-phase candidate count before the narrow phase,
+ * so no pair is dropped for lack of room. If growth fails the existing
+ * capacity is used and extra pairs are dropped.
+ *
+ * @param ws         Workspace owned by the caller, or NULL for the one shared
+ *                   with collision_detect().
+ * @param objects    Flat array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects.
+ * @param out        Receives the confirmed pairs. Must not be NULL.
+ * @return           out->count, the number of confirmed collision pairs.
+ */
+int collision_detect_ws(CollisionWorkspace *ws,
+                        const PhysicsObject *objects, int count,
+                        CollisionPairBuffer *out);
+
+/**
+ * @brief collision_detect_world() into a growable pair buffer.
+ *
+ * @param ws         Workspace owned by the caller, or NULL for the shared one.
+ * @param world      World to test. Must not be NULL.
+ * @param out        Receives the confirmed pairs. Must not be NULL.
+ * @return           out->count, the number of confirmed collision pairs.
+ */
+int collision_detect_world_ws(CollisionWorkspace *ws, const PhysicsWorld *world,
+                              CollisionPairBuffer *out);
+
+/**
+ * @brief collision_detect() over prepared geometry views.
+ *
+ * @param ws         Workspace providing the broad-phase pool. Must not be NULL.
+ * @param bodies     Array of @p count views. Must not be NULL.
+ * @param count      Number of bodies.
+ * @param pairs_out  Caller-allocated buffer for confirmed collision pairs.
+ * @param max_pairs  Capacity of pairs_out; extra pairs are silently dropped.
+ * @return           Number of confirmed collision pairs written to pairs_out.
+ */
+int collision_detect_bodies(CollisionWorkspace *ws,
+                            const CollisionBody *bodies, int count,
+                            CollisionPair *pairs_out, int max_pairs);
+
 #ifdef __cplusplus
 }
 #endif
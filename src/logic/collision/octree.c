@@ -6,28 +6,114 @@
  */
 
 #include "octree.h"
+#include <stdlib.h>
 #include <string.h>
 
+/* ------------------------------------------------------------------ */
+/* Pool storage                                                          */
+/* ------------------------------------------------------------------ */
+
+void octree_pool_init(OctreePool *pool) {
+    memset(pool, 0, sizeof(*pool));
+}
+
+void octree_pool_free(OctreePool *pool) {
+    free(pool->nodes);
+    free(pool->pair_keys);
+    octree_pool_init(pool);
+}
+
+int octree_pool_reserve(OctreePool *pool, int capacity) {
+    if (capacity <= pool->capacity) return 0;
+    OctreeNode *grown = realloc(pool->nodes, (size_t)capacity * sizeof(*grown));
+    if (!grown) return -1;
+    pool->nodes    = grown;
+    pool->capacity = capacity;
+    return 0;
+}
+
 /* ------------------------------------------------------------------ */
 /* Internal helpers                                                      */
 /* ------------------------------------------------------------------ */
 
+/*
+ * Append a leaf node, doubling the array when full. Growth moves the nodes,
+ * so callers must not hold OctreeNode pointers across this call.
+ */
 static int alloc_node(OctreePool *pool, AABB bounds, int depth) {
-    if (pool->node_count >= OCTREE_MAX_NODES)
-        return OCTREE_NULL;
+    if (pool->node_count >= pool->capacity) {
+        int grown = pool->capacity > 0 ? 2 * pool->capacity : OCTREE_INITIAL_NODES;
+        if (octree_pool_reserve(pool, grown) != 0)
+            return OCTREE_NULL;
+    }
 
     int idx = pool->node_count++;
+    if (pool->node_count > pool->high_water)
+        pool->high_water = pool->node_count;
     OctreeNode *n = &pool->nodes[idx];
     memset(n, 0, sizeof(*n));
     n->bounds     = bounds;
     n->depth      = depth;
     n->is_leaf    = 1;
     n->body_count = 0;
+    n->overflow   = OCTREE_NULL;
     for (int i = 0; i < 8; i++)
         n->children[i] = OCTREE_NULL;
     return idx;
 }
 
+/*
+ * Store body_idx in the full leaf node_idx, chaining a new overflow block
+ * when the last one is full. Drops the body only if the pool cannot grow.
+ */
+static void store_overflow(OctreePool *pool, int node_idx, int body_idx) {
+    int last = node_idx;
+    while (pool->nodes[last].overflow != OCTREE_NULL)
+        last = pool->nodes[last].overflow;
+
+    if (pool->nodes[last].body_count == OCTREE_LEAF_CAPACITY) {
+        const OctreeNode *leaf = &pool->nodes[node_idx];
+        int block = alloc_node(pool, leaf->bounds, leaf->depth);  /* may move the pool */
+        if (block == OCTREE_NULL)
+            return;
+        pool->nodes[last].overflow = block;
+        last = block;
+    }
+
+    OctreeNode *n = &pool->nodes[last];
+    n->body_indices[n->body_count++] = body_idx;
+}
+
+/* 1 if @p box overlaps all eight octants in @p octants. */
+static int overlaps_all(const AABB octants[8], AABB box) {
+    for (int c = 0; c < 8; c++) {
+        if (!aabb_overlaps(octants[c], box))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * A split separates nothing when the new body and every body already in the
+ * full leaf overlap all eight octants: each child would receive all of them
+ * again, and so on down to OCTREE_MAX_DEPTH — 8^depth leaves for one tight
+ * cluster.
+ */
+static int split_is_useless(const OctreePool *pool, int node_idx,
+                            AABB body_aabb, const CollisionBody *bodies) {
+    const OctreeNode *node = &pool->nodes[node_idx];
+    AABB octants[8];
+    aabb_split_octants(node->bounds, octants);
+
+    if (!overlaps_all(octants, body_aabb))
+        return 0;
+    for (int k = 0; k < node->body_count; k++) {
+        if (!overlaps_all(octants, aabb_from_body(&bodies[node->body_indices[k]])))
+            return 0;
+    }
+    return 1;
+}
+
 /* Grow an AABB to encompass the given corner point. */
 static void expand_to(AABB *box, Vec3 p) {
     if (p.x < box->min.x) box->min.x = p.x;
@@ -45,25 +131,30 @@ static void expand_to(AABB *box, Vec3 p) {
 /*
  * Recursively insert body_idx into all leaves of node_idx whose bounds
  * overlap body_aabb. On capacity overflow, the leaf is split and existing
- * bodies redistributed before the new body is inserted.
+ * bodies redistributed before the new body is inserted. A full leaf that
+ * cannot split usefully — at OCTREE_MAX_DEPTH, or with every body spanning
+ * all its octants — keeps further bodies in overflow blocks instead, and
+ * stays a leaf.
  *
- * objects is needed during splits to recompute AABBs for redistributed bodies.
+ * bodies is needed during splits to recompute AABBs for redistributed bodies.
  */
 static void insert_body(OctreePool *pool, int node_idx,
                          int body_idx, AABB body_aabb,
-                         const PhysicsObject *objects) {
+                         const CollisionBody *bodies) {
     if (!aabb_overlaps(pool->nodes[node_idx].bounds, body_aabb))
         return;
 
     OctreeNode *node = &pool->nodes[node_idx];
 
     if (node->is_leaf) {
-        if (node->body_count < OCTREE_LEAF_CAPACITY ||
-                node->depth >= OCTREE_MAX_DEPTH) {
-            /* Store directly (at max depth we may exceed capacity, but the
-               body count stays finite since it is bounded by the object count). */
-            if (node->body_count < OCTREE_LEAF_CAPACITY)
-                node->body_indices[node->body_count++] = body_idx;
+        if (node->body_count < OCTREE_LEAF_CAPACITY) {
+            node->body_indices[node->body_count++] = body_idx;
+            return;
+        }
+        if (node->depth >= OCTREE_MAX_DEPTH || node->overflow != OCTREE_NULL ||
+                split_is_useless(pool, node_idx, body_aabb, bodies)) {
+            /* Splitting cannot help — spill into overflow blocks. */
+            store_overflow(pool, node_idx, body_idx);
             return;
         }
 
@@ -73,10 +164,12 @@ static void insert_body(OctreePool *pool, int node_idx,
 
         int saved[OCTREE_LEAF_CAPACITY];
         int saved_count = node->body_count;
+        int child_depth = node->depth + 1;
         memcpy(saved, node->body_indices, saved_count * sizeof(int));
 
+        /* alloc_node() may move the pool; index it afresh from here on. */
         for (int c = 0; c < 8; c++) {
-            int ci = alloc_node(pool, child_bounds[c], node->depth + 1);
+            int ci = alloc_node(pool, child_bounds[c], child_depth);
             pool->nodes[node_idx].children[c] = ci;
         }
         pool->nodes[node_idx].is_leaf    = 0;
@@ -84,11 +177,11 @@ static void insert_body(OctreePool *pool, int node_idx,
 
         /* Redistribute existing bodies into children. */
         for (int k = 0; k < saved_count; k++) {
-            AABB saved_aabb = aabb_from_object(&objects[saved[k]]);
+            AABB saved_aabb = aabb_from_body(&bodies[saved[k]]);
             for (int c = 0; c < 8; c++) {
                 int ci = pool->nodes[node_idx].children[c];
                 if (ci != OCTREE_NULL)
-                    insert_body(pool, ci, saved[k], saved_aabb, objects);
+                    insert_body(pool, ci, saved[k], saved_aabb, bodies);
             }
         }
     }
@@ -98,7 +191,7 @@ static void insert_body(OctreePool *pool, int node_idx,
         for (int c = 0; c < 8; c++) {
             int ci = pool->nodes[node_idx].children[c];
             if (ci != OCTREE_NULL)
-                insert_body(pool, ci, body_idx, body_aabb, objects);
+                insert_body(pool, ci, body_idx, body_aabb, bodies);
         }
     }
 }
@@ -107,7 +200,7 @@ static void insert_body(OctreePool *pool, int node_idx,
 /* Public: octree_build                                                  */
 /* ------------------------------------------------------------------ */
 
-void octree_build(OctreePool *pool, const PhysicsObject *objects, int count) {
+void octree_build(OctreePool *pool, const CollisionBody *bodies, int count) {
     pool->node_count = 0;
 
     if (count == 0) {
@@ -116,9 +209,9 @@ void octree_build(OctreePool *pool, const PhysicsObject *objects, int count) {
     }
 
     /* Compute world AABB spanning all object meshes. */
-    AABB world = aabb_from_object(&objects[0]);
+    AABB world = aabb_from_body(&bodies[0]);
     for (int i = 1; i < count; i++) {
-        AABB b = aabb_from_object(&objects[i]);
+        AABB b = aabb_from_body(&bodies[i]);
         expand_to(&world, b.min);
         expand_to(&world, b.max);
     }
@@ -127,11 +220,12 @@ void octree_build(OctreePool *pool, const PhysicsObject *objects, int count) {
     world.min.x -= 1e-6; world.min.y -= 1e-6; world.min.z -= 1e-6;
     world.max.x += 1e-6; world.max.y += 1e-6; world.max.z += 1e-6;
 
-    alloc_node(pool, world, 0);  /* root is always node 0 */
+    if (alloc_node(pool, world, 0) == OCTREE_NULL)  /* root is always node 0 */
+        return;
 
     for (int i = 0; i < count; i++) {
-        AABB body_aabb = aabb_from_object(&objects[i]);
-        insert_body(pool, 0, i, body_aabb, objects);
+        AABB body_aabb = aabb_from_body(&bodies[i]);
+        insert_body(pool, 0, i, body_aabb, bodies);
     }
 }
 
@@ -139,50 +233,112 @@ void octree_build(OctreePool *pool, const PhysicsObject *objects, int count) {
 /* Pair collection                                                        */
 /* ------------------------------------------------------------------ */
 
-/* Linear-scan deduplication — O(P) per emit, suitable for small P.
-   Replace with a hash set or sort+unique for large-N optimisation. */
-static int pair_seen(const CollisionPair *pairs, int count, int ia, int ib) {
-    for (int k = 0; k < count; k++) {
-        if (pairs[k].index_a == ia && pairs[k].index_b == ib)
+/* Candidate pairs allocated by the first query into an empty buffer. */
+#define OCTREE_INITIAL_PAIRS 1024
+
+/* Empty slot marker in the pair set; no canonical pair has index_a = -1. */
+#define PAIR_KEY_EMPTY (~0ULL)
+
+static unsigned long long pair_key(int ia, int ib) {
+    return ((unsigned long long)(unsigned)ia << 32) | (unsigned)ib;
+}
+
+/* Fibonacci hash of @p key into a table of @p capacity (a power of two) slots. */
+static int pair_slot(unsigned long long key, int capacity) {
+    return (int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+/*
+ * Insert @p key unless present. Returns 1 if inserted, 0 if already there.
+ * The table is kept at most half full, so probe runs stay short.
+ */
+static int pair_set_insert(unsigned long long *keys, int capacity,
+                           unsigned long long key) {
+    for (int slot = pair_slot(key, capacity);; slot = (slot + 1) & (capacity - 1)) {
+        if (keys[slot] == key) return 0;
+        if (keys[slot] == PAIR_KEY_EMPTY) {
+            keys[slot] = key;
             return 1;
+        }
+    }
+}
+
+/*
+ * Resize the set to @p capacity slots and refill it from the pairs already
+ * emitted (which are exactly its contents). Returns -1 on allocation failure.
+ */
+static int pair_set_rebuild(OctreePool *pool, const CollisionPairBuffer *out,
+                            int capacity) {
+    if (capacity > pool->pair_key_capacity) {
+        unsigned long long *grown = malloc((size_t)capacity * sizeof(*grown));
+        if (!grown) return -1;
+        free(pool->pair_keys);
+        pool->pair_keys         = grown;
+        pool->pair_key_capacity = capacity;
+    }
+    memset(pool->pair_keys, 0xff, (size_t)pool->pair_key_capacity * sizeof(*pool->pair_keys));
+    for (int k = 0; k < out->count; k++) {
+        pair_set_insert(pool->pair_keys, pool->pair_key_capacity,
+                        pair_key(out->pairs[k].index_a, out->pairs[k].index_b));
     }
     return 0;
 }
 
-static void emit_pair(CollisionPair *pairs_out, int *pair_count, int max_pairs,
-                      int ia, int ib) {
+static void emit_pair(OctreePool *pool, CollisionPairBuffer *out, int ia, int ib) {
     if (ia > ib) { int t = ia; ia = ib; ib = t; }  /* canonical: smaller index first */
-    if (*pair_count >= max_pairs) return;
-    if (pair_seen(pairs_out, *pair_count, ia, ib)) return;
-    pairs_out[(*pair_count)++] = (CollisionPair){ .index_a = ia, .index_b = ib };
+
+    /* Keep the set at most half full; a failed resize drops the pair. */
+    if (2 * (out->count + 1) > pool->pair_key_capacity &&
+            pair_set_rebuild(pool, out, 2 * pool->pair_key_capacity) != 0)
+        return;
+    if (!pair_set_insert(pool->pair_keys, pool->pair_key_capacity, pair_key(ia, ib)))
+        return;
+
+    if (out->count >= out->capacity) {
+        int grown = out->capacity > 0 ? 2 * out->capacity : OCTREE_INITIAL_PAIRS;
+        if (collision_pairs_reserve(out, grown) != 0) return;
+    }
+    out->pairs[out->count++] = (CollisionPair){ .index_a = ia, .index_b = ib };
 }
 
-static void collect_leaf_pairs(const OctreePool *pool, int node_idx,
-                                CollisionPair *pairs_out, int *pair_count,
-                                int max_pairs) {
+static void collect_leaf_pairs(OctreePool *pool, int node_idx,
+                                CollisionPairBuffer *out) {
     const OctreeNode *node = &pool->nodes[node_idx];
 
     if (node->is_leaf) {
-        /* All combinations of the k bodies in this leaf. */
-        for (int i = 0; i < node->body_count; i++) {
-            for (int j = i + 1; j < node->body_count; j++) {
-                emit_pair(pairs_out, pair_count, max_pairs,
-                          node->body_indices[i], node->body_indices[j]);
+        /* All combinations of the k bodies in this leaf, across its block
+           and any overflow blocks chained to it. */
+        for (int a = node_idx; a != OCTREE_NULL; a = pool->nodes[a].overflow) {
+            const OctreeNode *block_a = &pool->nodes[a];
+            for (int i = 0; i < block_a->body_count; i++) {
+                for (int b = a; b != OCTREE_NULL; b = pool->nodes[b].overflow) {
+                    const OctreeNode *block_b = &pool->nodes[b];
+                    for (int j = (b == a) ? i + 1 : 0; j < block_b->body_count; j++) {
+                        emit_pair(pool, out, block_a->body_indices[i],
+                                  block_b->body_indices[j]);
+                    }
+                }
             }
         }
     } else {
         for (int c = 0; c < 8; c++) {
             if (node->children[c] != OCTREE_NULL)
-                collect_leaf_pairs(pool, node->children[c],
-                                   pairs_out, pair_count, max_pairs);
+                collect_leaf_pairs(pool, node->children[c], out);
         }
     }
 }
 
-int octree_query_pairs(const OctreePool *pool, CollisionPair *pairs_out,
-                       int max_pairs) {
-    int pair_count = 0;
-    if (pool->node_count > 0)
-        collect_leaf_pairs(pool, 0, pairs_out, &pair_count, max_pairs);
-    return pair_count;
+int octree_query_pairs(OctreePool *pool, CollisionPairBuffer *out) {
+    out->count = 0;
+    if (pool->node_count == 0)
+        return 0;
+
+    /* Start from an empty set at least as large as the last query needed. */
+    int capacity = pool->pair_key_capacity > 0 ? pool->pair_key_capacity
+                                               : 2 * OCTREE_INITIAL_PAIRS;
+    if (pair_set_rebuild(pool, out, capacity) != 0)
+        return 0;
+
+    collect_leaf_pairs(pool, 0, out);
+    return out->count;
 }
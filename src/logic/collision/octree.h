@@ -2,9 +2,11 @@
  * @file octree.h
  * @brief Integer-indexed node-pool octree for broad-phase collision detection.
  *
- * The entire tree lives in a flat OctreePool array — no dynamic allocation,
- * no pointers inside nodes. Integer child indices let the pool be serialised
- * or uploaded to GPU memory with a single cudaMemcpy (future optimisation).
+ * The entire tree lives in one contiguous OctreePool node array — no
+ * pointers inside nodes. Integer child indices let the pool be serialised or
+ * uploaded to GPU memory with a single cudaMemcpy (future optimisation), and
+ * let the array grow by reallocation while a tree is being built. The array
+ * is kept between builds, so a steady-state tick allocates nothing.
  *
  * Objects are inserted into every leaf whose bounds overlap their AABB, so
  * two spatially overlapping objects always share at least one leaf. Candidate
@@ -24,7 +26,7 @@
 extern "C" {
 #endif
 
-#define OCTREE_MAX_NODES 8192
+#define OCTREE_INITIAL_NODES 1024 /* nodes allocated by the first build */
 #define OCTREE_MAX_DEPTH 8
 #define OCTREE_LEAF_CAPACITY 8 /* bodies per leaf before splitting */
 #define OCTREE_NULL -1         /* sentinel: no child / empty slot */
@@ -36,6 +38,12 @@ extern "C" {
  * body_indices[0..body_count-1] holds object indices only when is_leaf == 1.
  * A body can appear in multiple leaves (multi-AABB insertion).
  *
+ * A leaf at OCTREE_MAX_DEPTH cannot split, so once full it chains overflow
+ * blocks: further pool nodes, linked through @c overflow, that hold more of
+ * the same leaf's bodies. Overflow blocks are never anyone's child. Only
+ * deep, crowded leaves pay for them; every other node keeps the fixed
+ * OCTREE_LEAF_CAPACITY.
+ *
  * No pointers — the struct is flat and suitable for cudaMemcpy to device
  * memory.
  */
@@ -46,45 +54,70 @@ typedef struct {
     int body_count;
     int is_leaf;
     int depth;
+    int overflow;  /* next overflow block of this leaf, or OCTREE_NULL */
 } OctreeNode;
 
 /**
- * @brief Pre-allocated node pool.
+ * @brief Growable node pool, reused across builds.
  *
  * nodes[0] is always the root. node_count is the next free slot index.
- * The caller owns the memory (stack, static, or caller-malloc).
+ * The array doubles when a build runs out of nodes and never shrinks.
+ * Initialise with octree_pool_init() and release with octree_pool_free().
  */
-typedef struct {
-    OctreeNode nodes[OCTREE_MAX_NODES];
+typedef struct OctreePool {
+    OctreeNode *nodes;
     int node_count;
+    int capacity;    /**< Nodes allocated. */
+    int high_water;  /**< Most nodes any build has used. */
+
+    unsigned long long *pair_keys;  /**< Open-addressing set used by octree_query_pairs(). */
+    int pair_key_capacity;          /**< Slots in pair_keys (a power of two, or 0). */
 } OctreePool;
 
+/** @brief Initialise an empty pool (no allocation until first use). */
+void octree_pool_init(OctreePool *pool);
+
+/** @brief Release the node array and reset @p pool to the empty state. */
+void octree_pool_free(OctreePool *pool);
+
+/**
+ * @brief Ensure room for at least @p capacity nodes, preserving live nodes.
+ *
+ * @return 0 on success, -1 on allocation failure (the pool is unchanged).
+ */
+int octree_pool_reserve(OctreePool *pool, int capacity);
+
 /**
  * @brief Build an octree from scratch over an array of objects.
  *
  * Resets the pool and inserts every object by its world-space AABB.
- * Objects with vertex_count == 0 are treated as points.
+ * Objects without a mesh are treated as points.
+ *
+ * If the node array cannot grow, the remaining octants are left out of the
+ * tree and bodies that fall only inside them produce no candidates.
  *
- * @param pool     Output pool (caller-allocated, will be fully reset).
- * @param objects  Flat array of PhysicsObject.
+ * @param pool     Output pool (initialised; its tree is fully reset).
+ * @param bodies   Geometry views, one per object.
  * @param count    Number of objects.
  */
-void octree_build(OctreePool *pool, const PhysicsObject *objects, int count);
+void octree_build(OctreePool *pool, const CollisionBody *bodies, int count);
 
 /**
  * @brief Collect all AABB-overlapping candidate pairs from the tree.
  *
  * Iterates every leaf and emits each unique (index_a < index_b) pair of
- * objects that share that leaf. Deduplicates via a linear scan so pairs
- * that appear in multiple leaves are emitted only once.
+ * objects that share that leaf, in first-seen order. Pairs that appear in
+ * multiple leaves are emitted only once: each candidate is checked against
+ * an open-addressing hash set keyed on (index_a, index_b), so the query is
+ * O(P) in the number of pairs. The set lives in @p pool and is reused.
  *
- * @param pool       Tree built by octree_build().
- * @param pairs_out  Caller-allocated output buffer.
- * @param max_pairs  Capacity of pairs_out; extra pairs are silently dropped.
- * @return           Number of candidate pairs written.
+ * @param pool       Tree built by octree_build(); its pair set is updated.
+ * @param out        Receives the candidates; grown as needed (amortised
+ *                   doubling). Pairs that do not fit after a failed growth
+ *                   are dropped.
+ * @return           out->count, the number of candidate pairs.
  */
-int octree_query_pairs(const OctreePool *pool, CollisionPair *pairs_out,
-                       int max_pairs);
+int octree_query_pairs(OctreePool *pool, CollisionPairBuffer *out);
 
 /* TODO:
  * -- CUDA optimisation hook (not implemented) --
@@ -94,8 +127,8 @@ int octree_query_pairs(const OctreePool *pool, CollisionPair *pairs_out,
  * tree in parallel and write pairs to a device-side buffer; copy back.
  *
  * Signature reserved:
- *   int octree_query_pairs_cuda(const OctreePool *pool,
- *                               CollisionPair *pairs_out, int max_pairs);
+ *   int octree_query_pairs_cuda(OctreePool *pool,
+ *                               CollisionPairBuffer *out);
  */
 
 #ifdef __cplusplus
@@ -14,7 +14,12 @@
 /* Internal helpers                                                      */
 /* ------------------------------------------------------------------ */
 
-static void project_interval(const Vec3 *verts, int count, Vec3 axis,
+/*
+ * Project a mesh placed at origin onto axis. (v + origin)·axis is evaluated
+ * as v·axis + origin·axis, so the local vertices are read in place from the
+ * mesh pool and no world-space copy is built, whatever the mesh size.
+ */
+static void project_interval(const Vec3 *verts, int count, Vec3 origin, Vec3 axis,
                                double *min_out, double *max_out) {
     double lo =  1e300, hi = -1e300;
     for (int i = 0; i < count; i++) {
@@ -22,8 +27,9 @@ static void project_interval(const Vec3 *verts, int count, Vec3 axis,
         if (p < lo) lo = p;
         if (p > hi) hi = p;
     }
-    *min_out = lo;
-    *max_out = hi;
+    double shift = vec3_dot(origin, axis);
+    *min_out = lo + shift;
+    *max_out = hi + shift;
 }
 
 /* 1 = overlapping intervals, 0 = gap found (separating axis). */
@@ -32,49 +38,45 @@ static int intervals_overlap(double min_a, double max_a,
     return max_a >= min_b && max_b >= min_a;
 }
 
-/* Test one axis against both world-space vertex sets.
+/* Test one axis against both bodies.
    Returns 0 if this axis separates the bodies (early-exit signal). */
-static int test_axis(const Vec3 *wa, int na, const Vec3 *wb, int nb, Vec3 axis) {
+static int test_axis(const CollisionBody *a, const CollisionBody *b, Vec3 axis) {
     double min_a, max_a, min_b, max_b;
-    project_interval(wa, na, axis, &min_a, &max_a);
-    project_interval(wb, nb, axis, &min_b, &max_b);
+    project_interval(a->verts, a->vertex_count, a->position, axis, &min_a, &max_a);
+    project_interval(b->verts, b->vertex_count, b->position, axis, &min_b, &max_b);
     return intervals_overlap(min_a, max_a, min_b, max_b);
 }
 
 /* ------------------------------------------------------------------ */
-/* Public: sat_test_one                                                  */
+/* Public: sat_test_bodies / sat_test_one                                */
 /* ------------------------------------------------------------------ */
 
-int sat_test_one(const PhysicsObject *a, const PhysicsObject *b) {
-    /* Build world-space vertex arrays on the stack (no heap allocation). */
-    Vec3 wa[PHYS_MAX_VERTICES], wb[PHYS_MAX_VERTICES];
-
-    for (int i = 0; i < a->vertex_count; i++)
-        wa[i] = vec3_add(a->local_verts[i], a->position);
-    for (int i = 0; i < b->vertex_count; i++)
-        wb[i] = vec3_add(b->local_verts[i], b->position);
+int sat_test_bodies(const CollisionBody *a, const CollisionBody *b) {
+    /* Normals and edges are translation-invariant, so both come straight
+       from the local-space vertices. */
+    const Vec3 *la = a->verts, *lb = b->verts;
 
     /* --- Axes from face normals of a --- */
     for (int f = 0; f < a->face_count; f++) {
-        Vec3 v0 = wa[a->face_indices[f][0]];
-        Vec3 v1 = wa[a->face_indices[f][1]];
-        Vec3 v2 = wa[a->face_indices[f][2]];
+        Vec3 v0 = la[a->faces[f][0]];
+        Vec3 v1 = la[a->faces[f][1]];
+        Vec3 v2 = la[a->faces[f][2]];
         Vec3 raw = vec3_cross(vec3_sub(v1, v0), vec3_sub(v2, v0));
         if (vec3_magnitude(raw) < 1e-10) continue;  /* degenerate face */
         Vec3 n = vec3_normalize(raw);
-        if (!test_axis(wa, a->vertex_count, wb, b->vertex_count, n))
+        if (!test_axis(a, b, n))
             return 0;
     }
 
     /* --- Axes from face normals of b --- */
     for (int f = 0; f < b->face_count; f++) {
-        Vec3 v0 = wb[b->face_indices[f][0]];
-        Vec3 v1 = wb[b->face_indices[f][1]];
-        Vec3 v2 = wb[b->face_indices[f][2]];
+        Vec3 v0 = lb[b->faces[f][0]];
+        Vec3 v1 = lb[b->faces[f][1]];
+        Vec3 v2 = lb[b->faces[f][2]];
         Vec3 raw = vec3_cross(vec3_sub(v1, v0), vec3_sub(v2, v0));
         if (vec3_magnitude(raw) < 1e-10) continue;
         Vec3 n = vec3_normalize(raw);
-        if (!test_axis(wa, a->vertex_count, wb, b->vertex_count, n))
+        if (!test_axis(a, b, n))
             return 0;
     }
 
@@ -83,15 +85,15 @@ int sat_test_one(const PhysicsObject *a, const PhysicsObject *b) {
        (e.g., two boxes whose edges cross at an angle). */
     for (int fa = 0; fa < a->face_count; fa++) {
         for (int ea = 0; ea < 3; ea++) {
-            Vec3 ea_raw = vec3_sub(wa[a->face_indices[fa][(ea + 1) % 3]],
-                                   wa[a->face_indices[fa][ea]]);
+            Vec3 ea_raw = vec3_sub(la[a->faces[fa][(ea + 1) % 3]],
+                                   la[a->faces[fa][ea]]);
             if (vec3_magnitude(ea_raw) < 1e-10) continue;
             Vec3 ea_dir = vec3_normalize(ea_raw);
 
             for (int fb = 0; fb < b->face_count; fb++) {
                 for (int eb = 0; eb < 3; eb++) {
-                    Vec3 eb_raw = vec3_sub(wb[b->face_indices[fb][(eb + 1) % 3]],
-                                           wb[b->face_indices[fb][eb]]);
+                    Vec3 eb_raw = vec3_sub(lb[b->faces[fb][(eb + 1) % 3]],
+                                           lb[b->faces[fb][eb]]);
                     if (vec3_magnitude(eb_raw) < 1e-10) continue;
                     Vec3 eb_dir = vec3_normalize(eb_raw);
 
@@ -100,7 +102,7 @@ int sat_test_one(const PhysicsObject *a, const PhysicsObject *b) {
                         continue;  /* parallel edges — axis is degenerate */
                     Vec3 axis = vec3_normalize(cross_raw);
 
-                    if (!test_axis(wa, a->vertex_count, wb, b->vertex_count, axis))
+                    if (!test_axis(a, b, axis))
                         return 0;
                 }
             }
@@ -110,11 +112,33 @@ int sat_test_one(const PhysicsObject *a, const PhysicsObject *b) {
     return 1;  /* no separating axis found — meshes intersect */
 }
 
+int sat_test_one(const PhysicsObject *a, const PhysicsObject *b) {
+    CollisionBody va = collision_body_from_object(a);
+    CollisionBody vb = collision_body_from_object(b);
+    return sat_test_bodies(&va, &vb);
+}
+
+#ifdef _OPENMP
+/* Confirmed pairs a thread buffers before merging into the shared output. */
+#define SAT_LOCAL_PAIRS 1024
+
+/* Append a thread's buffered pairs to the shared output and empty the buffer. */
+static void merge_pairs(CollisionPair *local_buf, int *local_count,
+                        CollisionPair *pairs_out, int *out_count, int max_pairs) {
+#pragma omp critical(sat_merge_pairs)
+    {
+        for (int k = 0; k < *local_count && *out_count < max_pairs; k++)
+            pairs_out[(*out_count)++] = local_buf[k];
+    }
+    *local_count = 0;
+}
+#endif
+
 /* ------------------------------------------------------------------ */
 /* Public: sat_test_pairs                                                */
 /* ------------------------------------------------------------------ */
 
-void sat_test_pairs(const PhysicsObject *objects,
+void sat_test_pairs(const CollisionBody *bodies,
                     const CollisionPair *candidates, int num_candidates,
                     CollisionPair *pairs_out, int *out_count, int max_pairs) {
     /*
@@ -128,7 +152,7 @@ void sat_test_pairs(const PhysicsObject *objects,
 #ifdef _OPENMP
 #pragma omp parallel
     {
-        CollisionPair local_buf[1024];
+        CollisionPair local_buf[SAT_LOCAL_PAIRS];
         int local_count = 0;
 
 #pragma omp for schedule(dynamic)
@@ -137,37 +161,35 @@ void sat_test_pairs(const PhysicsObject *objects,
             int ib = candidates[k].index_b;
 
             /* Skip objects without meshes. */
-            if (objects[ia].vertex_count == 0 || objects[ib].vertex_count == 0)
+            if (bodies[ia].vertex_count == 0 || bodies[ib].vertex_count == 0)
                 continue;
-            if (objects[ia].face_count == 0 || objects[ib].face_count == 0)
+            if (bodies[ia].face_count == 0 || bodies[ib].face_count == 0)
                 continue;
 
-            if (sat_test_one(&objects[ia], &objects[ib])) {
-                if (local_count < 1024)
-                    local_buf[local_count++] =
-                        (CollisionPair){ .index_a = ia, .index_b = ib };
+            if (sat_test_bodies(&bodies[ia], &bodies[ib])) {
+                if (local_count == SAT_LOCAL_PAIRS)
+                    merge_pairs(local_buf, &local_count,
+                                pairs_out, out_count, max_pairs);
+                local_buf[local_count++] =
+                    (CollisionPair){ .index_a = ia, .index_b = ib };
             }
         }
 
-#pragma omp critical
-        {
-            for (int k = 0; k < local_count && *out_count < max_pairs; k++)
-                pairs_out[(*out_count)++] = local_buf[k];
-        }
+        merge_pairs(local_buf, &local_count, pairs_out, out_count, max_pairs);
     }
 #else
     for (int k = 0; k < num_candidates; k++) {
         int ia = candidates[k].index_a;
         int ib = candidates[k].index_b;
 
-        if (objects[ia].vertex_count == 0 || objects[ib].vertex_count == 0)
+        if (bodies[ia].vertex_count == 0 || bodies[ib].vertex_count == 0)
             continue;
-        if (objects[ia].face_count == 0 || objects[ib].face_count == 0)
+        if (bodies[ia].face_count == 0 || bodies[ib].face_count == 0)
             continue;
 
         if (*out_count >= max_pairs) break;
 
-        if (sat_test_one(&objects[ia], &objects[ib]))
+        if (sat_test_bodies(&bodies[ia], &bodies[ib]))
             pairs_out[(*out_count)++] =
                 (CollisionPair){ .index_a = ia, .index_b = ib };
     }
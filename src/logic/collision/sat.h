@@ -27,8 +27,8 @@ extern "C" {
  * If any axis produces non-overlapping projection intervals the shapes are
  * separated and the function returns 0 immediately (early exit).
  *
- * Both objects must have vertex_count > 0 and face_count > 0. If either has
- * no mesh the result is undefined.
+ * Both objects must reference a registered mesh. If either has no mesh the
+ * result is undefined.
  *
  * CONVEX GEOMETRY ONLY: SAT is only correct for convex meshes. Concave
  * geometry will produce false negatives (missed collisions). Pre-process
@@ -40,27 +40,36 @@ extern "C" {
  */
 int sat_test_one(const PhysicsObject *a, const PhysicsObject *b);
 
+/**
+ * @brief sat_test_one() for two geometry views.
+ *
+ * @param a  First body.
+ * @param b  Second body.
+ * @return   1 if the meshes intersect, 0 if they are separated.
+ */
+int sat_test_bodies(const CollisionBody *a, const CollisionBody *b);
+
 /**
  * @brief Run SAT over an array of candidate pairs and write confirmed hits.
  *
  * Iterates candidates[0..num_candidates-1] sequentially with OpenMP
  * parallelism. Confirmed pairs are written to pairs_out up to max_pairs.
  *
- * @param objects        Flat array of PhysicsObject.
+ * @param bodies         Geometry views, indexed by the candidate indices.
  * @param candidates     Broad-phase candidate pairs (from octree_query_pairs).
  * @param num_candidates Length of candidates[].
  * @param pairs_out      Output buffer for confirmed collisions.
  * @param out_count      In/out: current fill level of pairs_out.
  * @param max_pairs      Capacity of pairs_out.
  */
-void sat_test_pairs(const PhysicsObject *objects,
+void sat_test_pairs(const CollisionBody *bodies,
                     const CollisionPair *candidates, int num_candidates,
                     CollisionPair *pairs_out, int *out_count, int max_pairs);
 
 /* TODO:
  * -- Fortran optimisation hook (not implemented) --
  *
- * Future: the project_interval inner loop (dot product of ≤64 vertices onto
+ * Future: the project_interval inner loop (dot product of a mesh's vertices onto
  * one axis) is a tight reduction ideal for Fortran auto-vectorisation with -O3.
  *
  * Signature reserved (bind(C, name="sat_project_f")):
@@ -0,0 +1,333 @@
+/**
+ * @file spatial_hash.c
+ * @brief Hashed uniform-grid broad phase implementation.
+ *
+ * @author Steven Kight
+ */
+
+#include "spatial_hash.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void spatial_hash_init(SpatialHash *grid) {
+    memset(grid, 0, sizeof(*grid));
+}
+
+void spatial_hash_free(SpatialHash *grid) {
+    free(grid->boxes);
+    free(grid->offsets);
+    free(grid->extents);
+    free(grid->entries);
+    free(grid->by_body);
+    free(grid->bucket_start);
+    free(grid->chunk_offsets);
+    free(grid->large);
+    spatial_hash_init(grid);
+}
+
+/* ------------------------------------------------------------------ */
+/* Storage                                                                */
+/* ------------------------------------------------------------------ */
+
+static int reserve_bodies(SpatialHash *grid, int count) {
+    if (count <= grid->body_capacity) return 0;
+
+    const size_t n = (size_t)count;
+    AABB   *boxes   = malloc(n * sizeof(*boxes));
+    int    *offsets = malloc((n + 1) * sizeof(*offsets));
+    double *extents = malloc(n * sizeof(*extents));
+    int    *large   = malloc(n * sizeof(*large));
+    if (!boxes || !offsets || !extents || !large) {
+        free(boxes); free(offsets); free(extents); free(large);
+        return -1;
+    }
+    free(grid->boxes); free(grid->offsets); free(grid->extents); free(grid->large);
+    grid->boxes   = boxes;
+    grid->offsets = offsets;
+    grid->extents = extents;
+    grid->large   = large;
+    grid->body_capacity = count;
+    return 0;
+}
+
+static int reserve_entries(SpatialHash *grid, int entries, int buckets) {
+    if (entries > grid->entry_capacity) {
+        int capacity = grid->entry_capacity > 0 ? grid->entry_capacity : 1024;
+        while (capacity < entries) capacity *= 2;
+
+        SpatialHashEntry *sorted  = malloc((size_t)capacity * sizeof(*sorted));
+        SpatialHashEntry *by_body = malloc((size_t)capacity * sizeof(*by_body));
+        if (!sorted || !by_body) {
+            free(sorted); free(by_body);
+            return -1;
+        }
+        free(grid->entries); free(grid->by_body);
+        grid->entries = sorted;
+        grid->by_body = by_body;
+        grid->entry_capacity = capacity;
+    }
+    if (buckets > grid->bucket_capacity) {
+        const size_t chunks = (size_t)buckets / SPATIAL_HASH_CHUNK + 2;
+        int *start  = malloc(((size_t)buckets + 1) * sizeof(*start));
+        int *chunk  = malloc(chunks * sizeof(*chunk));
+        if (!start || !chunk) {
+            free(start); free(chunk);
+            return -1;
+        }
+        free(grid->bucket_start); free(grid->chunk_offsets);
+        grid->bucket_start    = start;
+        grid->chunk_offsets   = chunk;
+        grid->bucket_capacity = buckets;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Cells                                                                  */
+/* ------------------------------------------------------------------ */
+
+/* Cell coordinate of @p x; clamped so far-flung bodies share edge cells. */
+static int cell_coord(double x, double inv_size) {
+    double c = floor(x * inv_size);
+    if (c < INT_MIN) return INT_MIN;
+    if (c > INT_MAX) return INT_MAX;
+    return (int)c;
+}
+
+/* Teschner et al. (2003) spatial hash of a cell into @p mask + 1 buckets. */
+static int cell_bucket(int x, int y, int z, int mask) {
+    unsigned h = (unsigned)x * 73856093u ^ (unsigned)y * 19349663u ^ (unsigned)z * 83492791u;
+    return (int)(h & (unsigned)mask);
+}
+
+/* Inclusive range of cells covered by @p box. */
+static void cell_range(const AABB *box, double inv_size, int lo[3], int hi[3]) {
+    lo[0] = cell_coord(box->min.x, inv_size);
+    lo[1] = cell_coord(box->min.y, inv_size);
+    lo[2] = cell_coord(box->min.z, inv_size);
+    hi[0] = cell_coord(box->max.x, inv_size);
+    hi[1] = cell_coord(box->max.y, inv_size);
+    hi[2] = cell_coord(box->max.z, inv_size);
+}
+
+/* Cells covered by @p box, or SPATIAL_HASH_MAX_CELLS + 1 if more. */
+static int cell_total(const AABB *box, double inv_size) {
+    int lo[3], hi[3];
+    cell_range(box, inv_size, lo, hi);
+    long long total = 1;
+    for (int a = 0; a < 3; a++) {
+        total *= (long long)hi[a] - lo[a] + 1;
+        if (total > SPATIAL_HASH_MAX_CELLS) return SPATIAL_HASH_MAX_CELLS + 1;
+    }
+    return (int)total;
+}
+
+/* k-th smallest of @p values[0..n-1] (reorders them). */
+static double select_kth(double *values, int n, int k) {
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        const double pivot = values[lo + (hi - lo) / 2];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (values[i] < pivot) i++;
+            while (values[j] > pivot) j--;
+            if (i <= j) {
+                double t = values[i]; values[i] = values[j]; values[j] = t;
+                i++; j--;
+            }
+        }
+        if (k <= j)      hi = j;
+        else if (k >= i) lo = i;
+        else             break;
+    }
+    return values[k];
+}
+
+/* ------------------------------------------------------------------ */
+/* Build                                                                  */
+/* ------------------------------------------------------------------ */
+
+int spatial_hash_build(SpatialHash *grid, const CollisionBody *bodies, int count) {
+    grid->count = 0;
+    grid->entry_count = 0;
+    grid->bucket_count = 0;
+    grid->large_count = 0;
+    if (count <= 0) return 0;
+    if (reserve_bodies(grid, count) != 0) return -1;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const AABB box = aabb_from_body(&bodies[i]);
+        grid->boxes[i] = box;
+        grid->extents[i] = fmax(box.max.x - box.min.x,
+                                fmax(box.max.y - box.min.y, box.max.z - box.min.z));
+    }
+
+    double median = select_kth(grid->extents, count, count / 2);
+    grid->cell_size = median > 0.0 ? SPATIAL_HASH_CELL_SCALE * median : 1.0;
+    const double inv_size = 1.0 / grid->cell_size;
+
+    // Entries per body; large bodies take none and go to their own list.
+    int *offsets = grid->offsets;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const int cells = cell_total(&grid->boxes[i], inv_size);
+        offsets[i] = cells > SPATIAL_HASH_MAX_CELLS ? 0 : cells;
+    }
+    long long total = 0;
+    for (int i = 0; i < count; i++) {
+        const int cells = offsets[i];
+        if (cells == 0) grid->large[grid->large_count++] = i;
+        offsets[i] = (int)total;
+        total += cells;
+    }
+    offsets[count] = (int)total;
+    if (total > INT_MAX / 2) return -1;
+
+    int buckets = 1;
+    while (buckets < total) buckets *= 2;
+    if (reserve_entries(grid, (int)total, buckets) != 0) return -1;
+
+    // Each body writes its own slice of entries.
+    const int mask = buckets - 1;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        if (offsets[i + 1] == offsets[i]) continue;
+        int lo[3], hi[3];
+        cell_range(&grid->boxes[i], inv_size, lo, hi);
+        SpatialHashEntry *e = &grid->by_body[offsets[i]];
+        for (int x = lo[0]; x <= hi[0]; x++)
+            for (int y = lo[1]; y <= hi[1]; y++)
+                for (int z = lo[2]; z <= hi[2]; z++)
+                    *e++ = (SpatialHashEntry){ { x, y, z }, i, cell_bucket(x, y, z, mask) };
+    }
+
+    // Counting sort by bucket: stable, so each bucket lists bodies ascending.
+    int *start = grid->bucket_start;
+    memset(start, 0, ((size_t)buckets + 1) * sizeof(*start));
+    for (int k = 0; k < total; k++)
+        start[grid->by_body[k].bucket + 1]++;
+    for (int b = 0; b < buckets; b++)
+        start[b + 1] += start[b];
+    for (int k = 0; k < total; k++)
+        grid->entries[start[grid->by_body[k].bucket]++] = grid->by_body[k];
+    memmove(start + 1, start, (size_t)buckets * sizeof(*start));
+    start[0] = 0;
+
+    grid->count        = count;
+    grid->entry_count  = (int)total;
+    grid->bucket_count = buckets;
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Query                                                                  */
+/* ------------------------------------------------------------------ */
+
+/* 1 if the minimum corner of the boxes' intersection lies in @p cell. */
+static int owns_pair(const AABB *a, const AABB *b, const int cell[3], double inv_size) {
+    return cell_coord(fmax(a->min.x, b->min.x), inv_size) == cell[0] &&
+           cell_coord(fmax(a->min.y, b->min.y), inv_size) == cell[1] &&
+           cell_coord(fmax(a->min.z, b->min.z), inv_size) == cell[2];
+}
+
+/*
+ * Pairs owned by the cells in buckets [first, last). Writes them to @p out
+ * when non-NULL; returns their number either way. Bodies ascend within a
+ * bucket, so every pair comes out with index_a < index_b.
+ */
+static int bucket_pairs(const SpatialHash *grid, int first, int last, CollisionPair *out) {
+    const double inv_size = 1.0 / grid->cell_size;
+    const SpatialHashEntry *entries = grid->entries;
+    int n = 0;
+
+    for (int b = first; b < last; b++) {
+        const int bucket_end = grid->bucket_start[b + 1];
+        for (int m = grid->bucket_start[b]; m < bucket_end; m++) {
+            const SpatialHashEntry *e = &entries[m];
+            for (int k = m + 1; k < bucket_end; k++) {
+                const SpatialHashEntry *f = &entries[k];
+                if (f->cell[0] != e->cell[0] || f->cell[1] != e->cell[1] ||
+                    f->cell[2] != e->cell[2])
+                    continue;  // another cell in the same bucket
+                const AABB *a = &grid->boxes[e->body], *c = &grid->boxes[f->body];
+                if (aabb_overlaps(*a, *c) && owns_pair(a, c, e->cell, inv_size)) {
+                    if (out) out[n] = (CollisionPair){ .index_a = e->body, .index_b = f->body };
+                    n++;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+/*
+ * Pairs of body @p i with the bodies kept out of the grid: every body pairs
+ * with each large body, and large bodies with later large bodies.
+ */
+static int large_pairs(const SpatialHash *grid, int i, CollisionPair *out) {
+    const int in_grid = grid->offsets[i + 1] > grid->offsets[i];
+    int n = 0;
+    for (int l = 0; l < grid->large_count; l++) {
+        const int j = grid->large[l];
+        if (j == i || (!in_grid && j < i)) continue;
+        if (!aabb_overlaps(grid->boxes[i], grid->boxes[j])) continue;
+        if (out) out[n] = (CollisionPair){ .index_a = i < j ? i : j,
+                                           .index_b = i < j ? j : i };
+        n++;
+    }
+    return n;
+}
+
+int spatial_hash_query_pairs(SpatialHash *grid, CollisionPairBuffer *out) {
+    out->count = 0;
+    if (grid->count == 0) return 0;
+
+    // Count each chunk's pairs, then write them at its offset.
+    const int buckets = grid->bucket_count;
+    const int chunks  = (buckets + SPATIAL_HASH_CHUNK - 1) / SPATIAL_HASH_CHUNK;
+    int *chunk_offsets = grid->chunk_offsets;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < chunks; c++) {
+        const int first = c * SPATIAL_HASH_CHUNK;
+        const int last  = first + SPATIAL_HASH_CHUNK < buckets ? first + SPATIAL_HASH_CHUNK : buckets;
+        chunk_offsets[c] = bucket_pairs(grid, first, last, NULL);
+    }
+
+    long long total = 0;
+    for (int c = 0; c < chunks; c++) {
+        const int n = chunk_offsets[c];
+        chunk_offsets[c] = (int)total;
+        total += n;
+    }
+
+    // Large bodies are rare; their pairs follow the grid's, body by body.
+    const long long grid_total = total;
+    if (grid->large_count > 0) {
+        for (int i = 0; i < grid->count; i++)
+            total += large_pairs(grid, i, NULL);
+    }
+
+    if (total > INT_MAX || collision_pairs_reserve(out, (int)total) != 0)
+        return -1;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < chunks; c++) {
+        const int first = c * SPATIAL_HASH_CHUNK;
+        const int last  = first + SPATIAL_HASH_CHUNK < buckets ? first + SPATIAL_HASH_CHUNK : buckets;
+        bucket_pairs(grid, first, last, &out->pairs[chunk_offsets[c]]);
+    }
+
+    int n = (int)grid_total;
+    if (grid->large_count > 0) {
+        for (int i = 0; i < grid->count; i++)
+            n += large_pairs(grid, i, &out->pairs[n]);
+    }
+
+    out->count = n;
+    return out->count;
+}
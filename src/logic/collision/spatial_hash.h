@@ -0,0 +1,110 @@
+/**
+ * @file spatial_hash.h
+ * @brief Hashed uniform-grid broad phase for similarly sized bodies.
+ *
+ * Space is divided into cubic cells whose side is SPATIAL_HASH_CELL_SCALE
+ * times the median of the bodies' largest AABB extents, so a typical body
+ * covers a few cells. Each body is entered into every cell its AABB touches;
+ * cells are hashed into a bucket table, so only occupied cells cost memory
+ * and the grid is unbounded. Two overlapping boxes always share the cell
+ * containing the minimum corner of their intersection, and a pair is
+ * reported only from that cell — each unique pair once, with no
+ * deduplication set.
+ *
+ * Bodies spanning more than SPATIAL_HASH_MAX_CELLS cells are kept out of the
+ * grid and tested against every other body, so an occasional large body
+ * does not flood it.
+ *
+ * Unlike the octree there is no hierarchy to descend: the build is a flat
+ * pass over bodies and the query a flat pass over buckets, both parallel.
+ * Reports exactly the pairs whose AABBs overlap (touching counts).
+ *
+ * @author Steven Kight
+ */
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "aabb.h"
+#include "collision.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPATIAL_HASH_CELL_SCALE 2.0 /* cell side / median body extent */
+#define SPATIAL_HASH_MAX_CELLS 64   /* cells a body may cover before it is kept out of the grid */
+#define SPATIAL_HASH_CHUNK 1024     /* buckets per parallel query task */
+
+/** One body's entry in one cell. */
+typedef struct {
+    int cell[3]; /**< Integer cell coordinates. */
+    int body;    /**< Body index. */
+    int bucket;  /**< Hash of cell into the bucket table. */
+} SpatialHashEntry;
+
+/**
+ * @brief Grid and scratch buffers, reused across builds.
+ *
+ * Initialise with spatial_hash_init() and release with spatial_hash_free().
+ */
+typedef struct SpatialHash {
+    double cell_size;          /**< Cell side chosen by the last build (m). */
+    int    count;              /**< Bodies in the last build. */
+    int    body_capacity;      /**< Bodies the per-body arrays can hold. */
+    AABB  *boxes;              /**< World-space AABB of each body. */
+    int   *offsets;            /**< count + 1 offsets of each body's slice of by_body. */
+    double *extents;           /**< Scratch for the median extent. */
+
+    SpatialHashEntry *entries; /**< Entries grouped by bucket, bodies ascending. */
+    SpatialHashEntry *by_body; /**< The same entries in body order. */
+    int    entry_count;
+    int    entry_capacity;
+
+    int   *bucket_start;       /**< bucket_count + 1 offsets into entries. */
+    int   *chunk_offsets;      /**< Scratch: first pair of each bucket chunk. */
+    int    bucket_count;       /**< Power of two, at least entry_count. */
+    int    bucket_capacity;
+
+    int   *large;              /**< Bodies kept out of the grid. */
+    int    large_count;
+} SpatialHash;
+
+/** @brief Initialise an empty grid (no allocation until first build). */
+void spatial_hash_init(SpatialHash *grid);
+
+/** @brief Release all buffers and reset @p grid. */
+void spatial_hash_free(SpatialHash *grid);
+
+/**
+ * @brief Rebuild the grid over @p bodies.
+ *
+ * Chooses the cell size from the median largest AABB extent (1 m when the
+ * median body is a point), then enters each body into the cells its AABB
+ * covers.
+ *
+ * @param grid    Grid (initialised; fully reset).
+ * @param bodies  Geometry views, one per body.
+ * @param count   Number of bodies.
+ * @return        0 on success, -1 on allocation failure (the grid is empty).
+ */
+int spatial_hash_build(SpatialHash *grid, const CollisionBody *bodies, int count);
+
+/**
+ * @brief Collect every AABB-overlapping pair from the grid.
+ *
+ * Pairs are counted per chunk of buckets in parallel, then written to
+ * disjoint ranges of @p out, so the result is deterministic.
+ *
+ * @param grid  Grid built by spatial_hash_build(); its scratch is reused.
+ * @param out   Receives the pairs (index_a < index_b); grown as needed.
+ * @return      out->count, the number of candidate pairs, or -1 if
+ *              @p out (or the scratch) cannot grow to hold them all.
+ */
+int spatial_hash_query_pairs(SpatialHash *grid, CollisionPairBuffer *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPATIAL_HASH_H */
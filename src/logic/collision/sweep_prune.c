@@ -0,0 +1,290 @@
+/**
+ * @file sweep_prune.c
+ * @brief Sweep-and-prune broad phase implementation.
+ *
+ * @author Steven Kight
+ */
+
+#include "sweep_prune.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Slots allocated for the first pair set. */
+#define SWEEP_INITIAL_PAIRS 1024
+
+/* Pair-set slot markers; no canonical pair packs to either value. */
+#define PAIR_KEY_EMPTY (~0ULL)
+#define PAIR_KEY_TOMB  (~0ULL - 1)
+
+#define ENDPOINT_BODY(tag)   ((tag) >> 1)
+#define ENDPOINT_IS_MAX(tag) ((tag) & 1)
+
+void sweep_prune_init(SweepPrune *sap) {
+    memset(sap, 0, sizeof(*sap));
+    sap->count = -1;
+}
+
+void sweep_prune_free(SweepPrune *sap) {
+    for (int a = 0; a < 3; a++)
+        free(sap->endpoints[a]);
+    free(sap->boxes);
+    free(sap->pair_keys);
+    sweep_prune_init(sap);
+}
+
+/* ------------------------------------------------------------------ */
+/* Pair set                                                               */
+/* ------------------------------------------------------------------ */
+
+static unsigned long long pair_key(int ia, int ib) {
+    if (ia > ib) { int t = ia; ia = ib; ib = t; }  /* canonical: smaller index first */
+    return ((unsigned long long)(unsigned)ia << 32) | (unsigned)ib;
+}
+
+/* Fibonacci hash of @p key into a table of @p capacity (a power of two) slots. */
+static int pair_slot(unsigned long long key, int capacity) {
+    return (int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+/* Insert into a table known to contain neither @p key nor tombstones. */
+static void pair_place(unsigned long long *keys, int capacity, unsigned long long key) {
+    int slot = pair_slot(key, capacity);
+    while (keys[slot] != PAIR_KEY_EMPTY)
+        slot = (slot + 1) & (capacity - 1);
+    keys[slot] = key;
+}
+
+/*
+ * Rehash into a table of at least @p min_capacity slots with no tombstones.
+ * Returns -1 on allocation failure (the set is unchanged).
+ */
+static int pair_rehash(SweepPrune *sap, int min_capacity) {
+    int capacity = SWEEP_INITIAL_PAIRS;
+    while (capacity < min_capacity) capacity *= 2;
+
+    unsigned long long *keys = malloc((size_t)capacity * sizeof(*keys));
+    if (!keys) return -1;
+    memset(keys, 0xff, (size_t)capacity * sizeof(*keys));
+
+    for (int s = 0; s < sap->pair_capacity; s++) {
+        unsigned long long key = sap->pair_keys[s];
+        if (key != PAIR_KEY_EMPTY && key != PAIR_KEY_TOMB)
+            pair_place(keys, capacity, key);
+    }
+    free(sap->pair_keys);
+    sap->pair_keys       = keys;
+    sap->pair_capacity   = capacity;
+    sap->pair_tombstones = 0;
+    return 0;
+}
+
+/* Add the pair (ia, ib) if absent. A failed resize drops the pair and marks the set lost. */
+static void pair_add(SweepPrune *sap, int ia, int ib) {
+    /* Keep live entries and tombstones at most half the table. */
+    if (2 * (sap->pair_count + sap->pair_tombstones + 1) > sap->pair_capacity &&
+            pair_rehash(sap, 4 * (sap->pair_count + 1)) != 0) {
+        sap->pairs_lost = 1;
+        return;
+    }
+
+    const unsigned long long key = pair_key(ia, ib);
+    const int mask = sap->pair_capacity - 1;
+    int tomb = -1;
+    for (int slot = pair_slot(key, sap->pair_capacity);; slot = (slot + 1) & mask) {
+        unsigned long long k = sap->pair_keys[slot];
+        if (k == key) return;
+        if (k == PAIR_KEY_TOMB && tomb < 0) tomb = slot;
+        if (k == PAIR_KEY_EMPTY) {
+            if (tomb >= 0) {
+                slot = tomb;
+                sap->pair_tombstones--;
+            }
+            sap->pair_keys[slot] = key;
+            sap->pair_count++;
+            return;
+        }
+    }
+}
+
+/* Remove the pair (ia, ib) if present. */
+static void pair_remove(SweepPrune *sap, int ia, int ib) {
+    if (sap->pair_capacity == 0) return;
+
+    const unsigned long long key = pair_key(ia, ib);
+    const int mask = sap->pair_capacity - 1;
+    for (int slot = pair_slot(key, sap->pair_capacity);; slot = (slot + 1) & mask) {
+        unsigned long long k = sap->pair_keys[slot];
+        if (k == PAIR_KEY_EMPTY) return;
+        if (k == key) {
+            sap->pair_keys[slot] = PAIR_KEY_TOMB;
+            sap->pair_count--;
+            sap->pair_tombstones++;
+            return;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Endpoint lists                                                         */
+/* ------------------------------------------------------------------ */
+
+static double axis_min(const AABB *box, int axis) {
+    return axis == 0 ? box->min.x : axis == 1 ? box->min.y : box->min.z;
+}
+
+static double axis_max(const AABB *box, int axis) {
+    return axis == 0 ? box->max.x : axis == 1 ? box->max.y : box->max.z;
+}
+
+/*
+ * Strict list order: by value, with a min before a max at equal values so
+ * that touching boxes interleave — matching aabb_overlaps().
+ */
+static int endpoint_before(const SweepEndpoint *a, const SweepEndpoint *b) {
+    if (a->value != b->value) return a->value < b->value;
+    return !ENDPOINT_IS_MAX(a->tag) && ENDPOINT_IS_MAX(b->tag);
+}
+
+static int endpoint_cmp(const void *pa, const void *pb) {
+    const SweepEndpoint *a = pa, *b = pb;
+    if (endpoint_before(a, b)) return -1;
+    if (endpoint_before(b, a)) return 1;
+    return 0;
+}
+
+static void refresh_values(SweepPrune *sap, int axis) {
+    SweepEndpoint *list = sap->endpoints[axis];
+    const int n = 2 * sap->count;
+
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < n; k++) {
+        const AABB *box = &sap->boxes[ENDPOINT_BODY(list[k].tag)];
+        list[k].value = ENDPOINT_IS_MAX(list[k].tag) ? axis_max(box, axis)
+                                                    : axis_min(box, axis);
+    }
+}
+
+/*
+ * Insertion-sort one axis. Moving endpoint e left past f changes whether the
+ * two bodies interleave on this axis only when one is a min and the other a
+ * max: a min passing a max starts an overlap on this axis (kept if the boxes
+ * now overlap on all three), a max passing a min ends one.
+ */
+static void sort_axis(SweepPrune *sap, int axis) {
+    SweepEndpoint *list = sap->endpoints[axis];
+    const int n = 2 * sap->count;
+
+    for (int k = 1; k < n; k++) {
+        SweepEndpoint e = list[k];
+        int m = k - 1;
+        while (m >= 0 && endpoint_before(&e, &list[m])) {
+            const SweepEndpoint *f = &list[m];
+            const int eb = ENDPOINT_BODY(e.tag), fb = ENDPOINT_BODY(f->tag);
+            if (eb != fb) {
+                if (!ENDPOINT_IS_MAX(e.tag) && ENDPOINT_IS_MAX(f->tag)) {
+                    if (aabb_overlaps(sap->boxes[eb], sap->boxes[fb]))
+                        pair_add(sap, eb, fb);
+                } else if (ENDPOINT_IS_MAX(e.tag) && !ENDPOINT_IS_MAX(f->tag)) {
+                    pair_remove(sap, eb, fb);
+                }
+            }
+            list[m + 1] = list[m];
+            m--;
+        }
+        list[m + 1] = e;
+        sap->swaps += k - 1 - m;
+    }
+}
+
+/* Fresh lists and pair set for sap->count bodies. */
+static void rebuild(SweepPrune *sap) {
+    const int n = 2 * sap->count;
+    for (int a = 0; a < 3; a++) {
+        SweepEndpoint *list = sap->endpoints[a];
+        for (int k = 0; k < n; k++)
+            list[k].tag = k;  /* body k/2, max when k is odd */
+        refresh_values(sap, a);
+        qsort(list, (size_t)n, sizeof(*list), endpoint_cmp);
+    }
+
+    if (sap->pair_capacity > 0)
+        memset(sap->pair_keys, 0xff, (size_t)sap->pair_capacity * sizeof(*sap->pair_keys));
+    sap->pair_count      = 0;
+    sap->pair_tombstones = 0;
+    sap->pairs_lost      = 0;
+
+    /* One sweep along x: each body pairs with the bodies whose min lies
+       inside its interval. */
+    const SweepEndpoint *list = sap->endpoints[0];
+    for (int k = 0; k < n; k++) {
+        if (ENDPOINT_IS_MAX(list[k].tag)) continue;
+        const int body = ENDPOINT_BODY(list[k].tag);
+        for (int m = k + 1; m < n && ENDPOINT_BODY(list[m].tag) != body; m++) {
+            if (ENDPOINT_IS_MAX(list[m].tag)) continue;
+            const int other = ENDPOINT_BODY(list[m].tag);
+            if (aabb_overlaps(sap->boxes[body], sap->boxes[other]))
+                pair_add(sap, body, other);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public API                                                             */
+/* ------------------------------------------------------------------ */
+
+int sweep_prune_update(SweepPrune *sap, const CollisionBody *bodies, int count) {
+    if (count < 0) count = 0;
+    if (count > sap->capacity) {
+        sweep_prune_free(sap);
+        const size_t n = (size_t)count;
+        sap->boxes = malloc(n * sizeof(*sap->boxes));
+        for (int a = 0; a < 3; a++)
+            sap->endpoints[a] = malloc(2 * n * sizeof(SweepEndpoint));
+        if (!sap->boxes || !sap->endpoints[0] || !sap->endpoints[1] || !sap->endpoints[2]) {
+            sweep_prune_free(sap);
+            return -1;
+        }
+        sap->capacity = count;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++)
+        sap->boxes[i] = aabb_from_body(&bodies[i]);
+
+    sap->swaps = 0;
+    if (count != sap->count) {
+        sap->count = count;
+        rebuild(sap);
+    } else {
+        for (int a = 0; a < 3; a++) {
+            refresh_values(sap, a);
+            sort_axis(sap, a);
+        }
+    }
+
+    // A dropped pair would stay missing; start over on the next update.
+    if (sap->pairs_lost) {
+        sap->count = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int sweep_prune_query_pairs(const SweepPrune *sap, CollisionPairBuffer *out) {
+    out->count = 0;
+    if (sap->pair_count == 0)
+        return 0;
+    if (collision_pairs_reserve(out, sap->pair_count) != 0)
+        return -1;
+
+    for (int s = 0; s < sap->pair_capacity; s++) {
+        unsigned long long key = sap->pair_keys[s];
+        if (key == PAIR_KEY_EMPTY || key == PAIR_KEY_TOMB) continue;
+        out->pairs[out->count++] = (CollisionPair){
+            .index_a = (int)(key >> 32),
+            .index_b = (int)(key & 0xffffffffu),
+        };
+    }
+    return out->count;
+}
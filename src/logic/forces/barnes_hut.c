@@ -0,0 +1,309 @@
+/**
+ * @file barnes_hut.c
+ * @brief Barnes–Hut tree construction, mass moments, and force walk.
+ *
+ * @author Steven Kight
+ */
+
+#include "barnes_hut.h"
+#include "gravity.h"
+#include "softening.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/* Each pop pushes at most 8 children, so a depth-first walk never holds more
+   than 7 entries per level plus the 8 children of the deepest node. */
+#define BH_STACK_SIZE (7 * BH_MAX_DEPTH + 8)
+
+/* ------------------------------------------------------------------ */
+/* Internal helpers                                                      */
+/* ------------------------------------------------------------------ */
+
+static int alloc_node(BHTree *tree, Vec3 centre, double half_size, int depth) {
+    if (tree->node_count >= tree->node_capacity) {
+        int capacity = tree->node_capacity > 0 ? tree->node_capacity * 2 : 1024;
+        BHNode *grown = realloc(tree->nodes, capacity * sizeof(BHNode));
+        if (!grown)
+            return BH_NULL;
+        tree->nodes         = grown;
+        tree->node_capacity = capacity;
+    }
+
+    int idx = tree->node_count++;
+    BHNode *n = &tree->nodes[idx];
+    n->centre     = centre;
+    n->half_size  = half_size;
+    n->com        = (Vec3){ 0.0, 0.0, 0.0 };
+    n->mass       = 0.0;
+    n->first_body = BH_NULL;
+    n->is_leaf    = 1;
+    n->depth      = depth;
+    for (int c = 0; c < 8; c++)
+        n->children[c] = BH_NULL;
+    return idx;
+}
+
+/* Octant index of p relative to centre: bit0=x, bit1=y, bit2=z (set = positive half). */
+static int octant_of(Vec3 centre, Vec3 p) {
+    return (p.x >= centre.x ? 1 : 0) |
+           (p.y >= centre.y ? 2 : 0) |
+           (p.z >= centre.z ? 4 : 0);
+}
+
+/* Return the child of node_idx in octant c, allocating it if absent. */
+static int child_for(BHTree *tree, int node_idx, int c) {
+    int ci = tree->nodes[node_idx].children[c];
+    if (ci != BH_NULL)
+        return ci;
+
+    /* Copy what we need before alloc_node() may move the pool. */
+    Vec3   centre  = tree->nodes[node_idx].centre;
+    double quarter = tree->nodes[node_idx].half_size * 0.5;
+    int    depth   = tree->nodes[node_idx].depth + 1;
+
+    centre.x += (c & 1) ? quarter : -quarter;
+    centre.y += (c & 2) ? quarter : -quarter;
+    centre.z += (c & 4) ? quarter : -quarter;
+
+    ci = alloc_node(tree, centre, quarter, depth);
+    if (ci != BH_NULL)
+        tree->nodes[node_idx].children[c] = ci;
+    return ci;
+}
+
+/* Descend from the root and place body_idx in a leaf, splitting occupied
+   leaves on the way. Returns -1 on allocation failure. */
+static int insert_body(BHTree *tree, const PhysicsObject *objects, int body_idx) {
+    Vec3 p = objects[body_idx].position;
+    int node_idx = 0;
+
+    for (;;) {
+        BHNode *node = &tree->nodes[node_idx];
+
+        if (node->is_leaf) {
+            if (node->first_body == BH_NULL || node->depth >= BH_MAX_DEPTH) {
+                /* Empty leaf, or coincident bodies at max depth: chain it. */
+                tree->next_body[body_idx] = node->first_body;
+                node->first_body = body_idx;
+                return 0;
+            }
+
+            /* Occupied leaf above max depth holds exactly one body — push it
+               down one level and keep descending with the new body. */
+            int resident = node->first_body;
+            node->first_body = BH_NULL;
+            node->is_leaf    = 0;
+
+            int c  = octant_of(node->centre, objects[resident].position);
+            int ci = child_for(tree, node_idx, c);
+            if (ci == BH_NULL)
+                return -1;
+            tree->nodes[ci].first_body = resident;
+            tree->next_body[resident]  = BH_NULL;
+            continue;
+        }
+
+        int ci = child_for(tree, node_idx, octant_of(node->centre, p));
+        if (ci == BH_NULL)
+            return -1;
+        node_idx = ci;
+    }
+}
+
+/* Children are always allocated after their parent, so a reverse sweep over
+   the pool visits every child before its parent. */
+static void compute_moments(BHTree *tree, const PhysicsObject *objects) {
+    for (int n = tree->node_count - 1; n >= 0; n--) {
+        BHNode *node = &tree->nodes[n];
+        double mass = 0.0, mx = 0.0, my = 0.0, mz = 0.0;
+
+        if (node->is_leaf) {
+            for (int b = node->first_body; b != BH_NULL; b = tree->next_body[b]) {
+                double m = objects[b].mass;
+                mass += m;
+                mx   += m * objects[b].position.x;
+                my   += m * objects[b].position.y;
+                mz   += m * objects[b].position.z;
+            }
+        } else {
+            for (int c = 0; c < 8; c++) {
+                int ci = node->children[c];
+                if (ci == BH_NULL) continue;
+                const BHNode *child = &tree->nodes[ci];
+                mass += child->mass;
+                mx   += child->mass * child->com.x;
+                my   += child->mass * child->com.y;
+                mz   += child->mass * child->com.z;
+            }
+        }
+
+        node->mass = mass;
+        node->com  = mass > 0.0 ? (Vec3){ mx / mass, my / mass, mz / mass }
+                                : node->centre;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: tree lifecycle                                                */
+/* ------------------------------------------------------------------ */
+
+void bh_tree_init(BHTree *tree) {
+    tree->nodes         = NULL;
+    tree->node_count    = 0;
+    tree->node_capacity = 0;
+    tree->next_body     = NULL;
+    tree->body_capacity = 0;
+}
+
+void bh_tree_free(BHTree *tree) {
+    free(tree->nodes);
+    free(tree->next_body);
+    bh_tree_init(tree);
+}
+
+int bh_tree_build(BHTree *tree, const PhysicsObject *objects, int count) {
+    tree->node_count = 0;
+
+    if (count > tree->body_capacity) {
+        int *grown = realloc(tree->next_body, count * sizeof(int));
+        if (!grown)
+            return -1;
+        tree->next_body     = grown;
+        tree->body_capacity = count;
+    }
+
+    if (count == 0)
+        return alloc_node(tree, (Vec3){ 0.0, 0.0, 0.0 }, 0.0, 0) == BH_NULL ? -1 : 0;
+
+    /* Bounding cube over all positions. */
+    Vec3 lo = objects[0].position, hi = objects[0].position;
+    for (int i = 1; i < count; i++) {
+        Vec3 p = objects[i].position;
+        if (p.x < lo.x) lo.x = p.x;
+        if (p.y < lo.y) lo.y = p.y;
+        if (p.z < lo.z) lo.z = p.z;
+        if (p.x > hi.x) hi.x = p.x;
+        if (p.y > hi.y) hi.y = p.y;
+        if (p.z > hi.z) hi.z = p.z;
+    }
+
+    Vec3 centre = { (lo.x + hi.x) * 0.5, (lo.y + hi.y) * 0.5, (lo.z + hi.z) * 0.5 };
+    double half = fmax(hi.x - lo.x, fmax(hi.y - lo.y, hi.z - lo.z)) * 0.5;
+
+    /* Small padding keeps bodies on the max faces strictly inside the cube. */
+    half = half * (1.0 + 1e-9) + 1e-9;
+
+    if (alloc_node(tree, centre, half, 0) == BH_NULL)  /* root is always node 0 */
+        return -1;
+
+    for (int i = 0; i < count; i++) {
+        if (insert_body(tree, objects, i) != 0)
+            return -1;
+    }
+
+    compute_moments(tree, objects);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: force walk                                                    */
+/* ------------------------------------------------------------------ */
+
+void bh_tree_forces(const BHTree *tree, const PhysicsObject *objects,
+                    int count, double theta, GravitySoftening softening,
+                    double length, Vec3 *forces_out) {
+    const double g      = GRAVITATIONAL_CONSTANT;
+    const double theta2 = theta * theta;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < count; i++) {
+        const Vec3   pi  = objects[i].position;
+        const double gmi = g * objects[i].mass;
+        const double eps_i = softening_length_of(&objects[i], length);
+        double fx = 0.0, fy = 0.0, fz = 0.0;
+
+        int stack[BH_STACK_SIZE];
+        int sp = 0;
+        if (tree->node_count > 0)
+            stack[sp++] = 0;
+
+        while (sp > 0) {
+            const BHNode *node = &tree->nodes[stack[--sp]];
+            if (node->mass == 0.0)
+                continue;  /* empty or massless cell exerts no force */
+
+            if (node->is_leaf) {
+                /* Leaves are summed exactly, skipping the target itself. */
+                for (int b = node->first_body; b != BH_NULL; b = tree->next_body[b]) {
+                    if (b == i) continue;
+                    double dx = objects[b].position.x - pi.x;
+                    double dy = objects[b].position.y - pi.y;
+                    double dz = objects[b].position.z - pi.z;
+                    double eps = softening_pair_length(&objects[i], &objects[b], length);
+                    double s = gmi * objects[b].mass *
+                               softening_inv_r3(dx * dx + dy * dy + dz * dz, eps, softening);
+                    fx += s * dx;
+                    fy += s * dy;
+                    fz += s * dz;
+                }
+                continue;
+            }
+
+            double dx = node->com.x - pi.x;
+            double dy = node->com.y - pi.y;
+            double dz = node->com.z - pi.z;
+            double r2 = dx * dx + dy * dy + dz * dz;
+            double size = 2.0 * node->half_size;
+
+            /* A cell containing the target is always opened so the target
+               never attracts itself through its own cell's monopole. */
+            int contains = fabs(pi.x - node->centre.x) <= node->half_size &&
+                           fabs(pi.y - node->centre.y) <= node->half_size &&
+                           fabs(pi.z - node->centre.z) <= node->half_size;
+
+            if (!contains && size * size < theta2 * r2) {
+                double s = gmi * node->mass * softening_inv_r3(r2, eps_i, softening);
+                fx += s * dx;
+                fy += s * dy;
+                fz += s * dz;
+            } else {
+                for (int c = 0; c < 8; c++) {
+                    if (node->children[c] != BH_NULL)
+                        stack[sp++] = node->children[c];
+                }
+            }
+        }
+
+        forces_out[i].x = fx;
+        forces_out[i].y = fy;
+        forces_out[i].z = fz;
+    }
+}
+
+void barnes_hut_gravity(const PhysicsObject *objects, int count, double theta,
+                        Vec3 *forces_out) {
+    barnes_hut_gravity_softened(objects, count, theta, GRAVITY_SOFTENING_NONE,
+                                0.0, forces_out);
+}
+
+void barnes_hut_gravity_softened(const PhysicsObject *objects, int count,
+                                 double theta, GravitySoftening softening,
+                                 double length, Vec3 *forces_out) {
+    BHTree tree;
+    bh_tree_init(&tree);
+    barnes_hut_gravity_ws(&tree, objects, count, theta, softening, length,
+                          forces_out);
+    bh_tree_free(&tree);
+}
+
+void barnes_hut_gravity_ws(BHTree *tree, const PhysicsObject *objects, int count,
+                           double theta, GravitySoftening softening,
+                           double length, Vec3 *forces_out) {
+    if (bh_tree_build(tree, objects, count) != 0) {
+        /* Out of memory for the tree — fall back to exact O(N²) summation. */
+        newtonian_gravity_softened(objects, count, softening, length, forces_out);
+        return;
+    }
+    bh_tree_forces(tree, objects, count, theta, softening, length, forces_out);
+}
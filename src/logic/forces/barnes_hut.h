@@ -0,0 +1,152 @@
+/**
+ * @file barnes_hut.h
+ * @brief Barnes–Hut O(N log N) gravity solver over a mass-moment octree.
+ *
+ * The tree follows the same flat node-pool design as the collision octree
+ * (collision/octree.h): nodes live in one contiguous array and refer to their
+ * children by integer index, never by pointer. Like the collision pool the
+ * array is heap-allocated and doubles when full, so one pool serves scenes
+ * from a handful of bodies up to 10^5–10^6 point masses.
+ *
+ * Each node stores the total mass and centre of mass of every body beneath
+ * it. During force evaluation a node of edge length s at distance d from the
+ * target body is treated as a single point mass when s / d < theta; otherwise
+ * its children are opened. theta = 0 opens every node and reproduces direct
+ * summation exactly; larger values trade accuracy for speed.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include "../../models/object.h"
+#include "gravity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BH_NULL -1       /* sentinel: no child / no body */
+#define BH_MAX_DEPTH 48  /* coincident bodies share a leaf below this depth */
+
+/**
+ * @brief A single cubic cell of the Barnes–Hut tree.
+ *
+ * Internal nodes (is_leaf == 0) have at least one child != BH_NULL. Leaves
+ * hold a singly linked chain of body indices starting at first_body and
+ * continuing through BHTree::next_body; the chain only has more than one
+ * entry when bodies coincide down to BH_MAX_DEPTH.
+ */
+typedef struct {
+    Vec3   centre;      /**< Geometric centre of the cell. */
+    double half_size;   /**< Half the cell edge length. */
+    Vec3   com;         /**< Centre of mass of all bodies in the cell. */
+    double mass;        /**< Total mass of all bodies in the cell. */
+    int    children[8]; /**< Octant child indices (bit0=x, bit1=y, bit2=z). */
+    int    first_body;  /**< Head of the leaf body chain (BH_NULL if empty). */
+    int    is_leaf;     /**< 1 for leaves, 0 once the cell has been split. */
+    int    depth;       /**< Depth below the root (root = 0). */
+} BHNode;
+
+/**
+ * @brief Growable node pool plus the per-body leaf chain links.
+ *
+ * nodes[0] is always the root. The pool is reused across builds; capacity only
+ * grows. Zero-initialise (or call bh_tree_init()) before the first build.
+ */
+typedef struct BHTree {
+    BHNode *nodes;
+    int     node_count;
+    int     node_capacity;
+    int    *next_body;     /**< next_body[i] = next body in i's leaf chain. */
+    int     body_capacity;
+} BHTree;
+
+/** @brief Initialise an empty tree (no allocation). */
+void bh_tree_init(BHTree *tree);
+
+/** @brief Release all memory owned by @p tree and reset it to empty. */
+void bh_tree_free(BHTree *tree);
+
+/**
+ * @brief Build the tree over the positions of @p objects and compute mass moments.
+ *
+ * @param tree     Tree to (re)build. Previous contents are discarded.
+ * @param objects  Flat array of PhysicsObject.
+ * @param count    Number of objects.
+ * @return         0 on success, -1 if memory could not be allocated.
+ */
+int bh_tree_build(BHTree *tree, const PhysicsObject *objects, int count);
+
+/**
+ * @brief Evaluate the net force on every body by walking a built tree.
+ *
+ * @param tree       Tree built from the same @p objects by bh_tree_build().
+ * @param objects    Flat array of PhysicsObject.
+ * @param count      Number of objects.
+ * @param theta      Opening angle; cells with size / distance < theta are
+ *                   approximated by their centre of mass.
+ * @param softening  Pair kernel (see softening.h). Body–body pairs use
+ *                   max(ε_i, ε_j); cell monopoles use the target's ε_i, since
+ *                   cells do not track their members' lengths.
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void bh_tree_forces(const BHTree *tree, const PhysicsObject *objects,
+                    int count, double theta, GravitySoftening softening,
+                    double length, Vec3 *forces_out);
+
+/**
+ * @brief Build a tree and evaluate forces in one call.
+ *
+ * Same contract as newtonian_gravity(). Builds a temporary tree each call;
+ * barnes_hut_gravity_ws() reuses a caller-owned one. The force walk is
+ * OpenMP-parallel.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param theta      Opening angle (0 = exact direct summation).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void barnes_hut_gravity(const PhysicsObject *objects, int count, double theta,
+                        Vec3 *forces_out);
+
+/**
+ * @brief barnes_hut_gravity() with a softened pair kernel.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param theta      Opening angle (0 = exact direct summation).
+ * @param softening  Pair kernel; see bh_tree_forces().
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void barnes_hut_gravity_softened(const PhysicsObject *objects, int count,
+                                 double theta, GravitySoftening softening,
+                                 double length, Vec3 *forces_out);
+
+/**
+ * @brief barnes_hut_gravity_softened() in a caller-owned tree.
+ *
+ * The pool keeps its capacity between calls, so steady-state ticks do not
+ * reallocate. Falls back to newtonian_gravity_softened() if the tree cannot
+ * be built.
+ *
+ * @param tree       Tree to rebuild. Must not be NULL.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param theta      Opening angle (0 = exact direct summation).
+ * @param softening  Pair kernel; see bh_tree_forces().
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void barnes_hut_gravity_ws(BHTree *tree, const PhysicsObject *objects, int count,
+                           double theta, GravitySoftening softening,
+                           double length, Vec3 *forces_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BARNES_HUT_H */
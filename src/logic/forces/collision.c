@@ -8,22 +8,22 @@
 #include "collision.h"
 #include "../../math/vec3.h"
 
-void inelastic_collision(PhysicsObject *a, PhysicsObject *b, double restitution) {
-    Vec3   delta = vec3_sub(b->position, a->position);
+/* Shared response: positions and masses in, velocities updated in place. */
+static void inelastic_response(Vec3 pa, Vec3 pb, double ma, double mb,
+                               Vec3 *vel_a, Vec3 *vel_b, double restitution) {
+    Vec3   delta = vec3_sub(pb, pa);
     double dist  = vec3_magnitude(delta);
     if (dist < 1e-10) return;  /* coincident centres — no well-defined normal */
 
     Vec3 n = vec3_scale(delta, 1.0 / dist);  /* unit collision normal */
 
     /* Scalar velocity components along the normal */
-    double ua = vec3_dot(a->velocity, n);
-    double ub = vec3_dot(b->velocity, n);
+    double ua = vec3_dot(*vel_a, n);
+    double ub = vec3_dot(*vel_b, n);
 
     /* Skip if objects are already separating along the normal */
     if (ua <= ub) return;
 
-    double ma    = a->mass;
-    double mb    = b->mass;
     double total = ma + mb;
 
     /* Post-collision velocities along the normal (inelastic formula) */
@@ -34,6 +34,18 @@ void inelastic_collision(PhysicsObject *a, PhysicsObject *b, double restitution)
      * adding to obj->force would only affect the *next* Velocity Verlet step's
      * position update (VV uses a_old for x_new), so both objects would still
      * reach the same position this tick and gravity would diverge. */
-    a->velocity = vec3_add(a->velocity, vec3_scale(n, va - ua));
-    b->velocity = vec3_add(b->velocity, vec3_scale(n, vb - ub));
+    *vel_a = vec3_add(*vel_a, vec3_scale(n, va - ua));
+    *vel_b = vec3_add(*vel_b, vec3_scale(n, vb - ub));
+}
+
+void inelastic_collision(PhysicsObject *a, PhysicsObject *b, double restitution) {
+    inelastic_response(a->position, b->position, a->mass, b->mass,
+                       &a->velocity, &b->velocity, restitution);
+}
+
+void inelastic_collision_world(PhysicsWorld *world, int ia, int ib,
+                               double restitution) {
+    inelastic_response(world->position[ia], world->position[ib],
+                       world->mass[ia], world->mass[ib],
+                       &world->velocity[ia], &world->velocity[ib], restitution);
 }
@@ -2,7 +2,7 @@
  * @file collision.h
  * @brief Inelastic collision response force between two physics objects.
  *
- * Exposes a single function for computing and applying the velocity change
+ * Exposes functions for computing and applying the velocity change
  * produced by a pairwise inelastic collision. The response is applied along
  * the collision normal (centre-to-centre direction); tangential velocity
  * components are unchanged.
@@ -17,6 +17,7 @@
 #define FORCES_COLLISION_H
 
 #include "../../models/object.h"
+#include "../../models/world.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,17 @@ extern "C" {
  */
 void inelastic_collision(PhysicsObject *a, PhysicsObject *b, double restitution);
 
+/**
+ * @brief inelastic_collision() between bodies @p ia and @p ib of a world.
+ *
+ * @param world       World holding both bodies (velocities mutated in place).
+ * @param ia          Index of the first body.
+ * @param ib          Index of the second body.
+ * @param restitution Coefficient of restitution C_R in [0, 1].
+ */
+void inelastic_collision_world(PhysicsWorld *world, int ia, int ib,
+                               double restitution);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,603 @@
+/**
+ * @file fmm.c
+ * @brief Cartesian fast multipole method over a sparse Morton-ordered octree.
+ *
+ * Expansion coefficients are stored as flat arrays indexed by multi-index
+ * k = (kx, ky, kz), ordered by total degree |k| so that "all terms with
+ * |k| ≤ q" is always a prefix of length fmm_terms(q).
+ *
+ * @author Steven Kight
+ */
+
+#include "fmm.h"
+#include "gravity.h"
+#include "softening.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define FMM_MAX_TERMS \
+    ((FMM_MAX_ORDER + 1) * (FMM_MAX_ORDER + 2) * (FMM_MAX_ORDER + 3) / 6)
+
+/* ------------------------------------------------------------------ */
+/* Multi-index tables                                                    */
+/* ------------------------------------------------------------------ */
+
+static int    s_kx[FMM_MAX_TERMS], s_ky[FMM_MAX_TERMS], s_kz[FMM_MAX_TERMS];
+static int    s_index[FMM_MAX_ORDER + 1][FMM_MAX_ORDER + 1][FMM_MAX_ORDER + 1];
+static double s_sign[FMM_MAX_TERMS];           /* (−1)^|k| */
+static double s_inv_fact[FMM_MAX_ORDER + 1];   /* 1 / i! */
+static int    s_tables_ready = 0;
+
+/* Number of multi-indices with total degree ≤ q. */
+static int fmm_terms(int q) {
+    return (q + 1) * (q + 2) * (q + 3) / 6;
+}
+
+/*
+ * Fills the tables on first use. They are constants once filled, so solvers
+ * in different workspaces may share them; the critical section only keeps
+ * two first calls from filling them at the same time.
+ */
+static void init_tables(void) {
+    #pragma omp critical(fmm_tables)
+    {
+        if (!s_tables_ready) {
+            int t = 0;
+            for (int d = 0; d <= FMM_MAX_ORDER; d++) {
+                for (int kx = d; kx >= 0; kx--) {
+                    for (int ky = d - kx; ky >= 0; ky--) {
+                        int kz = d - kx - ky;
+                        s_kx[t] = kx;
+                        s_ky[t] = ky;
+                        s_kz[t] = kz;
+                        s_sign[t] = (d & 1) ? -1.0 : 1.0;
+                        s_index[kx][ky][kz] = t;
+                        t++;
+                    }
+                }
+            }
+
+            s_inv_fact[0] = 1.0;
+            for (int i = 1; i <= FMM_MAX_ORDER; i++)
+                s_inv_fact[i] = s_inv_fact[i - 1] / i;
+
+            s_tables_ready = 1;
+        }
+    }
+}
+
+/* pw[i] = v^i / i! for i = 0..p */
+static void scaled_powers(double v, int p, double *pw) {
+    pw[0] = 1.0;
+    for (int i = 1; i <= p; i++)
+        pw[i] = pw[i - 1] * v / i;
+}
+
+/*
+ * T[k] = ∂^k (1/r) evaluated at r for every |k| ≤ p.
+ *
+ * Uses the Hermite-style recurrence for F(s) = (2s)^(−1/2), s = r²/2:
+ *   R^j_0       = F^(j)(s) = (−1)^j (2j−1)!! / r^(2j+1)
+ *   R^j_{k+e_a} = r_a R^{j+1}_k + k_a R^{j+1}_{k−e_a}
+ * and T[k] = R^0_k.
+ */
+static void derivatives(Vec3 r, int p, double *T) {
+    double R[FMM_MAX_ORDER + 1][FMM_MAX_TERMS];
+    double comp[3] = { r.x, r.y, r.z };
+
+    double r2     = r.x * r.x + r.y * r.y + r.z * r.z;
+    double inv_r2 = 1.0 / r2;
+    double f      = sqrt(inv_r2);
+    for (int j = 0; j <= p; j++) {
+        R[j][0] = f;
+        f *= -(2 * j + 1) * inv_r2;
+    }
+
+    int n = fmm_terms(p);
+    for (int t = 1; t < n; t++) {
+        int k[3] = { s_kx[t], s_ky[t], s_kz[t] };
+        int d    = k[0] + k[1] + k[2];
+        int a    = k[0] ? 0 : (k[1] ? 1 : 2);
+
+        k[a]--;                                   /* k' = k − e_a */
+        int prev  = s_index[k[0]][k[1]][k[2]];
+        int coeff = k[a];
+        int prev2 = -1;
+        if (coeff > 0) {
+            k[a]--;
+            prev2 = s_index[k[0]][k[1]][k[2]];
+        }
+
+        for (int j = 0; j <= p - d; j++) {
+            double v = comp[a] * R[j + 1][prev];
+            if (prev2 >= 0)
+                v += coeff * R[j + 1][prev2];
+            R[j][t] = v;
+        }
+    }
+
+    for (int t = 0; t < n; t++)
+        T[t] = R[0][t];
+}
+
+/* ------------------------------------------------------------------ */
+/* Sparse octree                                                         */
+/* ------------------------------------------------------------------ */
+
+/* One level of occupied cells, sorted by Morton key. */
+typedef struct {
+    int       count;
+    uint64_t *keys;
+    int      *begin;   /* leaves: body range; internal: child cell range */
+    int      *end;
+    int      *parent;  /* index of the parent cell in the level above */
+    double   *M;       /* count × terms multipole moments */
+    double   *L;       /* count × terms local coefficients */
+} FmmLevel;
+
+typedef struct {
+    uint64_t key;
+    int      body;
+} KeyedBody;
+
+static uint64_t spread_bits(uint64_t v) {
+    uint64_t r = 0;
+    for (int b = 0; b < 21; b++)
+        r |= ((v >> b) & 1u) << (3 * b);
+    return r;
+}
+
+static uint64_t compact_bits(uint64_t v) {
+    uint64_t r = 0;
+    for (int b = 0; b < 21; b++)
+        r |= ((v >> (3 * b)) & 1u) << b;
+    return r;
+}
+
+/* Morton key: bit 3b = x bit b, 3b+1 = y, 3b+2 = z (matches octant bit order). */
+static uint64_t morton_key(int qx, int qy, int qz) {
+    return spread_bits((uint64_t)qx) | (spread_bits((uint64_t)qy) << 1) |
+           (spread_bits((uint64_t)qz) << 2);
+}
+
+static void morton_decode(uint64_t key, int q[3]) {
+    q[0] = (int)compact_bits(key);
+    q[1] = (int)compact_bits(key >> 1);
+    q[2] = (int)compact_bits(key >> 2);
+}
+
+static int compare_keyed(const void *a, const void *b) {
+    const KeyedBody *ka = a, *kb = b;
+    if (ka->key != kb->key) return ka->key < kb->key ? -1 : 1;
+    return ka->body - kb->body;
+}
+
+/* Binary search for key in a level; returns the cell index or -1. */
+static int find_cell(const FmmLevel *level, uint64_t key) {
+    int lo = 0, hi = level->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (level->keys[mid] == key) return mid;
+        if (level->keys[mid] < key) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+static void free_levels(FmmLevel *levels, int n_levels) {
+    for (int l = 0; l < n_levels; l++) {
+        free(levels[l].keys);  free(levels[l].begin);
+        free(levels[l].end);   free(levels[l].parent);
+        free(levels[l].M);     free(levels[l].L);
+    }
+}
+
+static int alloc_level(FmmLevel *level, int count, int terms) {
+    level->count  = count;
+    level->keys   = malloc(count * sizeof(uint64_t));
+    level->begin  = malloc(count * sizeof(int));
+    level->end    = malloc(count * sizeof(int));
+    level->parent = malloc(count * sizeof(int));
+    level->M      = calloc((size_t)count * terms, sizeof(double));
+    level->L      = calloc((size_t)count * terms, sizeof(double));
+    return level->keys && level->begin && level->end && level->parent &&
+           level->M && level->L ? 0 : -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: fmm_gravity                                                   */
+/* ------------------------------------------------------------------ */
+
+void fmm_gravity(const PhysicsObject *objects, int count, int order,
+                 Vec3 *forces_out) {
+    fmm_gravity_softened(objects, count, order, GRAVITY_SOFTENING_NONE, 0.0,
+                         forces_out);
+}
+
+void fmm_gravity_softened(const PhysicsObject *objects, int count, int order,
+                          GravitySoftening softening, double length,
+                          Vec3 *forces_out) {
+    const double g = GRAVITATIONAL_CONSTANT;
+
+    int p = order < FMM_MIN_ORDER ? FMM_MIN_ORDER
+          : order > FMM_MAX_ORDER ? FMM_MAX_ORDER : order;
+
+    /* Leaf level: average ≈ FMM_LEAF_TARGET bodies per occupied leaf in a
+       uniform scene. Below level 2 every cell is adjacent to every other. */
+    int depth = 0;
+    while (depth < FMM_MAX_LEVEL &&
+           (double)count / pow(8.0, depth) > FMM_LEAF_TARGET)
+        depth++;
+    if (depth < 2) {
+        newtonian_gravity_softened(objects, count, softening, length, forces_out);
+        return;
+    }
+
+    init_tables();
+    const int terms = fmm_terms(p);
+
+    /* Bounding cube over all positions (padded as in Barnes–Hut). */
+    Vec3 lo = objects[0].position, hi = objects[0].position;
+    for (int i = 1; i < count; i++) {
+        Vec3 q = objects[i].position;
+        if (q.x < lo.x) lo.x = q.x;
+        if (q.y < lo.y) lo.y = q.y;
+        if (q.z < lo.z) lo.z = q.z;
+        if (q.x > hi.x) hi.x = q.x;
+        if (q.y > hi.y) hi.y = q.y;
+        if (q.z > hi.z) hi.z = q.z;
+    }
+    double size = fmax(hi.x - lo.x, fmax(hi.y - lo.y, hi.z - lo.z));
+    size = size * (1.0 + 1e-9) + 1e-9;
+
+    /* Quantise to leaf cells and sort bodies along the Morton curve. */
+    const int side = 1 << depth;
+    KeyedBody *keyed = malloc(count * sizeof(KeyedBody));
+    double *sx = malloc(count * sizeof(double));
+    double *sy = malloc(count * sizeof(double));
+    double *sz = malloc(count * sizeof(double));
+    double *sm = malloc(count * sizeof(double));
+    double *se = malloc(count * sizeof(double));
+    Vec3   *sf = malloc(count * sizeof(Vec3));
+    FmmLevel levels[FMM_MAX_LEVEL + 1] = { { 0 } };
+
+    if (!keyed || !sx || !sy || !sz || !sm || !se || !sf)
+        goto fallback;
+
+    for (int i = 0; i < count; i++) {
+        int q[3];
+        double c[3] = { objects[i].position.x - lo.x,
+                        objects[i].position.y - lo.y,
+                        objects[i].position.z - lo.z };
+        for (int a = 0; a < 3; a++) {
+            q[a] = (int)(c[a] / size * side);
+            if (q[a] < 0) q[a] = 0;
+            if (q[a] >= side) q[a] = side - 1;
+        }
+        keyed[i] = (KeyedBody){ morton_key(q[0], q[1], q[2]), i };
+    }
+    qsort(keyed, count, sizeof(KeyedBody), compare_keyed);
+
+    for (int s = 0; s < count; s++) {
+        const PhysicsObject *o = &objects[keyed[s].body];
+        sx[s] = o->position.x;
+        sy[s] = o->position.y;
+        sz[s] = o->position.z;
+        sm[s] = o->mass;
+        se[s] = o->softening;
+    }
+
+    /* Leaf level: runs of equal keys. */
+    {
+        int n = 1;
+        for (int s = 1; s < count; s++)
+            if (keyed[s].key != keyed[s - 1].key) n++;
+        if (alloc_level(&levels[depth], n, terms) != 0)
+            goto fallback;
+
+        int c = 0;
+        levels[depth].keys[0]  = keyed[0].key;
+        levels[depth].begin[0] = 0;
+        for (int s = 1; s < count; s++) {
+            if (keyed[s].key != keyed[s - 1].key) {
+                levels[depth].end[c++] = s;
+                levels[depth].keys[c]  = keyed[s].key;
+                levels[depth].begin[c] = s;
+            }
+        }
+        levels[depth].end[c] = count;
+    }
+
+    /* Internal levels: runs of equal parent keys (key >> 3). */
+    for (int l = depth - 1; l >= 0; l--) {
+        FmmLevel *child = &levels[l + 1];
+        int n = 1;
+        for (int c = 1; c < child->count; c++)
+            if ((child->keys[c] >> 3) != (child->keys[c - 1] >> 3)) n++;
+        if (alloc_level(&levels[l], n, terms) != 0)
+            goto fallback;
+
+        int c = 0;
+        levels[l].keys[0]  = child->keys[0] >> 3;
+        levels[l].begin[0] = 0;
+        child->parent[0]   = 0;
+        for (int k = 1; k < child->count; k++) {
+            if ((child->keys[k] >> 3) != (child->keys[k - 1] >> 3)) {
+                levels[l].end[c++] = k;
+                levels[l].keys[c]  = child->keys[k] >> 3;
+                levels[l].begin[c] = k;
+            }
+            child->parent[k] = c;
+        }
+        levels[l].end[c] = child->count;
+    }
+    levels[0].parent[0] = -1;
+
+    /* ── P2M: leaf moments about each leaf centre ─────────────────────── */
+    {
+        const FmmLevel *leaf = &levels[depth];
+        const double cell = size / side;
+
+        #pragma omp parallel for schedule(static)
+        for (int c = 0; c < leaf->count; c++) {
+            int q[3];
+            morton_decode(leaf->keys[c], q);
+            double cx = lo.x + (q[0] + 0.5) * cell;
+            double cy = lo.y + (q[1] + 0.5) * cell;
+            double cz = lo.z + (q[2] + 0.5) * cell;
+            double *M = &leaf->M[(size_t)c * terms];
+
+            for (int s = leaf->begin[c]; s < leaf->end[c]; s++) {
+                double px[FMM_MAX_ORDER + 1], py[FMM_MAX_ORDER + 1], pz[FMM_MAX_ORDER + 1];
+                scaled_powers(sx[s] - cx, p, px);
+                scaled_powers(sy[s] - cy, p, py);
+                scaled_powers(sz[s] - cz, p, pz);
+                for (int t = 0; t < terms; t++)
+                    M[t] += sm[s] * px[s_kx[t]] * py[s_ky[t]] * pz[s_kz[t]];
+            }
+        }
+    }
+
+    /* ── M2M: shift child moments to parent centres, leaves upward ─────── */
+    for (int l = depth - 1; l >= 2; l--) {
+        const FmmLevel *parent = &levels[l];
+        const FmmLevel *child  = &levels[l + 1];
+        const double pcell = size / (1 << l);
+        const double ccell = pcell * 0.5;
+
+        #pragma omp parallel for schedule(static)
+        for (int c = 0; c < parent->count; c++) {
+            int pq[3];
+            morton_decode(parent->keys[c], pq);
+            double *M = &parent->M[(size_t)c * terms];
+
+            for (int k = parent->begin[c]; k < parent->end[c]; k++) {
+                int cq[3];
+                morton_decode(child->keys[k], cq);
+                double px[FMM_MAX_ORDER + 1], py[FMM_MAX_ORDER + 1], pz[FMM_MAX_ORDER + 1];
+                scaled_powers((cq[0] + 0.5) * ccell - (pq[0] + 0.5) * pcell, p, px);
+                scaled_powers((cq[1] + 0.5) * ccell - (pq[1] + 0.5) * pcell, p, py);
+                scaled_powers((cq[2] + 0.5) * ccell - (pq[2] + 0.5) * pcell, p, pz);
+
+                const double *Mc = &child->M[(size_t)k * terms];
+                for (int t = 0; t < terms; t++) {
+                    int kx = s_kx[t], ky = s_ky[t], kz = s_kz[t];
+                    double acc = 0.0;
+                    for (int lx = 0; lx <= kx; lx++)
+                        for (int ly = 0; ly <= ky; ly++)
+                            for (int lz = 0; lz <= kz; lz++)
+                                acc += Mc[s_index[lx][ly][lz]] *
+                                       px[kx - lx] * py[ky - ly] * pz[kz - lz];
+                    M[t] += acc;
+                }
+            }
+        }
+    }
+
+    /* ── M2L: interaction lists (children of parent's neighbours that are
+       not adjacent to the cell) ────────────────────────────────────────── */
+    for (int l = 2; l <= depth; l++) {
+        const FmmLevel *level  = &levels[l];
+        const FmmLevel *parent = &levels[l - 1];
+        const double cell = size / (1 << l);
+        const int pside = 1 << (l - 1);
+
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (int c = 0; c < level->count; c++) {
+            int q[3];
+            morton_decode(level->keys[c], q);
+            double *L = &level->L[(size_t)c * terms];
+            double T[FMM_MAX_TERMS];
+
+            for (int dx = -1; dx <= 1; dx++)
+            for (int dy = -1; dy <= 1; dy++)
+            for (int dz = -1; dz <= 1; dz++) {
+                int nq[3] = { (q[0] >> 1) + dx, (q[1] >> 1) + dy, (q[2] >> 1) + dz };
+                if (nq[0] < 0 || nq[1] < 0 || nq[2] < 0 ||
+                        nq[0] >= pside || nq[1] >= pside || nq[2] >= pside)
+                    continue;
+                int pn = find_cell(parent, morton_key(nq[0], nq[1], nq[2]));
+                if (pn < 0)
+                    continue;
+
+                for (int k = parent->begin[pn]; k < parent->end[pn]; k++) {
+                    int sq[3];
+                    morton_decode(level->keys[k], sq);
+                    if (abs(sq[0] - q[0]) <= 1 && abs(sq[1] - q[1]) <= 1 &&
+                            abs(sq[2] - q[2]) <= 1)
+                        continue;  /* adjacent: handled by P2P or a finer level */
+
+                    Vec3 r = { (q[0] - sq[0]) * cell, (q[1] - sq[1]) * cell,
+                               (q[2] - sq[2]) * cell };
+                    derivatives(r, p, T);
+
+                    const double *M = &level->M[(size_t)k * terms];
+                    for (int n = 0; n < terms; n++) {
+                        int nd = s_kx[n] + s_ky[n] + s_kz[n];
+                        int kmax = fmm_terms(p - nd);
+                        double acc = 0.0;
+                        for (int t = 0; t < kmax; t++) {
+                            int idx = s_index[s_kx[n] + s_kx[t]]
+                                             [s_ky[n] + s_ky[t]]
+                                             [s_kz[n] + s_kz[t]];
+                            acc += s_sign[t] * M[t] * T[idx];
+                        }
+                        L[n] += acc;
+                    }
+                }
+            }
+        }
+    }
+
+    /* ── L2L: shift parent locals down to child centres ──────────────── */
+    for (int l = 3; l <= depth; l++) {
+        const FmmLevel *level  = &levels[l];
+        const FmmLevel *parent = &levels[l - 1];
+        const double cell  = size / (1 << l);
+        const double pcell = cell * 2.0;
+
+        #pragma omp parallel for schedule(static)
+        for (int c = 0; c < level->count; c++) {
+            int q[3], pq[3];
+            int pc = level->parent[c];
+            morton_decode(level->keys[c], q);
+            morton_decode(parent->keys[pc], pq);
+
+            double px[FMM_MAX_ORDER + 1], py[FMM_MAX_ORDER + 1], pz[FMM_MAX_ORDER + 1];
+            scaled_powers((q[0] + 0.5) * cell - (pq[0] + 0.5) * pcell, p, px);
+            scaled_powers((q[1] + 0.5) * cell - (pq[1] + 0.5) * pcell, p, py);
+            scaled_powers((q[2] + 0.5) * cell - (pq[2] + 0.5) * pcell, p, pz);
+
+            const double *Lp = &parent->L[(size_t)pc * terms];
+            double *L = &level->L[(size_t)c * terms];
+            for (int n = 0; n < terms; n++) {
+                int nd = s_kx[n] + s_ky[n] + s_kz[n];
+                int mmax = fmm_terms(p - nd);
+                double acc = 0.0;
+                for (int t = 0; t < mmax; t++) {
+                    int idx = s_index[s_kx[n] + s_kx[t]]
+                                     [s_ky[n] + s_ky[t]]
+                                     [s_kz[n] + s_kz[t]];
+                    acc += Lp[idx] * px[s_kx[t]] * py[s_ky[t]] * pz[s_kz[t]];
+                }
+                L[n] += acc;
+            }
+        }
+    }
+
+    /* ── L2P + P2P: far field from locals, near field summed exactly ──── */
+    {
+        const FmmLevel *leaf = &levels[depth];
+        const double cell = size / side;
+        const int grad_terms = fmm_terms(p - 1);
+
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (int c = 0; c < leaf->count; c++) {
+            int q[3];
+            morton_decode(leaf->keys[c], q);
+            double cx = lo.x + (q[0] + 0.5) * cell;
+            double cy = lo.y + (q[1] + 0.5) * cell;
+            double cz = lo.z + (q[2] + 0.5) * cell;
+            const double *L = &leaf->L[(size_t)c * terms];
+
+            int near[27], n_near = 0;
+            for (int dx = -1; dx <= 1; dx++)
+            for (int dy = -1; dy <= 1; dy++)
+            for (int dz = -1; dz <= 1; dz++) {
+                int nq[3] = { q[0] + dx, q[1] + dy, q[2] + dz };
+                if (nq[0] < 0 || nq[1] < 0 || nq[2] < 0 ||
+                        nq[0] >= side || nq[1] >= side || nq[2] >= side)
+                    continue;
+                int nc = find_cell(leaf, morton_key(nq[0], nq[1], nq[2]));
+                if (nc >= 0)
+                    near[n_near++] = nc;
+            }
+
+            for (int s = leaf->begin[c]; s < leaf->end[c]; s++) {
+                /* Far field: ∇ of the local expansion at the body. */
+                double px[FMM_MAX_ORDER + 1], py[FMM_MAX_ORDER + 1], pz[FMM_MAX_ORDER + 1];
+                scaled_powers(sx[s] - cx, p, px);
+                scaled_powers(sy[s] - cy, p, py);
+                scaled_powers(sz[s] - cz, p, pz);
+
+                double gx = 0.0, gy = 0.0, gz = 0.0;
+                for (int t = 0; t < grad_terms; t++) {
+                    int kx = s_kx[t], ky = s_ky[t], kz = s_kz[t];
+                    double e = px[kx] * py[ky] * pz[kz];
+                    gx += L[s_index[kx + 1][ky][kz]] * e;
+                    gy += L[s_index[kx][ky + 1][kz]] * e;
+                    gz += L[s_index[kx][ky][kz + 1]] * e;
+                }
+
+                /* Near field: exact pairs with every body in adjacent leaves. */
+                for (int nn = 0; nn < n_near; nn++) {
+                    int nc = near[nn];
+                    for (int j = leaf->begin[nc]; j < leaf->end[nc]; j++) {
+                        if (j == s) continue;
+                        double dx = sx[j] - sx[s];
+                        double dy = sy[j] - sy[s];
+                        double dz = sz[j] - sz[s];
+                        double eps = softening_combine(se[j], se[s], length);
+                        double w = sm[j] * softening_inv_r3(dx * dx + dy * dy + dz * dz,
+                                                            eps, softening);
+                        gx += w * dx;
+                        gy += w * dy;
+                        gz += w * dz;
+                    }
+                }
+
+                double gm = g * sm[s];
+                sf[s] = (Vec3){ gm * gx, gm * gy, gm * gz };
+            }
+        }
+    }
+
+    for (int s = 0; s < count; s++)
+        forces_out[keyed[s].body] = sf[s];
+
+    free_levels(levels, depth + 1);
+    free(keyed); free(sx); free(sy); free(sz); free(sm); free(se); free(sf);
+    return;
+
+fallback:
+    /* Out of memory for the tree — fall back to exact O(N²) summation. */
+    free_levels(levels, depth + 1);
+    free(keyed); free(sx); free(sy); free(sz); free(sm); free(se); free(sf);
+    newtonian_gravity_softened(objects, count, softening, length, forces_out);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: fmm_gravity_error                                             */
+/* ------------------------------------------------------------------ */
+
+double fmm_gravity_error(const PhysicsObject *objects, int count, int order) {
+    if (count <= 0)
+        return 0.0;
+
+    Vec3 *fmm    = malloc(count * sizeof(Vec3));
+    Vec3 *direct = malloc(count * sizeof(Vec3));
+    if (!fmm || !direct) {
+        free(fmm);
+        free(direct);
+        return -1.0;
+    }
+
+    fmm_gravity(objects, count, order, fmm);
+    newtonian_gravity_direct(objects, count, direct);
+
+    double sum = 0.0;
+    int counted = 0;
+    for (int i = 0; i < count; i++) {
+        double ref = vec3_magnitude(direct[i]);
+        if (ref == 0.0) continue;
+        double e = vec3_magnitude(vec3_sub(fmm[i], direct[i])) / ref;
+        sum += e * e;
+        counted++;
+    }
+
+    free(fmm);
+    free(direct);
+    return counted > 0 ? sqrt(sum / counted) : 0.0;
+}
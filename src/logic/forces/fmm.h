@@ -0,0 +1,93 @@
+/**
+ * @file fmm.h
+ * @brief Fast multipole method (FMM) gravity solver with tunable order.
+ *
+ * Bodies are sorted along a Morton (Z-order) curve at a fixed leaf level and
+ * a sparse linear octree is built from the occupied cells only, so memory is
+ * proportional to N regardless of how clustered the scene is.
+ *
+ * Expansions are Cartesian Taylor series truncated at total order p:
+ *
+ *   P2M  leaf moments      M_k = Σ_j m_j d_j^k / k!           (|k| ≤ p)
+ *   M2M  child → parent    moments shifted up to the parent centre
+ *   M2L  well-separated    L_n = Σ_k (−1)^|k| M_k ∂^(n+k)(1/r)  (|n|+|k| ≤ p)
+ *   L2L  parent → child    locals shifted down to the child centre
+ *   L2P  leaf bodies       F_i = G m_i ∇ Σ_n L_n e^n / n!
+ *   P2P  adjacent leaves   exact pairwise summation (softened if requested)
+ *
+ * Two cells are well separated when they are not adjacent at the same level,
+ * the usual one-cell buffer. Raising the order p tightens the far-field error
+ * geometrically at O(p⁶) M2L cost per cell pair.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef FMM_H
+#define FMM_H
+
+#include "../../models/object.h"
+#include "gravity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMM_MIN_ORDER   1   /* lowest useful order: monopole far field */
+#define FMM_MAX_ORDER   10  /* expansion tables are sized for this order */
+#define FMM_LEAF_TARGET 32  /* average bodies per leaf used to pick depth */
+#define FMM_MAX_LEVEL   10  /* deepest leaf level (2^10 cells per axis) */
+
+/**
+ * @brief Computes net gravitational forces with the fast multipole method.
+ *
+ * Same contract as newtonian_gravity(). Scenes small enough that every leaf is
+ * adjacent to every other (leaf level below 2) are summed directly.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param order      Expansion order p, clamped to
+ *                   [FMM_MIN_ORDER, FMM_MAX_ORDER].
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void fmm_gravity(const PhysicsObject *objects, int count, int order,
+                 Vec3 *forces_out);
+
+/**
+ * @brief fmm_gravity() with a softened near field.
+ *
+ * P2P pairs use the softened kernel with max(ε_i, ε_j). The expansions stay
+ * Newtonian: they only couple cells at least one leaf apart, which the
+ * spline leaves exactly Newtonian once a leaf is wider than its support
+ * 2.8 ε, and where Plummer's deviation is O(ε²/r²).
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param order      Expansion order p, as for fmm_gravity().
+ * @param softening  Near-field pair kernel (see softening.h).
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void fmm_gravity_softened(const PhysicsObject *objects, int count, int order,
+                          GravitySoftening softening, double length,
+                          Vec3 *forces_out);
+
+/**
+ * @brief Estimate the FMM error for a given order against direct summation.
+ *
+ * Runs fmm_gravity() and newtonian_gravity_direct() on the same bodies and
+ * returns the RMS over bodies of |F_fmm − F_direct| / |F_direct|. The direct
+ * pass is O(N²), so this is intended for small validation sets when choosing
+ * an order for a scene.
+ *
+ * @param objects  Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count    Number of objects (N).
+ * @param order    Expansion order p passed to fmm_gravity().
+ * @return         RMS relative force error, or -1.0 on allocation failure.
+ */
+double fmm_gravity_error(const PhysicsObject *objects, int count, int order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMM_H */
@@ -11,15 +11,27 @@
  */
 
 #include "gravity.h"
+#include "barnes_hut.h"
+#include "fmm.h"
+#include "gravity_simd.h"
+#include "gravity_tiled.h"
+#include "particle_mesh.h"
+#include "softening.h"
 #include "../../math/matrix.h"
 #include "../../models/object.h"
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 const double power = 2.0;
 const double half = 0.5;
-const double g = 6.67430e-11;
+static const double g = GRAVITATIONAL_CONSTANT;
 
 // Bodies at or below this count use the Fortran (CPU) backend. Above it, the
 // CUDA (GPU) backend is used. Tune by benchmarking newtonian_gravity() around
@@ -38,6 +50,122 @@ static bool gravity_use_gpu(int count) {
 #endif
 }
 
+/* ------------------------------------------------------------------ */
+/* Workspace                                                             */
+/* ------------------------------------------------------------------ */
+
+void gravity_workspace_init(GravityWorkspace *ws) {
+    *ws = (GravityWorkspace){0};
+    ws->identity_count = -1;
+}
+
+/* Drops the matrix buffers only; the other solvers' state is kept. */
+static void matrix_buffers_free(GravityWorkspace *ws) {
+    free(ws->block);
+    free(ws->vec_block);
+    ws->block          = NULL;
+    ws->vec_block      = NULL;
+    ws->capacity       = 0;
+    ws->identity_count = -1;
+}
+
+void gravity_workspace_free(GravityWorkspace *ws) {
+    matrix_buffers_free(ws);
+    free(ws->partial);
+    free(ws->mixed);
+    gravity_soa_free(&ws->soa);
+    free(ws->stage);
+    if (ws->tree) bh_tree_free(ws->tree);
+    if (ws->mesh) pm_workspace_free(ws->mesh);
+    free(ws->tree);
+    free(ws->mesh);
+    gravity_workspace_init(ws);
+}
+
+int gravity_workspace_reserve(GravityWorkspace *ws, int count) {
+    if (count <= ws->capacity) return 0;
+
+    // Contents need not survive growth, so free first and keep peak memory
+    // at one workspace rather than two.
+    matrix_buffers_free(ws);
+
+    const size_t nn = (size_t)count * (size_t)count;
+    double *block     = malloc(nn * GRAVITY_WS_SQUARE * sizeof(double));
+    double *vec_block = malloc((size_t)count * GRAVITY_WS_VECTOR * sizeof(double));
+    if (!block || !vec_block) {
+        free(block);
+        free(vec_block);
+        return -1;
+    }
+
+    double **square[GRAVITY_WS_SQUARE] = {
+        &ws->dx, &ws->dy, &ws->dz, &ws->r2_safe, &ws->force,
+        &ws->identity, &ws->tmp_a, &ws->tmp_b, &ws->tmp_c,
+    };
+    for (int k = 0; k < GRAVITY_WS_SQUARE; k++) *square[k] = block + k * nn;
+
+    double **vector[GRAVITY_WS_VECTOR] = {
+        &ws->x, &ws->y, &ws->z, &ws->mass, &ws->ones,
+        &ws->sum_x, &ws->sum_y, &ws->sum_z,
+    };
+    for (int k = 0; k < GRAVITY_WS_VECTOR; k++) *vector[k] = vec_block + k * (size_t)count;
+
+    ws->block          = block;
+    ws->vec_block      = vec_block;
+    ws->capacity       = count;
+    ws->identity_count = -1;
+    return 0;
+}
+
+int gravity_soa_reserve(GravitySoA *soa, int count) {
+    if (count <= soa->capacity) return 0;
+
+    double *block = malloc((size_t)count * 5 * sizeof(double));
+    if (!block) return -1;
+    free(soa->x);
+    soa->x = block;
+    soa->y = block + count;
+    soa->z = block + 2 * (size_t)count;
+    soa->m = block + 3 * (size_t)count;
+    soa->e = block + 4 * (size_t)count;
+    soa->capacity = count;
+    return 0;
+}
+
+void gravity_soa_free(GravitySoA *soa) {
+    free(soa->x);
+    *soa = (GravitySoA){0};
+}
+
+/* The workspace's Barnes–Hut tree, allocated on first use; NULL if out of memory. */
+static BHTree *workspace_tree(GravityWorkspace *ws) {
+    if (!ws->tree) {
+        ws->tree = malloc(sizeof(*ws->tree));
+        if (ws->tree) bh_tree_init(ws->tree);
+    }
+    return ws->tree;
+}
+
+/* The workspace's particle-mesh grids, allocated on first use; NULL if out of memory. */
+static PMWorkspace *workspace_mesh(GravityWorkspace *ws) {
+    if (!ws->mesh) {
+        ws->mesh = malloc(sizeof(*ws->mesh));
+        if (ws->mesh) pm_workspace_init(ws->mesh);
+    }
+    return ws->mesh;
+}
+
+/* ------------------------------------------------------------------ */
+/* Matrix pipeline stages                                                */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Each stage reads and writes workspace buffers only. Every matrix_* call
+ * overwrites its whole output, so buffers are never re-zeroed between ticks.
+ * Matrices are laid out with row stride count (not capacity), so a workspace
+ * sized for a larger N simply leaves its tail unused.
+ */
+
 /**
  * Computes pairwise displacement matrices ΔX, ΔY, ΔZ (see §Force Direction Vector
  * — Matrix Derivations) where each element is the signed difference:
@@ -53,78 +181,105 @@ static bool gravity_use_gpu(int count) {
  * The sign convention here means ΔX[i,j] points from body i toward body j,
  * which is the correct direction for the attractive gravitational force on body i.
  *
- * The caller owns the returned data pointers and must free them.
+ * Results land in ws->dx/dy/dz; tmp_a/tmp_b hold the broadcasts.
  */
-static void compute_displacements(const PhysicsObject *objects, int count, bool use_gpu,
-                                   double **dx_out, double **dy_out, double **dz_out) {
-    double *x_data    = malloc(count * sizeof(double));
-    double *y_data    = malloc(count * sizeof(double));
-    double *z_data    = malloc(count * sizeof(double));
-    double *ones_data = malloc(count * sizeof(double));
-
+static void compute_displacements(GravityWorkspace *ws, const PhysicsObject *objects,
+                                  int count, bool use_gpu) {
     for (int i = 0; i < count; i++) {
-        x_data[i]    = objects[i].position.x;
-        y_data[i]    = objects[i].position.y;
-        z_data[i]    = objects[i].position.z;
-        ones_data[i] = 1.0;
-    }
-
-    Matrix x_col    = { .rows = count, .cols = 1,     .data = x_data    };
-    Matrix x_row    = { .rows = 1,     .cols = count, .data = x_data    };
-    Matrix y_col    = { .rows = count, .cols = 1,     .data = y_data    };
-    Matrix y_row    = { .rows = 1,     .cols = count, .data = y_data    };
-    Matrix z_col    = { .rows = count, .cols = 1,     .data = z_data    };
-    Matrix z_row    = { .rows = 1,     .cols = count, .data = z_data    };
-    Matrix ones_col = { .rows = count, .cols = 1,     .data = ones_data };
-    Matrix ones_row = { .rows = 1,     .cols = count, .data = ones_data };
-
-    // Allocate N×N broadcast and difference matrices for each axis
-    double *xi_data = calloc(count * count, sizeof(double));
-    double *xj_data = calloc(count * count, sizeof(double));
-    double *dx_data = calloc(count * count, sizeof(double));
-    double *yi_data = calloc(count * count, sizeof(double));
-    double *yj_data = calloc(count * count, sizeof(double));
-    double *dy_data = calloc(count * count, sizeof(double));
-    double *zi_data = calloc(count * count, sizeof(double));
-    double *zj_data = calloc(count * count, sizeof(double));
-    double *dz_data = calloc(count * count, sizeof(double));
-
-    Matrix xi = { count, count, xi_data }; // [i,j] = x_i  (x * 1^T)
-    Matrix xj = { count, count, xj_data }; // [i,j] = x_j  (1 * x^T)
-    Matrix dx = { count, count, dx_data }; // [i,j] = x_j - x_i  (ΔX)
-    Matrix yi = { count, count, yi_data };
-    Matrix yj = { count, count, yj_data };
-    Matrix dy = { count, count, dy_data };
-    Matrix zi = { count, count, zi_data };
-    Matrix zj = { count, count, zj_data };
-    Matrix dz = { count, count, dz_data };
+        ws->x[i]    = objects[i].position.x;
+        ws->y[i]    = objects[i].position.y;
+        ws->z[i]    = objects[i].position.z;
+        ws->ones[i] = 1.0;
+    }
+
+    Matrix ones_col = { .rows = count, .cols = 1,     .data = ws->ones };
+    Matrix ones_row = { .rows = 1,     .cols = count, .data = ws->ones };
+
+    Matrix bi = { count, count, ws->tmp_a }; // [i,j] = p_i  (p * 1^T)
+    Matrix bj = { count, count, ws->tmp_b }; // [i,j] = p_j  (1 * p^T)
+
+    double *coords[3] = { ws->x,  ws->y,  ws->z  };
+    double *deltas[3] = { ws->dx, ws->dy, ws->dz };
 
     // Broadcast each coordinate into N×N matrices, then subtract to get ΔX/ΔY/ΔZ.
-    // xi = x * 1^T  (each row is x^T),  xj = 1 * x^T  (each column is x).
-    matrix_mul(&x_col, &ones_row, &xi, use_gpu);  // xi[i,j] = x_i
-    matrix_mul(&ones_col, &x_row, &xj, use_gpu);  // xj[i,j] = x_j
-    matrix_sub(&xj, &xi, &dx, use_gpu);           // ΔX[i,j] = x_j - x_i
+    for (int axis = 0; axis < 3; axis++) {
+        Matrix p_col = { .rows = count, .cols = 1,     .data = coords[axis] };
+        Matrix p_row = { .rows = 1,     .cols = count, .data = coords[axis] };
+        Matrix delta = { count, count, deltas[axis] };
+
+        matrix_mul(&p_col, &ones_row, &bi, use_gpu);  // bi[i,j] = p_i
+        matrix_mul(&ones_col, &p_row, &bj, use_gpu);  // bj[i,j] = p_j
+        matrix_sub(&bj, &bi, &delta, use_gpu);        // ΔP[i,j] = p_j - p_i
+    }
+}
+
+/**
+ * Computes the safe squared distances shared by both stages:
+ *
+ *   r²[i,j]      = ΔX² + ΔY² + ΔZ²
+ *   r²_safe      = r² + I
+ *
+ * Adding I replaces each zero diagonal entry with 1, making division
+ * well-defined. The ⊙(J−I) mask in the force stage zeroes those entries
+ * afterward. The identity is rebuilt only when N changes.
+ */
+static void compute_safe_distances(GravityWorkspace *ws, int count, bool use_gpu) {
+    if (ws->identity_count != count) {
+        memset(ws->identity, 0, (size_t)count * count * sizeof(double));
+        for (int i = 0; i < count; i++) {
+            ws->identity[i * count + i] = 1.0;
+        }
+        ws->identity_count = count;
+    }
 
-    matrix_mul(&y_col, &ones_row, &yi, use_gpu);
-    matrix_mul(&ones_col, &y_row, &yj, use_gpu);
-    matrix_sub(&yj, &yi, &dy, use_gpu);           // ΔY[i,j] = y_j - y_i
+    Matrix dx = { count, count, ws->dx };
+    Matrix dy = { count, count, ws->dy };
+    Matrix dz = { count, count, ws->dz };
+    Matrix a  = { count, count, ws->tmp_a };
+    Matrix b  = { count, count, ws->tmp_b };
+    Matrix c  = { count, count, ws->tmp_c };
+    Matrix identity = { count, count, ws->identity };
+    Matrix safe     = { count, count, ws->r2_safe };
+
+    matrix_power(&dx, &power, &a, use_gpu);  // ΔX²
+    matrix_power(&dy, &power, &b, use_gpu);  // ΔY²
+    matrix_add(&a, &b, &c, use_gpu);         // ΔX² + ΔY²
+    matrix_power(&dz, &power, &a, use_gpu);  // ΔZ²
+    matrix_add(&c, &a, &b, use_gpu);         // r²
+    matrix_add(&b, &identity, &safe, use_gpu);
+}
 
-    matrix_mul(&z_col, &ones_row, &zi, use_gpu);
-    matrix_mul(&ones_col, &z_row, &zj, use_gpu);
-    matrix_sub(&zj, &zi, &dz, use_gpu);           // ΔZ[i,j] = z_j - z_i
+/**
+ * Replaces each off-diagonal r²_safe with the effective squared distance of
+ * the softened kernel,
+ *
+ *   r²_eff[i,j] = g(r_ij)^{-2/3}   so that   1 / r_eff³ = g(r_ij)
+ *
+ * Both later stages only see r²_safe (F = G m m / r², D_hat = ΔP / r), so
+ * their product becomes G m_i m_j ΔP g(r) without touching them. Plummer
+ * reduces to r² + ε²; the spline is exact r² beyond its support. Runs on
+ * the host between matrix_* calls. Pairs with no softening length keep r².
+ */
+static void soften_safe_distances(GravityWorkspace *ws, const PhysicsObject *objects,
+                                  int count, GravitySoftening kind, double length) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        double *row = ws->r2_safe + (size_t)i * count;
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue; // diagonal stays 1, masked by ⊙ (J − I)
 
-    free(x_data);  free(y_data);  free(z_data);  free(ones_data);
-    free(xi_data); free(xj_data);
-    free(yi_data); free(yj_data);
-    free(zi_data); free(zj_data);
+            const double eps = softening_pair_length(&objects[i], &objects[j], length);
+            if (eps <= 0.0) continue;
 
-    *dx_out = dx_data;
-    *dy_out = dy_data;
-    *dz_out = dz_data;
+            const double inv_r_eff = cbrt(softening_inv_r3(row[j], eps, kind));
+            row[j] = 1.0 / (inv_r_eff * inv_r_eff);
+        }
+    }
 }
 
 /**
- * Computes the N×N matrix of scalar gravitational force magnitudes.
+ * Computes the N×N matrix of scalar gravitational force magnitudes into
+ * ws->force.
  *
  * Implements the matrix final form (see §Matrix Final Form):
  *
@@ -132,251 +287,681 @@ static void compute_displacements(const PhysicsObject *objects, int count, bool
  *
  * where:
  *   m_n × m_n^T  — outer product giving m_i * m_j for every pair (i, j)
- *   r²_safe      — element-wise squared distances with identity added to
- *                  prevent division by zero on the diagonal (r²_safe = r² + I)
+ *   r²_safe      — from compute_safe_distances()
  *   ⊙ (J − I)   — Hadamard mask that zeros self-interaction entries
- *
- * @param objects    Input array of physics objects.
- * @param count      Number of objects (N).
- * @param force_data Pre-allocated N×N row-major buffer. Receives the scalar
- *                   force magnitude between every pair of bodies.
- * @param use_gpu    If true, use the CUDA backend; otherwise Fortran.
  */
-static void newtonian_gravity_forces(const PhysicsObject *objects, int count, double *force_data, bool use_gpu,
-                                     const double *dx_data, const double *dy_data, const double *dz_data) {
+static void newtonian_gravity_forces(GravityWorkspace *ws, const PhysicsObject *objects,
+                                     int count, bool use_gpu) {
 
     // ── Step 1: mass product  m_n × m_n^T  (N×N) ────────────────────────────
-    // Produces mass_prod[i,j] = m_i * m_j for every body pair.
-    double *col_data = malloc(count * sizeof(double));
-    double *row_data = malloc(count * sizeof(double));
-
     for (int i = 0; i < count; i++) {
-        col_data[i] = objects[i].mass;
-        row_data[i] = objects[i].mass;
+        ws->mass[i] = objects[i].mass;
     }
 
-    Matrix mass_col = { .rows = count, .cols = 1, .data = col_data }; // Nx1
-    Matrix mass_row = { .rows = 1, .cols = count, .data = row_data }; // 1xN
-
-    double *prod_data = calloc(count * count, sizeof(double));
-    Matrix mass_prod = { .rows = count, .cols = count, .data = prod_data }; // NxN
+    Matrix mass_col  = { .rows = count, .cols = 1, .data = ws->mass }; // Nx1
+    Matrix mass_row  = { .rows = 1, .cols = count, .data = ws->mass }; // 1xN
+    Matrix mass_prod = { count, count, ws->tmp_a };                    // NxN
 
     matrix_mul(&mass_col, &mass_row, &mass_prod, use_gpu);
 
-    free(col_data);
-    free(row_data);
+    // ── Step 2: (m_n × m_n^T) ⊘ r²_safe, then scale by G ───────────────────
+    Matrix safe          = { count, count, ws->r2_safe };
+    Matrix mass_distance = { count, count, ws->tmp_b };
+    Matrix forces        = { count, count, ws->force };
 
-    // ── Step 2: squared distances  r²[i,j] = Δx² + Δy² + Δz²  (N×N) ────────
-    double *dx_s_data = calloc(count * count, sizeof(double));
-    double *dy_s_data = calloc(count * count, sizeof(double));
-    double *dz_s_data = calloc(count * count, sizeof(double));
+    matrix_div(&mass_prod, &safe, &mass_distance, use_gpu);
+    matrix_scalar_mul(&mass_distance, &g, &forces, use_gpu);
 
-    Matrix dx = { count, count, (double *)dx_data };
-    Matrix dy = { count, count, (double *)dy_data };
-    Matrix dz = { count, count, (double *)dz_data };
-    Matrix dx_s = { count, count, dx_s_data };
-    Matrix dy_s = { count, count, dy_s_data };
-    Matrix dz_s = { count, count, dz_s_data };
+    // ── Step 3: ⊙ (J − I) — zero diagonal (self-interaction) entries ─────────
+    for (int i = 0; i < count; i++) {
+        ws->force[i * count + i] = 0.0;
+    }
+}
 
-    matrix_power(&dx, &power, &dx_s, use_gpu);
-    matrix_power(&dy, &power, &dy_s, use_gpu);
-    matrix_power(&dz, &power, &dz_s, use_gpu);
+/**
+ * Combines the force magnitudes with the unit direction tensor D_hat (see
+ * §Force Direction Vector — Final Form) and row-sums each component:
+ *
+ *   r[i,j]      = sqrt(r²_safe[i,j])
+ *   D_hat[i,j]  = D[i,j] / r[i,j]                  (unit direction)
+ *   F_vec[i,j]  = F[i,j] ⊙ D_hat[i,j]
+ *   F(i)        = Σ_j F_vec[i,j]
+ *
+ * Because ΔX[i,i] = 0, the diagonal of D_hat is 0/sqrt(1) = 0, which is
+ * consistent with the force matrix's zeroed diagonal. One component is
+ * processed at a time so tmp_b/tmp_c are reused for x, y and z.
+ */
+static void newtonian_gravity_directions(GravityWorkspace *ws, int count, bool use_gpu) {
+    Matrix safe   = { count, count, ws->r2_safe };
+    Matrix r_mat  = { count, count, ws->tmp_a };
+    Matrix forces = { count, count, ws->force };
+    Matrix dir    = { count, count, ws->tmp_b };
+    Matrix fvec   = { count, count, ws->tmp_c };
 
-    double *xy_dist_data = calloc(count * count, sizeof(double));
-    double *dist_data    = calloc(count * count, sizeof(double));
+    matrix_power(&safe, &half, &r_mat, use_gpu);
 
-    Matrix xy_dist  = { count, count, xy_dist_data };
-    Matrix distances = { count, count, dist_data };
+    double *deltas[3] = { ws->dx,    ws->dy,    ws->dz    };
+    double *sums[3]   = { ws->sum_x, ws->sum_y, ws->sum_z };
 
-    matrix_add(&dx_s, &dy_s, &xy_dist, use_gpu);
-    matrix_add(&xy_dist, &dz_s, &distances, use_gpu);
+    for (int axis = 0; axis < 3; axis++) {
+        Matrix delta = { count, count, deltas[axis] };
+        Matrix sum   = { count, 1, sums[axis] };
 
-    free(dx_s_data); free(dy_s_data); free(dz_s_data);
-    free(xy_dist_data);
+        matrix_div(&delta, &r_mat, &dir, use_gpu);        // D_hat component
+        matrix_hadamard(&forces, &dir, &fvec, use_gpu);   // F_vec component
+        matrix_row_sum(&fvec, &sum, use_gpu);             // net per body
+    }
+}
 
-    // ── Step 3: numerical safety  r²_safe = r² + I ──────────────────────────
-    // Adding I replaces each zero diagonal entry with 1, making division
-    // well-defined. The ⊙(J−I) mask in step 5 zeroes those entries afterward.
-    double *identity_data = calloc(count * count, sizeof(double));
-    for (int i = 0; i < count; i++) {
-        identity_data[i * count + i] = 1.0;
+/*
+ * The staged pipeline shared by newtonian_gravity_ws() and the softened
+ * matrix solver; GRAVITY_SOFTENING_NONE skips the softening stage.
+ */
+static void matrix_gravity(GravityWorkspace *ws, const PhysicsObject *objects,
+                           int count, GravitySoftening kind, double length,
+                           Vec3 *forces_out) {
+    if (count <= 0) return;
+
+    if (gravity_workspace_reserve(ws, count) != 0) {
+        /* Out of memory for the N×N scratch — fall back to the fused kernel. */
+        if (kind != GRAVITY_SOFTENING_NONE) {
+            newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        } else {
+            newtonian_gravity_direct(objects, count, forces_out);
+        }
+        return;
     }
-    Matrix identity = { count, count, identity_data };
 
-    double *safe_dist_data = calloc(count * count, sizeof(double));
-    Matrix safe_distances = { count, count, safe_dist_data };
+    const bool use_gpu = gravity_use_gpu(count);
 
-    matrix_add(&distances, &identity, &safe_distances, use_gpu);
+    // ── Shared: ΔX, ΔY, ΔZ and r²_safe used by both stages ──────────────────
+    compute_displacements(ws, objects, count, use_gpu);
+    compute_safe_distances(ws, count, use_gpu);
+    if (kind != GRAVITY_SOFTENING_NONE) {
+        soften_safe_distances(ws, objects, count, kind, length);
+    }
 
-    free(identity_data);
-    free(dist_data);
+    // ── Stage 1: scalar force magnitudes  F[i,j]  (N×N) ─────────────────────
+    newtonian_gravity_forces(ws, objects, count, use_gpu);
 
-    // ── Step 4: (m_n × m_n^T) ⊘ r²_safe, then scale by G ───────────────────
-    double *mass_dist_data = calloc(count * count, sizeof(double));
-    Matrix mass_distance = { count, count, mass_dist_data };
+    // ── Stages 2–4: directions, force vectors, row sums ─────────────────────
+    newtonian_gravity_directions(ws, count, use_gpu);
 
-    matrix_div(&mass_prod, &safe_distances, &mass_distance, use_gpu);
+    for (int i = 0; i < count; i++) {
+        forces_out[i].x = ws->sum_x[i];
+        forces_out[i].y = ws->sum_y[i];
+        forces_out[i].z = ws->sum_z[i];
+    }
+}
 
-    free(prod_data);
-    free(safe_dist_data);
+void newtonian_gravity_ws(GravityWorkspace *ws, const PhysicsObject *objects,
+                          int count, Vec3 *forces_out) {
+    matrix_gravity(ws, objects, count, GRAVITY_SOFTENING_NONE, 0.0, forces_out);
+}
 
-    Matrix forces = { count, count, force_data };
-    matrix_scalar_mul(&mass_distance, &g, &forces, use_gpu);
-    free(mass_dist_data);
+/*
+ * Workspace behind every entry point that takes none, and behind a NULL
+ * workspace argument. Callers sharing it must not overlap.
+ */
+static GravityWorkspace s_workspace = { .identity_count = -1 };
+
+void newtonian_gravity(const PhysicsObject *objects, int count,
+                       Vec3 *forces_out) {
+    newtonian_gravity_ws(&s_workspace, objects, count, forces_out);
+}
 
-    // ── Step 5: ⊙ (J − I) — zero diagonal (self-interaction) entries ─────────
+void newtonian_gravity_direct(const PhysicsObject *objects, int count,
+                              Vec3 *forces_out) {
+    // Each target body i owns forces_out[i], so rows parallelise without locks.
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < count; i++) {
-        force_data[i * count + i] = 0.0;
+        const double xi = objects[i].position.x;
+        const double yi = objects[i].position.y;
+        const double zi = objects[i].position.z;
+        const double gmi = g * objects[i].mass;
+
+        double fx = 0.0, fy = 0.0, fz = 0.0;
+
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue; // ⊙ (J − I): no self-interaction
+
+            // ΔP[i,j] = P_j − P_i points from body i toward body j.
+            const double dx = objects[j].position.x - xi;
+            const double dy = objects[j].position.y - yi;
+            const double dz = objects[j].position.z - zi;
+
+            // G m_i m_j / r² along the unit direction ΔP / r  →  ΔP · G m_i m_j / r³
+            const double r2    = dx * dx + dy * dy + dz * dz;
+            const double inv_r = 1.0 / sqrt(r2);
+            const double s     = gmi * objects[j].mass * inv_r * inv_r * inv_r;
+
+            fx += s * dx;
+            fy += s * dy;
+            fz += s * dz;
+        }
+
+        forces_out[i].x = fx;
+        forces_out[i].y = fy;
+        forces_out[i].z = fz;
     }
 }
 
-/**
- * Computes the N×N unit direction tensor D_hat (see §Force Direction Vector
- * — Final Form) where each element is the unit vector pointing from body i
- * toward body j:
- *
- *   D[i,j]      = [ΔX[i,j], ΔY[i,j], ΔZ[i,j]]   (displacement vector)
- *   r[i,j]      = sqrt(ΔX² + ΔY² + ΔZ²)           (scalar distance)
- *   D_hat[i,j]  = D[i,j] / r[i,j]                  (unit direction)
- *
- * Numerical safety: r²_safe = r² + I prevents 0/0 on the diagonal.
- * Because ΔX[i,i] = 0, the diagonal of D_hat is 0/sqrt(1) = 0, which is
- * consistent with the force matrix's zeroed diagonal.
- *
- * @param objects    Input array of physics objects.
- * @param count      Number of objects (N).
- * @param directions Pre-allocated Matrix3 of N×N component matrices (x, y, z)
- *                   that will receive the unit direction vectors.
- * @param use_gpu    If true, use the CUDA backend; otherwise Fortran.
+/*
+ * Accumulates row i of the upper triangle (j > i) into buf, applying ±F.
+ * The softening switch is loop-invariant; with GRAVITY_SOFTENING_NONE the
+ * kernel reduces to the plain 1/r³ factor.
  */
-static void newtonian_gravity_directions(int count, Matrix3 *directions, bool use_gpu,
-                                         const double *dx_data, const double *dy_data, const double *dz_data) {
-
-    // ── Step 1: squared distances  r²[i,j] = ΔX² + ΔY² + ΔZ²  (N×N) ───────
-    double *dx_s_data = calloc(count * count, sizeof(double));
-    double *dy_s_data = calloc(count * count, sizeof(double));
-    double *dz_s_data = calloc(count * count, sizeof(double));
+static inline void symmetric_row(const PhysicsObject *objects, int count,
+                                 int i, GravitySoftening kind, double length,
+                                 Vec3 *buf) {
+    const double xi = objects[i].position.x;
+    const double yi = objects[i].position.y;
+    const double zi = objects[i].position.z;
+    const double gmi = g * objects[i].mass;
+
+    double fx = 0.0, fy = 0.0, fz = 0.0;
+
+    for (int j = i + 1; j < count; j++) {
+        const double dx = objects[j].position.x - xi;
+        const double dy = objects[j].position.y - yi;
+        const double dz = objects[j].position.z - zi;
+
+        const double r2  = dx * dx + dy * dy + dz * dz;
+        const double eps = kind == GRAVITY_SOFTENING_NONE
+                         ? 0.0 : softening_pair_length(&objects[i], &objects[j], length);
+        const double s   = gmi * objects[j].mass * softening_inv_r3(r2, eps, kind);
+
+        // F[i,j] = −F[j,i]: one evaluation serves both bodies.
+        fx += s * dx;
+        fy += s * dy;
+        fz += s * dz;
+        buf[j].x -= s * dx;
+        buf[j].y -= s * dy;
+        buf[j].z -= s * dz;
+    }
 
-    Matrix dx = { count, count, (double *)dx_data };
-    Matrix dy = { count, count, (double *)dy_data };
-    Matrix dz = { count, count, (double *)dz_data };
-    Matrix dx_s = { count, count, dx_s_data };
-    Matrix dy_s = { count, count, dy_s_data };
-    Matrix dz_s = { count, count, dz_s_data };
+    buf[i].x += fx;
+    buf[i].y += fy;
+    buf[i].z += fz;
+}
 
-    matrix_power(&dx, &power, &dx_s, use_gpu);
-    matrix_power(&dy, &power, &dy_s, use_gpu);
-    matrix_power(&dz, &power, &dz_s, use_gpu);
+/*
+ * Per-thread force accumulators live in ws->partial, laid out as
+ * [thread][body] and grown only when the thread count or N rises.
+ */
+static void symmetric_gravity(GravityWorkspace *ws, const PhysicsObject *objects,
+                              int count, GravitySoftening kind, double length,
+                              Vec3 *forces_out) {
+    if (count < 2) {
+        for (int i = 0; i < count; i++) forces_out[i] = (Vec3){0.0, 0.0, 0.0};
+        return;
+    }
 
-    double *xy_dist_data = calloc(count * count, sizeof(double));
-    double *dist_data    = calloc(count * count, sizeof(double));
+#ifdef _OPENMP
+    const int threads = omp_get_max_threads();
+#else
+    const int threads = 1;
+#endif
 
-    Matrix xy_dist   = { count, count, xy_dist_data };
-    Matrix distances = { count, count, dist_data };
+    size_t needed = (size_t)threads * (size_t)count;
+    if (needed > ws->partial_capacity) {
+        Vec3 *grown = realloc(ws->partial, needed * sizeof(Vec3));
+        if (!grown) {
+            /* Out of memory for the accumulators — fall back to the row kernel. */
+            if (kind != GRAVITY_SOFTENING_NONE)
+                newtonian_gravity_softened(objects, count, kind, length, forces_out);
+            else
+                newtonian_gravity_direct(objects, count, forces_out);
+            return;
+        }
+        ws->partial          = grown;
+        ws->partial_capacity = needed;
+    }
+    Vec3 *partial = ws->partial;
+    memset(partial, 0, needed * sizeof(Vec3));
+
+    // Row i of the upper triangle holds count − 1 − i pairs, so rows k and
+    // count − 1 − k together always hold count − 1: pairing them balances a
+    // static schedule. Static scheduling fixes which thread owns each row, so
+    // for a given thread count the result is bitwise reproducible.
+    const int half_rows = (count + 1) / 2;
+
+    #pragma omp parallel num_threads(threads)
+    {
+#ifdef _OPENMP
+        Vec3 *buf = partial + (size_t)omp_get_thread_num() * count;
+#else
+        Vec3 *buf = partial;
+#endif
 
-    matrix_add(&dx_s, &dy_s, &xy_dist, use_gpu);
-    matrix_add(&xy_dist, &dz_s, &distances, use_gpu);
+        #pragma omp for schedule(static)
+        for (int k = 0; k < half_rows; k++) {
+            symmetric_row(objects, count, k, kind, length, buf);
+            if (count - 1 - k != k) {
+                symmetric_row(objects, count, count - 1 - k, kind, length, buf);
+            }
+        }
+
+        // Deterministic reduction: every body sums thread buffers in thread
+        // order, independent of which thread finished first.
+        #pragma omp for schedule(static)
+        for (int i = 0; i < count; i++) {
+            Vec3 f = partial[i];
+            for (int t = 1; t < threads; t++) {
+                f = vec3_add(f, partial[(size_t)t * count + i]);
+            }
+            forces_out[i] = f;
+        }
+    }
+}
 
-    free(dx_s_data); free(dy_s_data); free(dz_s_data);
-    free(xy_dist_data);
+void newtonian_gravity_symmetric(const PhysicsObject *objects, int count,
+                                 Vec3 *forces_out) {
+    symmetric_gravity(&s_workspace, objects, count, GRAVITY_SOFTENING_NONE, 0.0,
+                      forces_out);
+}
 
-    // ── Step 3: numerical safety  r²_safe = r² + I ──────────────────────────
-    double *identity_data = calloc(count * count, sizeof(double));
+void newtonian_gravity_softened(const PhysicsObject *objects, int count,
+                                GravitySoftening kind, double length,
+                                Vec3 *forces_out) {
+    #pragma omp parallel for schedule(static)
     for (int i = 0; i < count; i++) {
-        identity_data[i * count + i] = 1.0;
-    }
-    Matrix identity = { count, count, identity_data };
+        const double xi = objects[i].position.x;
+        const double yi = objects[i].position.y;
+        const double zi = objects[i].position.z;
+        const double gmi = g * objects[i].mass;
 
-    double *safe_dist_data = calloc(count * count, sizeof(double));
-    Matrix safe_dist = { count, count, safe_dist_data };
+        double fx = 0.0, fy = 0.0, fz = 0.0;
 
-    matrix_add(&distances, &identity, &safe_dist, use_gpu);
-    free(identity_data);
-    free(dist_data);
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue; // ⊙ (J − I): no self-interaction
 
-    // ── Step 4: r = sqrt(r²_safe),  then D_hat[i,j] = D[i,j] / r[i,j] ──────
-    double *r_data = calloc(count * count, sizeof(double));
-    Matrix r_mat = { count, count, r_data };
+            const double dx = objects[j].position.x - xi;
+            const double dy = objects[j].position.y - yi;
+            const double dz = objects[j].position.z - zi;
 
-    matrix_power(&safe_dist, &half, &r_mat, use_gpu);
-    free(safe_dist_data);
+            // G m_i m_j ΔP g(r), with g(r) = 1/r³ outside the softening core.
+            const double r2  = dx * dx + dy * dy + dz * dz;
+            const double eps = softening_pair_length(&objects[i], &objects[j], length);
+            const double s   = gmi * objects[j].mass * softening_inv_r3(r2, eps, kind);
 
-    // Divide each displacement component by r to obtain the unit direction.
-    // Output matrices are pre-allocated N×N and owned by the caller.
-    matrix_div(&dx, &r_mat, &directions->x, use_gpu);
-    matrix_div(&dy, &r_mat, &directions->y, use_gpu);
-    matrix_div(&dz, &r_mat, &directions->z, use_gpu);
+            fx += s * dx;
+            fy += s * dy;
+            fz += s * dz;
+        }
 
-    free(r_data);
+        forces_out[i].x = fx;
+        forces_out[i].y = fy;
+        forces_out[i].z = fz;
+    }
 }
 
-void newtonian_gravity(const PhysicsObject *objects, int count,
-                       Vec3 *forces_out) {
+void newtonian_gravity_world(const PhysicsWorld *world, GravitySoftening kind,
+                             double length, Vec3 *forces_out) {
+    const int     count = world->count;
+    const double *mass  = world->mass;
+    const Vec3   *pos   = world->position;
+    const double *soft  = world->softening;
 
-    const bool use_gpu = gravity_use_gpu(count);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const double xi = pos[i].x;
+        const double yi = pos[i].y;
+        const double zi = pos[i].z;
+        const double gmi = g * mass[i];
+
+        double fx = 0.0, fy = 0.0, fz = 0.0;
+
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue; // ⊙ (J − I): no self-interaction
+
+            const double dx = pos[j].x - xi;
+            const double dy = pos[j].y - yi;
+            const double dz = pos[j].z - zi;
+
+            const double r2 = dx * dx + dy * dy + dz * dz;
+            double s;
+            if (kind == GRAVITY_SOFTENING_NONE) {
+                const double inv_r = 1.0 / sqrt(r2);
+                s = gmi * mass[j] * inv_r * inv_r * inv_r;
+            } else {
+                const double eps = softening_combine(soft[i], soft[j], length);
+                s = gmi * mass[j] * softening_inv_r3(r2, eps, kind);
+            }
+
+            fx += s * dx;
+            fy += s * dy;
+            fz += s * dz;
+        }
+
+        forces_out[i].x = fx;
+        forces_out[i].y = fy;
+        forces_out[i].z = fz;
+    }
+}
 
-    // ── Shared: displacement matrices ΔX, ΔY, ΔZ used by both stages ─────────
-    double *dx_data, *dy_data, *dz_data;
-    compute_displacements(objects, count, use_gpu, &dx_data, &dy_data, &dz_data);
+void gravity_acc_jerk(const Vec3 *pos, const Vec3 *vel, const double *mass,
+                      const double *soft, int count, const int *targets,
+                      int n_targets, GravitySoftening kind, double length,
+                      Vec3 *acc_out, Vec3 *jerk_out) {
+    const int n = targets ? n_targets : count;
+
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < n; k++) {
+        const int i = targets ? targets[k] : k;
+        const Vec3 pi = pos[i], vi = vel[i];
+        const double ei = soft ? soft[i] : 0.0;
+
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        double jx = 0.0, jy = 0.0, jz = 0.0;
+
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue;
+
+            const double dx = pos[j].x - pi.x, dy = pos[j].y - pi.y, dz = pos[j].z - pi.z;
+            const double dvx = vel[j].x - vi.x, dvy = vel[j].y - vi.y, dvz = vel[j].z - vi.z;
+
+            const double r2  = dx * dx + dy * dy + dz * dz;
+            const double rv  = dx * dvx + dy * dvy + dz * dvz;
+            const double eps = kind == GRAVITY_SOFTENING_NONE
+                             ? 0.0 : softening_combine(ei, soft ? soft[j] : 0.0, length);
+
+            const double mg  = mass[j] * softening_inv_r3(r2, eps, kind);
+            const double mdg = mass[j] * softening_dg_over_r(r2, eps, kind) * rv;
+
+            ax += mg * dx;
+            ay += mg * dy;
+            az += mg * dz;
+            jx += mg * dvx + mdg * dx;
+            jy += mg * dvy + mdg * dy;
+            jz += mg * dvz + mdg * dz;
+        }
+
+        acc_out[i]  = (Vec3){g * ax, g * ay, g * az};
+        jerk_out[i] = (Vec3){g * jx, g * jy, g * jz};
+    }
+}
 
-    // ── Stage 1: scalar force magnitudes  F[i,j]  (N×N) ─────────────────────
-    double *force_data = calloc(count * count, sizeof(double));
-    newtonian_gravity_forces(objects, count, force_data, use_gpu, dx_data, dy_data, dz_data);
-
-    // ── Stage 2: unit direction tensor  D_hat[i,j]  (N×N×3) ─────────────────
-    double *dir_x_data = calloc(count * count, sizeof(double));
-    double *dir_y_data = calloc(count * count, sizeof(double));
-    double *dir_z_data = calloc(count * count, sizeof(double));
-
-    Matrix3 directions = {
-        .x = { count, count, dir_x_data },
-        .y = { count, count, dir_y_data },
-        .z = { count, count, dir_z_data },
-    };
+#define GRAVITY_MIXED_CHUNK 256 /* float pair terms buffered per target before widening */
 
-    newtonian_gravity_directions(count, &directions, use_gpu, dx_data, dy_data, dz_data);
-    free(dx_data); free(dy_data); free(dz_data);
+/*
+ * Float staging lives in ws->mixed as eight arrays of ws->mixed_capacity:
+ * positions relative to the centroid in units of the cloud radius R, each
+ * split into a float head and the float rounding of its remainder; masses in
+ * units of the largest mass; softening lengths in units of R.
+ */
+static void mixed_gravity(GravityWorkspace *ws, const PhysicsObject *objects,
+                          int count, GravitySoftening kind, double length,
+                          Vec3 *forces_out) {
+    for (int i = 0; i < count; i++) forces_out[i] = (Vec3){0.0, 0.0, 0.0};
+    if (count < 2) return;
+
+    // Local origin and scales in double, so every float below is O(1) and
+    // neither absolute coordinates nor SI masses reach float range limits.
+    Vec3 origin = {0.0, 0.0, 0.0};
+    double m_max = 0.0;
+    for (int i = 0; i < count; i++) {
+        origin = vec3_add(origin, objects[i].position);
+        if (objects[i].mass > m_max) m_max = objects[i].mass;
+    }
+    origin = vec3_scale(origin, 1.0 / count);
 
-    // ── Stage 3: F_vec[i,j] = F[i,j] ⊙ D_hat[i,j]  (Hadamard per component) ─
-    Matrix forces = { count, count, force_data };
+    double radius = 0.0;
+    for (int i = 0; i < count; i++) {
+        double d = vec3_magnitude(vec3_sub(objects[i].position, origin));
+        if (d > radius) radius = d;
+    }
+    if (radius == 0.0 || m_max == 0.0) {
+        /* Every body coincident or massless: nothing to scale by. */
+        newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        return;
+    }
 
-    double *fvec_x_data = calloc(count * count, sizeof(double));
-    double *fvec_y_data = calloc(count * count, sizeof(double));
-    double *fvec_z_data = calloc(count * count, sizeof(double));
+    if (count > ws->mixed_capacity) {
+        float *block = malloc((size_t)count * 8 * sizeof(float));
+        if (!block) {
+            /* Out of memory for the staging buffers — fall back to double. */
+            newtonian_gravity_softened(objects, count, kind, length, forces_out);
+            return;
+        }
+        free(ws->mixed);
+        ws->mixed          = block;
+        ws->mixed_capacity = count;
+    }
 
-    Matrix fvec_x = { count, count, fvec_x_data };
-    Matrix fvec_y = { count, count, fvec_y_data };
-    Matrix fvec_z = { count, count, fvec_z_data };
+    const size_t stride = (size_t)ws->mixed_capacity;
+    float *x  = ws->mixed,      *y  = x + stride,     *z  = x + 2 * stride;
+    float *lx = x + 3 * stride, *ly = x + 4 * stride, *lz = x + 5 * stride;
+    float *m  = x + 6 * stride, *e  = x + 7 * stride;
 
-    matrix_hadamard(&forces, &directions.x, &fvec_x, use_gpu);
-    matrix_hadamard(&forces, &directions.y, &fvec_y, use_gpu);
-    matrix_hadamard(&forces, &directions.z, &fvec_z, use_gpu);
+    const double inv_radius = 1.0 / radius;
+    for (int i = 0; i < count; i++) {
+        const double u = (objects[i].position.x - origin.x) * inv_radius;
+        const double v = (objects[i].position.y - origin.y) * inv_radius;
+        const double w = (objects[i].position.z - origin.z) * inv_radius;
+        x[i]  = (float)u;
+        y[i]  = (float)v;
+        z[i]  = (float)w;
+        lx[i] = (float)(u - x[i]);
+        ly[i] = (float)(v - y[i]);
+        lz[i] = (float)(w - z[i]);
+        m[i]  = (float)(objects[i].mass / m_max);
+        e[i]  = (float)(softening_length_of(&objects[i], length) * inv_radius);
+    }
 
-    free(force_data);
-    free(dir_x_data); free(dir_y_data); free(dir_z_data);
+    // Undo the unit change: F = G m_i m_max / R² · Σ_j m'_j ΔP' / r'³.
+    const double scale = g * m_max * inv_radius * inv_radius;
 
-    // ── Stage 4: F(i) = Σ_j F_vec[i,j]  (row sum → net force per body) ──────
-    double *sum_x_data = calloc(count, sizeof(double));
-    double *sum_y_data = calloc(count, sizeof(double));
-    double *sum_z_data = calloc(count, sizeof(double));
+    // Plummer folds ε² into the float r²; the spline's core pairs (r < 2.8 ε,
+    // few in any scene) are redone after the chunk with the double kernel.
+    const int plummer = kind == GRAVITY_SOFTENING_PLUMMER;
+    const int spline  = kind == GRAVITY_SOFTENING_SPLINE;
 
-    Matrix sum_x = { count, 1, sum_x_data };
-    Matrix sum_y = { count, 1, sum_y_data };
-    Matrix sum_z = { count, 1, sum_z_data };
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const float xi = x[i], yi = y[i], zi = z[i];
+        const float lxi = lx[i], lyi = ly[i], lzi = lz[i], ei = e[i];
+        double fx = 0.0, fy = 0.0, fz = 0.0;
+
+        // Pair terms are produced a chunk at a time in pure float (a mixed
+        // float/double loop does not vectorise), then widened and added to
+        // the double accumulators one by one.
+        float tx[GRAVITY_MIXED_CHUNK], ty[GRAVITY_MIXED_CHUNK], tz[GRAVITY_MIXED_CHUNK];
+
+        for (int j0 = 0; j0 < count; j0 += GRAVITY_MIXED_CHUNK) {
+            const int len = count - j0 < GRAVITY_MIXED_CHUNK ? count - j0 : GRAVITY_MIXED_CHUNK;
+
+            #pragma omp simd
+            for (int k = 0; k < len; k++) {
+                const int j = j0 + k;
+                // Re-centre on body i: heads of nearby bodies subtract
+                // exactly (Sterbenz), and the remainders restore the digits
+                // the heads dropped, so a close pair keeps float precision
+                // however far it sits from the centroid.
+                const float dx = (x[j] - xi) + (lx[j] - lxi);
+                const float dy = (y[j] - yi) + (ly[j] - lyi);
+                const float dz = (z[j] - zi) + (lz[j] - lzi);
+                const float r2 = dx * dx + dy * dy + dz * dz;
+                const float ej = plummer ? fmaxf(ei, e[j]) : 0.0f;
+
+                // r² = 0 only for the self term (and coincident bodies):
+                // substitute r² = 1 and zero the weight, branch-free.
+                const float live  = (float)(r2 > 0.0f);
+                const float inv_r = 1.0f / sqrtf(r2 + ej * ej + (1.0f - live));
+                const float w     = live * m[j] * inv_r * inv_r * inv_r;
+
+                tx[k] = w * dx;
+                ty[k] = w * dy;
+                tz[k] = w * dz;
+            }
+
+            if (spline) {
+                for (int k = 0; k < len; k++) {
+                    const int j = j0 + k;
+                    const float dx = (x[j] - xi) + (lx[j] - lxi);
+                    const float dy = (y[j] - yi) + (ly[j] - lyi);
+                    const float dz = (z[j] - zi) + (lz[j] - lzi);
+                    const float r2 = dx * dx + dy * dy + dz * dz;
+                    const double eps = fmaxf(ei, e[j]);
+                    const double support = SOFTENING_SPLINE_SUPPORT * eps;
+                    if (r2 <= 0.0f || r2 >= support * support) continue;
+
+                    const float w = (float)(m[j] * softening_inv_r3(r2, eps, kind));
+                    tx[k] = w * dx;
+                    ty[k] = w * dy;
+                    tz[k] = w * dz;
+                }
+            }
+
+            for (int k = 0; k < len; k++) {
+                fx += (double)tx[k];
+                fy += (double)ty[k];
+                fz += (double)tz[k];
+            }
+        }
+
+        const double s = scale * objects[i].mass;
+        forces_out[i] = (Vec3){s * fx, s * fy, s * fz};
+    }
+}
 
-    matrix_row_sum(&fvec_x, &sum_x, use_gpu);
-    matrix_row_sum(&fvec_y, &sum_y, use_gpu);
-    matrix_row_sum(&fvec_z, &sum_z, use_gpu);
+void newtonian_gravity_mixed(const PhysicsObject *objects, int count,
+                             Vec3 *forces_out) {
+    mixed_gravity(&s_workspace, objects, count, GRAVITY_SOFTENING_NONE, 0.0,
+                  forces_out);
+}
 
-    free(fvec_x_data); free(fvec_y_data); free(fvec_z_data);
+void newtonian_gravity_mixed_softened(const PhysicsObject *objects, int count,
+                                      GravitySoftening kind, double length,
+                                      Vec3 *forces_out) {
+    mixed_gravity(&s_workspace, objects, count, kind, length, forces_out);
+}
+
+void gravity_config_default(GravityConfig *config) {
+    config->solver = GRAVITY_SOLVER_DIRECT;
+    config->theta  = 0.5;
+    config->fmm_order = 4;
+    config->pm_grid   = 64;
+    config->pm_assignment = PM_ASSIGN_TSC;
+    config->tile_size     = 0;
+    config->softening        = GRAVITY_SOFTENING_NONE;
+    config->softening_length = 0.0;
+}
+
+void gravity_compute_ws(GravityWorkspace *ws, const GravityConfig *config,
+                        const PhysicsObject *objects, int count, Vec3 *forces_out) {
+    GravityConfig defaults;
+    if (!config) {
+        gravity_config_default(&defaults);
+        config = &defaults;
+    }
+    if (!ws) ws = &s_workspace;
+
+    const GravitySoftening kind   = config->softening;
+    const double           length = config->softening_length;
+
+    switch (config->solver) {
+    case GRAVITY_SOLVER_MATRIX:
+        matrix_gravity(ws, objects, count, kind, length, forces_out);
+        return;
+    case GRAVITY_SOLVER_BARNES_HUT: {
+        BHTree *tree = workspace_tree(ws);
+        if (tree)
+            barnes_hut_gravity_ws(tree, objects, count, config->theta, kind,
+                                  length, forces_out);
+        else
+            newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        return;
+    }
+    case GRAVITY_SOLVER_SYMMETRIC:
+        symmetric_gravity(ws, objects, count, kind, length, forces_out);
+        return;
+    case GRAVITY_SOLVER_SIMD:
+        newtonian_gravity_simd_ws(&ws->soa, gravity_simd_detect(), objects,
+                                  count, kind, length, forces_out);
+        return;
+    case GRAVITY_SOLVER_TILED:
+        newtonian_gravity_tiled_ws(&ws->soa, objects, count, config->tile_size,
+                                   kind, length, forces_out);
+        return;
+    case GRAVITY_SOLVER_FMM:
+        fmm_gravity_softened(objects, count, config->fmm_order, kind, length,
+                             forces_out);
+        return;
+    case GRAVITY_SOLVER_MIXED:
+        mixed_gravity(ws, objects, count, kind, length, forces_out);
+        return;
+    case GRAVITY_SOLVER_PM: {
+        PMWorkspace *mesh = workspace_mesh(ws);
+        if (mesh)
+            particle_mesh_gravity_ws(mesh, objects, count, config->pm_grid,
+                                     config->pm_assignment, kind, length,
+                                     forces_out);
+        else
+            newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        return;
+    }
+    case GRAVITY_SOLVER_DIRECT:
+    default:
+        if (kind != GRAVITY_SOFTENING_NONE)
+            newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        else
+            newtonian_gravity_direct(objects, count, forces_out);
+        return;
+    }
+}
 
+void gravity_compute(const GravityConfig *config, const PhysicsObject *objects,
+                     int count, Vec3 *forces_out) {
+    gravity_compute_ws(NULL, config, objects, count, forces_out);
+}
+
+void gravity_compute_world_ws(GravityWorkspace *ws, const GravityConfig *config,
+                              const PhysicsWorld *world, Vec3 *forces_out) {
+    GravityConfig defaults;
+    if (!config) {
+        gravity_config_default(&defaults);
+        config = &defaults;
+    }
+    if (!ws) ws = &s_workspace;
+
+    // The direct kernels are the same arithmetic on either layout, so only
+    // they skip staging; every other solver runs exactly as gravity_compute().
+    const int count = world->count;
+    if (config->solver == GRAVITY_SOLVER_DIRECT) {
+        newtonian_gravity_world(world, config->softening,
+                                config->softening_length, forces_out);
+        return;
+    }
+
+    if (count > ws->stage_capacity) {
+        PhysicsObject *grown = malloc((size_t)count * sizeof(PhysicsObject));
+        if (!grown) {
+            /* Out of memory for the staging array — fall back to direct. */
+            newtonian_gravity_world(world, config->softening,
+                                    config->softening_length, forces_out);
+            return;
+        }
+        free(ws->stage);
+        ws->stage          = grown;
+        ws->stage_capacity = count;
+    }
+
+    PhysicsObject *stage = ws->stage;
     for (int i = 0; i < count; i++) {
-        forces_out[i].x = sum_x_data[i];
-        forces_out[i].y = sum_y_data[i];
-        forces_out[i].z = sum_z_data[i];
+        PhysicsObject *obj = &stage[i];
+        obj->mass         = world->mass[i];
+        obj->position     = world->position[i];
+        obj->velocity     = world->velocity[i];
+        obj->acceleration = world->acceleration[i];
+        obj->force        = world->force[i];
+        obj->softening    = world->softening[i];
+        obj->mesh_id      = world->mesh_id[i];
     }
+    gravity_compute_ws(ws, config, stage, count, forces_out);
+}
 
-    free(sum_x_data);
-    free(sum_y_data);
-    free(sum_z_data);
+void gravity_compute_world(const GravityConfig *config, const PhysicsWorld *world,
+                           Vec3 *forces_out) {
+    gravity_compute_world_ws(NULL, config, world, forces_out);
 }
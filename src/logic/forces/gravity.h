@@ -6,6 +6,10 @@
  * of physics objects. Callers are responsible for pre-allocating the output
  * force array with one entry per object.
  *
+ * Several solvers share the same contract (objects in, one net force per body
+ * out). gravity_compute() selects between them by GravitySolver so callers
+ * such as sim_run() can switch solvers and cross-check results.
+ *
  * @author Steven Kight
  * @date 2026-04-09
  */
@@ -14,11 +18,147 @@
 #define GRAVITY_H
 
 #include "../../models/object.h"
+#include "../../models/world.h"
+
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Newtonian gravitational constant G (m³ kg⁻¹ s⁻²), shared by every solver. */
+#define GRAVITATIONAL_CONSTANT 6.67430e-11
+
+/** Selects the algorithm used to evaluate gravitational forces. */
+typedef enum {
+    GRAVITY_SOLVER_MATRIX = 0, /**< Staged N×N matrix pipeline (Fortran/CUDA). */
+    GRAVITY_SOLVER_DIRECT,     /**< Fused single-pass pair loop (CPU, O(N) memory). */
+    GRAVITY_SOLVER_BARNES_HUT, /**< O(N log N) octree approximation (see barnes_hut.h). */
+    GRAVITY_SOLVER_FMM,        /**< O(N) fast multipole method (see fmm.h). */
+    GRAVITY_SOLVER_PM,         /**< Particle-mesh FFT Poisson solve (see particle_mesh.h). */
+    GRAVITY_SOLVER_SYMMETRIC,  /**< Direct sum over i<j pairs only, ±F to both bodies. */
+    GRAVITY_SOLVER_SIMD,       /**< Direct sum, AVX2/AVX-512 SoA kernel (see gravity_simd.h). */
+    GRAVITY_SOLVER_TILED,      /**< Direct sum, cache-blocked for large N (see gravity_tiled.h). */
+    GRAVITY_SOLVER_MIXED,      /**< Direct sum, float pair math with double accumulation. */
+} GravitySolver;
+
+/** Gravitational softening kernel (see softening.h). */
+typedef enum {
+    GRAVITY_SOFTENING_NONE = 0, /**< Point masses: exact 1/r² at all ranges. */
+    GRAVITY_SOFTENING_PLUMMER,  /**< 1/(r² + ε²)^{3/2}; smooth, weakens all ranges slightly. */
+    GRAVITY_SOFTENING_SPLINE,   /**< Cubic spline, support 2.8 ε; exactly Newtonian beyond. */
+} GravitySoftening;
+
+/** Particle-mesh mass-assignment / force-interpolation kernel (see particle_mesh.h). */
+typedef enum {
+    PM_ASSIGN_CIC = 0, /**< Cloud-in-cell: linear weights over 2 nodes per axis. */
+    PM_ASSIGN_TSC,     /**< Triangular-shaped cloud: quadratic weights over 3 nodes. */
+} PMAssignment;
+
+/**
+ * @brief Solver selection plus the tunables each solver reads.
+ *
+ * Fields that do not apply to the selected solver are ignored. Initialise
+ * with gravity_config_default() and override only what a scene needs.
+ */
+typedef struct {
+    GravitySolver solver; /**< Algorithm to run. */
+    double theta;         /**< Barnes–Hut opening angle; 0 = exact, ~0.5 typical. */
+    int fmm_order;        /**< FMM expansion order p; higher = more accurate. */
+    int pm_grid;          /**< Particle-mesh cells per axis (power of two). */
+    PMAssignment pm_assignment; /**< Particle-mesh deposit/interpolation kernel. */
+    int tile_size;        /**< Tiled solver source tile in bodies; 0 = auto from L1. */
+    GravitySoftening softening; /**< Close-encounter kernel, honoured by every solver. */
+    double softening_length;    /**< Global ε (m), used where PhysicsObject.softening is 0. */
+} GravityConfig;
+
+#define GRAVITY_WS_SQUARE 9 /* N×N buffers owned by a GravityWorkspace */
+#define GRAVITY_WS_VECTOR 8 /* length-N buffers owned by a GravityWorkspace */
+
+/**
+ * @brief Positions, masses and resolved softening lengths as separate arrays.
+ *
+ * Staging for the SIMD and tiled direct-sum kernels, which stream each
+ * component contiguously. e[i] is body i's own softening length, else the
+ * global one. Zero-initialise before first use; grown by gravity_soa_reserve().
+ */
+typedef struct {
+    double *x, *y, *z, *m, *e;
+    int capacity; /**< Entries in each array. */
+} GravitySoA;
+
+struct BHTree;      /* barnes_hut.h */
+struct PMWorkspace; /* particle_mesh.h */
+
+/**
+ * @brief Scratch buffers and cached state for every solver, reused across ticks.
+ *
+ * newtonian_gravity() needs several N×N intermediates per call, and the other
+ * solvers keep trees, staging arrays and FFT grids between calls. A workspace
+ * owns all of them so steady-state ticks perform no allocation: buffers grow
+ * only when N exceeds the current capacity and are otherwise reused as-is.
+ * Calls on different workspaces share nothing, so each simulation (or thread)
+ * holding its own may run concurrently. Initialise with
+ * gravity_workspace_init() and release with gravity_workspace_free(); fields
+ * are internal to the solver modules.
+ */
+typedef struct {
+    int capacity;       /**< Largest N the matrix buffers can hold (0 = none). */
+    int identity_count; /**< N the identity matrix was last built for. */
+
+    double *block;      /**< Single allocation backing all N×N buffers. */
+    double *vec_block;  /**< Single allocation backing all length-N buffers. */
+
+    double *dx, *dy, *dz;          /**< Displacements ΔP[i,j] = P_j − P_i. */
+    double *r2_safe;               /**< r² + I. */
+    double *force;                 /**< Scalar force magnitudes F[i,j]. */
+    double *identity;              /**< I, rebuilt only when N changes. */
+    double *tmp_a, *tmp_b, *tmp_c; /**< Stage-local intermediates. */
+
+    double *x, *y, *z, *mass, *ones;  /**< Per-body inputs. */
+    double *sum_x, *sum_y, *sum_z;    /**< Per-body row sums (net force). */
+
+    Vec3   *partial;          /**< Symmetric solver's [thread][body] accumulators. */
+    size_t  partial_capacity; /**< Entries in partial. */
+    float  *mixed;            /**< Mixed-precision staging: 8 float arrays. */
+    int     mixed_capacity;   /**< Bodies each mixed array holds. */
+    GravitySoA soa;           /**< SIMD and tiled staging. */
+    PhysicsObject *stage;     /**< World kinematics for non-direct solvers. */
+    int     stage_capacity;   /**< Entries in stage. */
+
+    struct BHTree      *tree; /**< Barnes–Hut node pool; allocated on first use. */
+    struct PMWorkspace *mesh; /**< Particle-mesh grids; allocated on first use. */
+} GravityWorkspace;
+
+/** @brief Initialise an empty workspace (no allocation until first use). */
+void gravity_workspace_init(GravityWorkspace *ws);
+
+/** @brief Release all buffers and reset @p ws to the empty state. */
+void gravity_workspace_free(GravityWorkspace *ws);
+
+/**
+ * @brief Ensure the matrix buffers of @p ws can hold @p count bodies.
+ *
+ * Never shrinks. On growth the old buffers are discarded (their contents are
+ * per-call scratch).
+ *
+ * @return 0 on success, -1 on allocation failure (matrix buffers
+ *         left empty).
+ */
+int gravity_workspace_reserve(GravityWorkspace *ws, int count);
+
+/**
+ * @brief Ensure @p soa holds at least @p count entries per array.
+ *
+ * Never shrinks; contents are discarded on growth.
+ *
+ * @return 0 on success, -1 on allocation failure (@p soa unchanged).
+ */
+int gravity_soa_reserve(GravitySoA *soa, int count);
+
+/** @brief Release the arrays of @p soa and reset it to empty. */
+void gravity_soa_free(GravitySoA *soa);
+
 /**
  * @brief Computes the net Newtonian gravitational force vector on each body.
  *
@@ -30,6 +170,9 @@ extern "C" {
  *   Stage 3 — force vectors:      F_vec[i,j] = F[i,j] ⊙ D_hat[i,j]         (N×N×3)
  *   Stage 4 — net per body:       F(i)       = Σ_j F_vec[i,j]
  *
+ * Intermediates live in the shared GravityWorkspace (see gravity_compute_ws()),
+ * so repeated ticks at the same N allocate nothing.
+ *
  * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
  * @param count      Number of objects (N).
  * @param forces_out Pre-allocated array of @p count Vec3 values that will
@@ -39,6 +182,258 @@ extern "C" {
 void newtonian_gravity(const PhysicsObject *objects, int count,
                        Vec3 *forces_out);
 
+/**
+ * @brief newtonian_gravity() with caller-owned scratch buffers.
+ *
+ * Identical results to newtonian_gravity(), which is a thin wrapper over this
+ * function with the shared workspace.
+ *
+ * @param ws         Workspace; grown to @p count if needed. Must not be NULL.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_ws(GravityWorkspace *ws, const PhysicsObject *objects,
+                          int count, Vec3 *forces_out);
+
+/**
+ * @brief Computes the same net forces as newtonian_gravity() in a single pass.
+ *
+ * Walks every (i, j) pair once per target body, accumulating the three force
+ * components in registers:
+ *
+ *   F(i) = Σ_{j≠i} G m_i m_j ΔP[i,j] / |ΔP[i,j]|³
+ *
+ * No N×N intermediates are allocated — only @p forces_out is written — so
+ * memory traffic is O(N) instead of O(N²). Target bodies are distributed
+ * across OpenMP threads; each thread writes only its own rows.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values that will
+ *                   receive the net gravitational force on each body (Newtons).
+ *                   Must not be NULL.
+ */
+void newtonian_gravity_direct(const PhysicsObject *objects, int count,
+                              Vec3 *forces_out);
+
+/**
+ * @brief Computes the same net forces as newtonian_gravity_direct() from half
+ *        the pair evaluations.
+ *
+ * Newton's third law gives F[j,i] = −F[i,j], so only pairs with i < j are
+ * evaluated and each result is applied to both bodies:
+ *
+ *   F(i) += G m_i m_j ΔP[i,j] / |ΔP[i,j]|³,   F(j) −= (same)
+ *
+ * Scattering into F(j) would race across OpenMP threads, so each thread
+ * accumulates into a private N-body buffer and the buffers are summed per
+ * body in thread order afterwards. Rows are statically scheduled, so results
+ * are bitwise reproducible for a fixed thread count (they may differ in the
+ * last bits from newtonian_gravity_direct() because the summation order
+ * differs). The accumulators live in the shared workspace.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_symmetric(const PhysicsObject *objects, int count,
+                                 Vec3 *forces_out);
+
+/**
+ * @brief newtonian_gravity_direct() with a softened pair kernel.
+ *
+ * Each pair uses g(r) from softening.h with ε_ij = max(ε_i, ε_j), where ε_i is
+ * PhysicsObject.softening if positive and @p length otherwise. Accelerations
+ * stay bounded as bodies approach, so close encounters no longer dictate
+ * the time step; coincident bodies feel zero force from each other.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param kind       Softening kernel; GRAVITY_SOFTENING_NONE ignores both
+ *                   lengths and gives point-mass forces.
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_softened(const PhysicsObject *objects, int count,
+                                GravitySoftening kind, double length,
+                                Vec3 *forces_out);
+
+/**
+ * @brief Accelerations and jerks of selected bodies by direct summation.
+ *
+ * For each target i (every body when @p targets is NULL):
+ *
+ *   a_i = G Σ_{j≠i} m_j ΔP g(r)
+ *   ȧ_i = G Σ_{j≠i} m_j [ ΔV g(r) + ΔP (ΔP·ΔV) (dg/dr)/r ]
+ *
+ * with ΔP = P_j − P_i, ΔV = V_j − V_i and g the softened pair factor from
+ * softening.h (1/r³ when @p kind is GRAVITY_SOFTENING_NONE). Sources are
+ * always all @p count bodies, so individual-timestep integrators can refresh
+ * only their active bodies against predicted positions of the rest.
+ *
+ * Inputs are plain arrays rather than PhysicsObject so callers can pass
+ * predicted states without copying whole objects.
+ *
+ * @param pos        Positions (m), @p count entries.
+ * @param vel        Velocities (m/s), @p count entries.
+ * @param mass       Masses (kg), @p count entries.
+ * @param soft       Per-body softening lengths (0 = global), or NULL.
+ * @param count      Number of bodies (N).
+ * @param targets    Indices of bodies to evaluate, or NULL for all.
+ * @param n_targets  Entries in @p targets (ignored when @p targets is NULL).
+ * @param kind       Softening kernel.
+ * @param length     Global softening length ε (m).
+ * @param acc_out    Receives a_i at index i for each target (m/s²).
+ * @param jerk_out   Receives ȧ_i at index i for each target (m/s³).
+ */
+void gravity_acc_jerk(const Vec3 *pos, const Vec3 *vel, const double *mass,
+                      const double *soft, int count, const int *targets,
+                      int n_targets, GravitySoftening kind, double length,
+                      Vec3 *acc_out, Vec3 *jerk_out);
+
+/**
+ * @brief newtonian_gravity_direct() / newtonian_gravity_softened() over a
+ *        PhysicsWorld.
+ *
+ * Reads only the world's mass, position and softening arrays, so the source
+ * loop streams 8–24 bytes per body instead of a whole PhysicsObject. The pair
+ * arithmetic is identical to the PhysicsObject kernels, so results match them
+ * bitwise for the same bodies.
+ *
+ * @param world      World to evaluate. Must not be NULL.
+ * @param kind       Softening kernel; GRAVITY_SOFTENING_NONE gives
+ *                   newtonian_gravity_direct() forces.
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of world->count Vec3 values (Newtons).
+ */
+void newtonian_gravity_world(const PhysicsWorld *world, GravitySoftening kind,
+                             double length, Vec3 *forces_out);
+
+/** Unit roundoff of float (2⁻²⁴), the ε in the mixed-precision error bound. */
+#define GRAVITY_MIXED_EPSILON 5.9604644775390625e-8
+
+/**
+ * @brief Direct-sum forces with float pair math and double accumulation.
+ *
+ * Positions are re-expressed relative to the centroid c (unweighted mean
+ * position) in units of the cloud radius R = max_i |P_i − c|, and masses
+ * relative to the largest mass, so all float operands are O(1). Each
+ * coordinate is stored as a float head plus the float rounding of its
+ * remainder. Every displacement is re-centred on its target body from these
+ * pairs: the heads of nearby bodies subtract exactly and the remainders
+ * restore the dropped digits. Inverse distances and pair weights are then
+ * computed in float — twice the SIMD width of double — while each body's
+ * running sum and all PhysicsObject state remain double.
+ *
+ * Error bound: each displacement component is off by at most 2ε of itself
+ * plus 4ε² R, and the pair arithmetic adds ~10ε, so each pair term obeys
+ *
+ *   |F_ij,mixed − F_ij| ≤ ε (20 + 32 ε R / r_ij) |F_ij|,   ε = GRAVITY_MIXED_EPSILON
+ *
+ * and the net force error on body i is at most the sum of these over j. The
+ * cloud size only matters once R / r_ij nears 1/ε ≈ 1.7e7; below that the
+ * relative error of every pair term is ~1e-6.
+ *
+ * Coincident bodies (r = 0) contribute nothing instead of producing NaN.
+ * The float staging arrays live in the shared workspace.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_mixed(const PhysicsObject *objects, int count,
+                             Vec3 *forces_out);
+
+/**
+ * @brief newtonian_gravity_mixed() with a softened pair kernel.
+ *
+ * Plummer's ε² joins the float r², so it costs nothing extra. Spline pairs
+ * inside the support 2.8 ε are redone with the double kernel from their
+ * float r²; every other pair is Newtonian and keeps the float path.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param kind       Pair kernel (see softening.h); pairs use max(ε_i, ε_j).
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_mixed_softened(const PhysicsObject *objects, int count,
+                                      GravitySoftening kind, double length,
+                                      Vec3 *forces_out);
+
+/**
+ * @brief Fill @p config with the defaults used by sim_run().
+ *
+ * Defaults: direct solver, theta = 0.5, FMM order 4, 64³ TSC particle mesh,
+ * auto-detected tile size, no softening.
+ */
+void gravity_config_default(GravityConfig *config);
+
+/**
+ * @brief Computes net gravitational forces using the selected solver.
+ *
+ * Softening is honoured by every solver within its own complexity class:
+ * the direct-sum solvers and Barnes–Hut soften each pair, FMM its P2P near
+ * field (fmm_gravity_softened()), PM its Green's function
+ * (particle_mesh_gravity_softened()) and mixed precision its float pair term
+ * (newtonian_gravity_mixed_softened()).
+ *
+ * Solver state (matrix buffers, the Barnes–Hut tree, SoA and float staging,
+ * the PM grids and Green's function) is kept in @p ws between calls. Only
+ * FMM allocates per call, since its cell lists depend on the scene.
+ *
+ * @param ws         Workspace owned by the caller, or NULL for the one shared
+ *                   with gravity_compute() and newtonian_gravity().
+ * @param config     Solver selection and tunables. NULL selects the defaults
+ *                   from gravity_config_default().
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void gravity_compute_ws(GravityWorkspace *ws, const GravityConfig *config,
+                        const PhysicsObject *objects, int count, Vec3 *forces_out);
+
+/**
+ * @brief gravity_compute_ws() with the shared workspace.
+ *
+ * @param config     Solver selection and tunables. NULL selects the defaults
+ *                   from gravity_config_default().
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void gravity_compute(const GravityConfig *config, const PhysicsObject *objects,
+                     int count, Vec3 *forces_out);
+
+/**
+ * @brief gravity_compute_ws() over a PhysicsWorld.
+ *
+ * Only the direct solver runs on the world's arrays, via
+ * newtonian_gravity_world(), which is the same arithmetic as
+ * gravity_compute() on the equivalent PhysicsObject array. Every other
+ * solver has no world-native entry point: each call copies the world's
+ * kinematics into a PhysicsObject staging array held by @p ws and runs
+ * gravity_compute_ws() on it, so the SoA layout gains nothing there.
+ *
+ * @param ws         Workspace owned by the caller, or NULL for the shared one.
+ * @param config     Solver selection and tunables. NULL selects the defaults.
+ * @param world      World to evaluate. Must not be NULL.
+ * @param forces_out Pre-allocated array of world->count Vec3 values (Newtons).
+ */
+void gravity_compute_world_ws(GravityWorkspace *ws, const GravityConfig *config,
+                              const PhysicsWorld *world, Vec3 *forces_out);
+
+/**
+ * @brief gravity_compute_world_ws() with the shared workspace.
+ *
+ * @param config     Solver selection and tunables. NULL selects the defaults.
+ * @param world      World to evaluate. Must not be NULL.
+ * @param forces_out Pre-allocated array of world->count Vec3 values (Newtons).
+ */
+void gravity_compute_world(const GravityConfig *config, const PhysicsWorld *world,
+                           Vec3 *forces_out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,364 @@
+/**
+ * @file gravity_simd.c
+ * @brief SoA direct-sum gravity kernels (scalar, AVX2, AVX-512) and dispatch.
+ *
+ * The AVX2 and AVX-512 kernels are compiled with per-function target
+ * attributes, so the library itself needs no -mavx flags and still runs on
+ * CPUs without them: dispatch only calls a kernel after CPUID confirms it.
+ *
+ * @author Steven Kight
+ */
+
+#include "gravity_simd.h"
+#include "gravity.h"
+#include "softening.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GRAVITY_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/* Widest vector in doubles; SoA buffers are padded to a multiple of this. */
+#define SIMD_PAD 8
+
+/* -------------------------------------------------------------------------- */
+/* Structure-of-arrays staging                                                */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Padding lanes hold a zero-mass body at the origin: zero mass cancels their
+ * pull, and a target sitting exactly at the origin is caught by the r > 0
+ * mask. Returns the padded count, or -1 if @p soa cannot grow.
+ */
+static int soa_load(GravitySoA *soa, const PhysicsObject *objects, int count,
+                    double length) {
+    int padded = (count + SIMD_PAD - 1) / SIMD_PAD * SIMD_PAD;
+    if (gravity_soa_reserve(soa, padded) != 0) return -1;
+
+    for (int i = 0; i < padded; i++) {
+        if (i < count) {
+            soa->x[i] = objects[i].position.x;
+            soa->y[i] = objects[i].position.y;
+            soa->z[i] = objects[i].position.z;
+            soa->m[i] = objects[i].mass;
+            soa->e[i] = softening_length_of(&objects[i], length);
+        } else {
+            soa->x[i] = soa->y[i] = soa->z[i] = soa->m[i] = 0.0;
+            soa->e[i] = length;
+        }
+    }
+    return padded;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Kernels                                                                    */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Each kernel writes the acceleration-like sum Σ_j m_j ΔP g(r) for target i,
+ * with g(r) = 1/r³ unless softened; the caller scales by G m_i. Targets are
+ * split across OpenMP threads and each thread writes only its own rows, as in
+ * newtonian_gravity_direct(). The softening switch is loop-invariant.
+ */
+
+static void kernel_scalar(const GravitySoA *soa, int count, GravitySoftening kind, Vec3 *out) {
+    const double *x = soa->x, *y = soa->y, *z = soa->z, *m = soa->m;
+    const double *e = soa->e;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (int j = 0; j < count; j++) {
+            const double dx = x[j] - x[i];
+            const double dy = y[j] - y[i];
+            const double dz = z[j] - z[i];
+            const double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 > 0.0) {
+                double s;
+                if (kind == GRAVITY_SOFTENING_NONE) {
+                    const double inv_r = 1.0 / sqrt(r2);
+                    s = m[j] * inv_r * inv_r * inv_r;
+                } else {
+                    const double eps = e[i] > e[j] ? e[i] : e[j];
+                    s = m[j] * softening_inv_r3(r2, eps, kind);
+                }
+                ax += s * dx;
+                ay += s * dy;
+                az += s * dz;
+            }
+        }
+        out[i] = (Vec3){ax, ay, az};
+    }
+}
+
+#ifdef GRAVITY_SIMD_X86
+
+/*
+ * vrsqrtps only accepts single precision, so r² outside the float normal range
+ * would overflow or flush to zero. Such vectors (separations beyond ~1e19 m or
+ * below ~1e-19 m) take an exact sqrt + divide instead; the branch is almost
+ * never taken and predicts well.
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d rsqrt_avx2(__m256d r2) {
+    const __m256d lo = _mm256_set1_pd((double)FLT_MIN * 4.0);
+    const __m256d hi = _mm256_set1_pd((double)FLT_MAX * 0.25);
+    __m256d out_of_range = _mm256_or_pd(_mm256_cmp_pd(r2, lo, _CMP_LT_OQ),
+                                        _mm256_cmp_pd(r2, hi, _CMP_GT_OQ));
+    if (_mm256_movemask_pd(out_of_range)) {
+        return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(r2));
+    }
+
+    const __m256d half  = _mm256_set1_pd(0.5);
+    const __m256d three = _mm256_set1_pd(1.5);
+    __m256d h = _mm256_mul_pd(half, r2);
+    __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2)));
+    /* ~12 bits → ~24 → ~48 */
+    y = _mm256_mul_pd(y, _mm256_fnmadd_pd(h, _mm256_mul_pd(y, y), three));
+    y = _mm256_mul_pd(y, _mm256_fnmadd_pd(h, _mm256_mul_pd(y, y), three));
+    return y;
+}
+
+__attribute__((target("avx2,fma")))
+static double hsum_avx2(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+/*
+ * Spline lanes inside the kernel support h = 2.8 ε are rare (close
+ * encounters only), so the vector kernels compute every lane as Newtonian and
+ * then recompute just those lanes with the scalar softening_inv_r3().
+ */
+static inline void spline_patch(const double *m, const double *r2,
+                                const double *eps, int live_core, int lanes,
+                                double *s) {
+    for (int k = 0; k < lanes; k++) {
+        if (live_core & (1 << k)) {
+            s[k] = m[k] * softening_inv_r3(r2[k], eps[k], GRAVITY_SOFTENING_SPLINE);
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void kernel_avx2(const GravitySoA *soa, int count, int padded, GravitySoftening kind, Vec3 *out) {
+    const double *x = soa->x, *y = soa->y, *z = soa->z, *m = soa->m;
+    const double *e = soa->e;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one  = _mm256_set1_pd(1.0);
+        const __m256d support = _mm256_set1_pd(SOFTENING_SPLINE_SUPPORT);
+        const __m256d xi = _mm256_set1_pd(x[i]);
+        const __m256d yi = _mm256_set1_pd(y[i]);
+        const __m256d zi = _mm256_set1_pd(z[i]);
+        const __m256d ei = _mm256_set1_pd(e[i]);
+        __m256d ax = zero, ay = zero, az = zero;
+
+        for (int j = 0; j < padded; j += 4) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), xi);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), yi);
+            __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), zi);
+            __m256d r2 = _mm256_fmadd_pd(dx, dx,
+                         _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+
+            /* r = 0 lanes (self, coincident, padding at the target) → 1, then masked off. */
+            __m256d live = _mm256_cmp_pd(r2, zero, _CMP_GT_OQ);
+            __m256d eps  = zero;
+            __m256d r2k  = r2;
+            if (kind != GRAVITY_SOFTENING_NONE) {
+                eps = _mm256_max_pd(ei, _mm256_loadu_pd(e + j));
+                if (kind == GRAVITY_SOFTENING_PLUMMER) {
+                    r2k = _mm256_fmadd_pd(eps, eps, r2);
+                }
+            }
+            __m256d inv_r = rsqrt_avx2(_mm256_blendv_pd(one, r2k, live));
+            __m256d inv_r3 = _mm256_mul_pd(inv_r, _mm256_mul_pd(inv_r, inv_r));
+            __m256d s = _mm256_and_pd(live,
+                        _mm256_mul_pd(_mm256_loadu_pd(m + j), inv_r3));
+
+            if (kind == GRAVITY_SOFTENING_SPLINE) {
+                __m256d h = _mm256_mul_pd(support, eps);
+                int core = _mm256_movemask_pd(_mm256_and_pd(live,
+                               _mm256_cmp_pd(r2, _mm256_mul_pd(h, h), _CMP_LT_OQ)));
+                if (core) {
+                    double r2_lanes[4], eps_lanes[4], s_lanes[4];
+                    _mm256_storeu_pd(r2_lanes, r2);
+                    _mm256_storeu_pd(eps_lanes, eps);
+                    _mm256_storeu_pd(s_lanes, s);
+                    spline_patch(m + j, r2_lanes, eps_lanes, core, 4, s_lanes);
+                    s = _mm256_loadu_pd(s_lanes);
+                }
+            }
+
+            ax = _mm256_fmadd_pd(s, dx, ax);
+            ay = _mm256_fmadd_pd(s, dy, ay);
+            az = _mm256_fmadd_pd(s, dz, az);
+        }
+        out[i] = (Vec3){hsum_avx2(ax), hsum_avx2(ay), hsum_avx2(az)};
+    }
+}
+
+__attribute__((target("avx512f")))
+static void kernel_avx512(const GravitySoA *soa, int count, int padded, GravitySoftening kind, Vec3 *out) {
+    const double *x = soa->x, *y = soa->y, *z = soa->z, *m = soa->m;
+    const double *e = soa->e;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        const __m512d zero  = _mm512_setzero_pd();
+        const __m512d one   = _mm512_set1_pd(1.0);
+        const __m512d half  = _mm512_set1_pd(0.5);
+        const __m512d three = _mm512_set1_pd(1.5);
+        const __m512d support = _mm512_set1_pd(SOFTENING_SPLINE_SUPPORT);
+        const __m512d xi = _mm512_set1_pd(x[i]);
+        const __m512d yi = _mm512_set1_pd(y[i]);
+        const __m512d zi = _mm512_set1_pd(z[i]);
+        const __m512d ei = _mm512_set1_pd(e[i]);
+        __m512d ax = zero, ay = zero, az = zero;
+
+        for (int j = 0; j < padded; j += 8) {
+            __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + j), xi);
+            __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + j), yi);
+            __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(z + j), zi);
+            __m512d r2 = _mm512_fmadd_pd(dx, dx,
+                         _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+
+            __mmask8 live = _mm512_cmp_pd_mask(r2, zero, _CMP_GT_OQ);
+            __m512d eps = zero;
+            __m512d r2k = r2;
+            if (kind != GRAVITY_SOFTENING_NONE) {
+                eps = _mm512_max_pd(ei, _mm512_loadu_pd(e + j));
+                if (kind == GRAVITY_SOFTENING_PLUMMER) {
+                    r2k = _mm512_fmadd_pd(eps, eps, r2);
+                }
+            }
+            r2k = _mm512_mask_blend_pd(live, one, r2k);
+
+            /* vrsqrt14pd works in double range; ~14 bits → ~28 → full. */
+            __m512d h = _mm512_mul_pd(half, r2k);
+            __m512d inv_r = _mm512_rsqrt14_pd(r2k);
+            inv_r = _mm512_mul_pd(inv_r, _mm512_fnmadd_pd(h, _mm512_mul_pd(inv_r, inv_r), three));
+            inv_r = _mm512_mul_pd(inv_r, _mm512_fnmadd_pd(h, _mm512_mul_pd(inv_r, inv_r), three));
+
+            __m512d inv_r3 = _mm512_mul_pd(inv_r, _mm512_mul_pd(inv_r, inv_r));
+            __m512d s = _mm512_maskz_mul_pd(live, _mm512_loadu_pd(m + j), inv_r3);
+
+            if (kind == GRAVITY_SOFTENING_SPLINE) {
+                __m512d support_h = _mm512_mul_pd(support, eps);
+                __mmask8 core = _mm512_mask_cmp_pd_mask(live, r2,
+                                    _mm512_mul_pd(support_h, support_h), _CMP_LT_OQ);
+                if (core) {
+                    double r2_lanes[8], eps_lanes[8], s_lanes[8];
+                    _mm512_storeu_pd(r2_lanes, r2);
+                    _mm512_storeu_pd(eps_lanes, eps);
+                    _mm512_storeu_pd(s_lanes, s);
+                    spline_patch(m + j, r2_lanes, eps_lanes, core, 8, s_lanes);
+                    s = _mm512_loadu_pd(s_lanes);
+                }
+            }
+
+            ax = _mm512_fmadd_pd(s, dx, ax);
+            ay = _mm512_fmadd_pd(s, dy, ay);
+            az = _mm512_fmadd_pd(s, dz, az);
+        }
+        out[i] = (Vec3){_mm512_reduce_add_pd(ax), _mm512_reduce_add_pd(ay),
+                        _mm512_reduce_add_pd(az)};
+    }
+}
+
+#endif /* GRAVITY_SIMD_X86 */
+
+/* -------------------------------------------------------------------------- */
+/* Dispatch                                                                   */
+/* -------------------------------------------------------------------------- */
+
+GravitySimdLevel gravity_simd_detect(void) {
+    static int detected = -1;
+    if (detected >= 0) return (GravitySimdLevel)detected;
+
+    detected = GRAVITY_SIMD_SCALAR;
+#ifdef GRAVITY_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        detected = GRAVITY_SIMD_AVX512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        detected = GRAVITY_SIMD_AVX2;
+    }
+#endif
+    return (GravitySimdLevel)detected;
+}
+
+const char *gravity_simd_level_name(GravitySimdLevel level) {
+    switch (level) {
+    case GRAVITY_SIMD_AVX512: return "avx512";
+    case GRAVITY_SIMD_AVX2:   return "avx2";
+    case GRAVITY_SIMD_SCALAR:
+    default:                  return "scalar";
+    }
+}
+
+void newtonian_gravity_simd_softened(GravitySimdLevel level,
+                                     const PhysicsObject *objects, int count,
+                                     GravitySoftening kind, double length,
+                                     Vec3 *forces_out) {
+    GravitySoA soa = {0};
+    newtonian_gravity_simd_ws(&soa, level, objects, count, kind, length,
+                              forces_out);
+    gravity_soa_free(&soa);
+}
+
+void newtonian_gravity_simd_ws(GravitySoA *soa, GravitySimdLevel level,
+                               const PhysicsObject *objects, int count,
+                               GravitySoftening kind, double length,
+                               Vec3 *forces_out) {
+    if (count <= 0) return;
+
+    int padded = soa_load(soa, objects, count, length);
+    if (padded < 0) {
+        /* Out of memory for the SoA buffers — fall back to the AoS kernel. */
+        newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        return;
+    }
+
+    GravitySimdLevel best = gravity_simd_detect();
+    if (level > best) level = best;
+
+    switch (level) {
+#ifdef GRAVITY_SIMD_X86
+    case GRAVITY_SIMD_AVX512:
+        kernel_avx512(soa, count, padded, kind, forces_out);
+        break;
+    case GRAVITY_SIMD_AVX2:
+        kernel_avx2(soa, count, padded, kind, forces_out);
+        break;
+#endif
+    default:
+        kernel_scalar(soa, count, kind, forces_out);
+        break;
+    }
+
+    /* Kernels return Σ_j m_j ΔP g(r); scale each row by G m_i. */
+    for (int i = 0; i < count; i++) {
+        forces_out[i] = vec3_scale(forces_out[i], GRAVITATIONAL_CONSTANT * objects[i].mass);
+    }
+}
+
+void newtonian_gravity_simd_level(GravitySimdLevel level,
+                                  const PhysicsObject *objects, int count,
+                                  Vec3 *forces_out) {
+    newtonian_gravity_simd_softened(level, objects, count,
+                                    GRAVITY_SOFTENING_NONE, 0.0, forces_out);
+}
+
+void newtonian_gravity_simd(const PhysicsObject *objects, int count,
+                            Vec3 *forces_out) {
+    newtonian_gravity_simd_level(gravity_simd_detect(), objects, count,
+                                 forces_out);
+}
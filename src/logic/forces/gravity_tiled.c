@@ -0,0 +1,157 @@
+/**
+ * @file gravity_tiled.c
+ * @brief Cache-blocked all-pairs gravity kernel and tile-size detection.
+ *
+ * @author Steven Kight
+ */
+
+#include "gravity_tiled.h"
+#include "gravity.h"
+#include "softening.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#define TILE_DEFAULT_L1 (32 * 1024) /* bytes, when the OS cannot tell us */
+
+int gravity_tile_size_auto(void) {
+    static int cached = 0;
+    if (cached) return cached;
+
+    long l1 = 0;
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+#endif
+    if (l1 <= 0) l1 = TILE_DEFAULT_L1;
+
+    /* Half of L1 for the tile leaves room for target state and the stack. */
+    int tile = (int)(l1 / 2 / (4 * (long)sizeof(double)));
+    tile = tile / 8 * 8;
+    if (tile < GRAVITY_TILE_MIN) tile = GRAVITY_TILE_MIN;
+    if (tile > GRAVITY_TILE_MAX) tile = GRAVITY_TILE_MAX;
+
+    cached = tile;
+    return cached;
+}
+
+/*
+ * Adds Σ_{j ∈ [j0, j1)} m_j ΔP g(r) to target i's accumulators. Positions and
+ * masses are read from structure-of-arrays staging, so a source tile is four
+ * contiguous streams (five with the resolved softening lengths e). The
+ * unsoftened loop stays branch-free so it vectorises; the softened one calls
+ * softening_inv_r3() per pair.
+ */
+static inline void tile_row(const GravitySoA *soa, int i, int j0, int j1, GravitySoftening kind,
+                            double *fx_io, double *fy_io, double *fz_io) {
+    const double *x = soa->x, *y = soa->y, *z = soa->z, *m = soa->m;
+    const double *e = soa->e;
+    const double xi = x[i], yi = y[i], zi = z[i];
+    double fx = 0.0, fy = 0.0, fz = 0.0;
+
+    if (kind == GRAVITY_SOFTENING_NONE) {
+        for (int j = j0; j < j1; j++) {
+            const double dx = x[j] - xi;
+            const double dy = y[j] - yi;
+            const double dz = z[j] - zi;
+            const double r2 = dx * dx + dy * dy + dz * dz;
+
+            // ⊙ (J − I) without a branch on j == i: the self term has
+            // r² = 0, so select a zero weight instead of dividing.
+            const double inv_r = r2 > 0.0 ? 1.0 / sqrt(r2) : 0.0;
+            const double s     = m[j] * inv_r * inv_r * inv_r;
+
+            fx += s * dx;
+            fy += s * dy;
+            fz += s * dz;
+        }
+    } else {
+        for (int j = j0; j < j1; j++) {
+            const double dx = x[j] - xi;
+            const double dy = y[j] - yi;
+            const double dz = z[j] - zi;
+            const double r2 = dx * dx + dy * dy + dz * dz;
+
+            // The self term has ΔP = 0, so its finite softened weight adds nothing.
+            const double eps = e[i] > e[j] ? e[i] : e[j];
+            const double s   = m[j] * softening_inv_r3(r2, eps, kind);
+
+            fx += s * dx;
+            fy += s * dy;
+            fz += s * dz;
+        }
+    }
+
+    *fx_io += fx;
+    *fy_io += fy;
+    *fz_io += fz;
+}
+
+void newtonian_gravity_tiled(const PhysicsObject *objects, int count, int tile,
+                             Vec3 *forces_out) {
+    newtonian_gravity_tiled_softened(objects, count, tile, GRAVITY_SOFTENING_NONE,
+                                     0.0, forces_out);
+}
+
+void newtonian_gravity_tiled_softened(const PhysicsObject *objects, int count,
+                                      int tile, GravitySoftening kind,
+                                      double length, Vec3 *forces_out) {
+    GravitySoA soa = {0};
+    newtonian_gravity_tiled_ws(&soa, objects, count, tile, kind, length,
+                               forces_out);
+    gravity_soa_free(&soa);
+}
+
+void newtonian_gravity_tiled_ws(GravitySoA *soa, const PhysicsObject *objects,
+                                int count, int tile, GravitySoftening kind,
+                                double length, Vec3 *forces_out) {
+    if (count <= 0) return;
+
+    if (gravity_soa_reserve(soa, count) != 0) {
+        /* Out of memory for the staging buffers — fall back to the row kernel. */
+        newtonian_gravity_softened(objects, count, kind, length, forces_out);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        soa->x[i] = objects[i].position.x;
+        soa->y[i] = objects[i].position.y;
+        soa->z[i] = objects[i].position.z;
+        soa->m[i] = objects[i].mass;
+        soa->e[i] = softening_length_of(&objects[i], length);
+    }
+
+    if (tile <= 0) tile = gravity_tile_size_auto();
+    if (tile < GRAVITY_TILE_MIN) tile = GRAVITY_TILE_MIN;
+    if (tile > GRAVITY_TILE_MAX) tile = GRAVITY_TILE_MAX;
+
+    const double *m = soa->m;
+    const int blocks = (count + GRAVITY_TILE_BLOCK - 1) / GRAVITY_TILE_BLOCK;
+
+    // Each block owns its targets' rows, so blocks parallelise without locks.
+    #pragma omp parallel for schedule(static)
+    for (int b = 0; b < blocks; b++) {
+        const int i0 = b * GRAVITY_TILE_BLOCK;
+        const int i1 = i0 + GRAVITY_TILE_BLOCK < count ? i0 + GRAVITY_TILE_BLOCK : count;
+
+        double ax[GRAVITY_TILE_BLOCK] = {0.0};
+        double ay[GRAVITY_TILE_BLOCK] = {0.0};
+        double az[GRAVITY_TILE_BLOCK] = {0.0};
+
+        for (int j0 = 0; j0 < count; j0 += tile) {
+            const int j1 = j0 + tile < count ? j0 + tile : count;
+
+            for (int i = i0; i < i1; i++) {
+                tile_row(soa, i, j0, j1, kind, &ax[i - i0], &ay[i - i0], &az[i - i0]);
+            }
+        }
+
+        for (int i = i0; i < i1; i++) {
+            const double gmi = GRAVITATIONAL_CONSTANT * m[i];
+            forces_out[i] = (Vec3){gmi * ax[i - i0], gmi * ay[i - i0], gmi * az[i - i0]};
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file gravity_tiled.h
+ * @brief Cache-blocked (tiled) all-pairs gravity for large N.
+ *
+ * The plain row kernel streams every source body once per target, so once
+ * the positions outgrow the cache each target re-reads them from DRAM. The
+ * tiled kernel instead walks a block of targets against one tile of sources
+ * at a time:
+ *
+ *   for each target block I          (OpenMP-parallel)
+ *     for each source tile J         (tile stays resident in L1)
+ *       for i in I, j in J: a_i += m_j ΔP / r³
+ *
+ * so each tile is loaded once per block rather than once per target. The
+ * source tile length is tunable; by default it is derived from the L1 data
+ * cache size reported by the OS.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef GRAVITY_TILED_H
+#define GRAVITY_TILED_H
+
+#include "../../models/object.h"
+#include "gravity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GRAVITY_TILE_MIN   64    /* shortest source tile (bodies) */
+#define GRAVITY_TILE_MAX   8192  /* longest source tile (bodies) */
+#define GRAVITY_TILE_BLOCK 64    /* targets per block sharing each tile */
+
+/**
+ * @brief Source tile length that fills about half the L1 data cache.
+ *
+ * Each body occupies four doubles (x, y, z, m). Falls back to a 32 KiB L1
+ * when the cache size cannot be queried. Cached after the first call.
+ */
+int gravity_tile_size_auto(void);
+
+/**
+ * @brief Computes net gravitational forces with cache-blocked all-pairs.
+ *
+ * Same contract as newtonian_gravity_direct(), except that coincident bodies
+ * (r = 0) contribute nothing instead of producing NaN. Stages the bodies in
+ * temporary SoA buffers; newtonian_gravity_tiled_ws() reuses caller-owned
+ * ones. Target blocks are OpenMP-parallel.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param tile       Source tile length in bodies; 0 selects
+ *                   gravity_tile_size_auto(). Clamped to
+ *                   [GRAVITY_TILE_MIN, GRAVITY_TILE_MAX].
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_tiled(const PhysicsObject *objects, int count, int tile,
+                             Vec3 *forces_out);
+
+/**
+ * @brief newtonian_gravity_tiled() with a softened pair kernel.
+ *
+ * Pair lengths follow newtonian_gravity_softened(); GRAVITY_SOFTENING_NONE
+ * gives newtonian_gravity_tiled().
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param tile       Source tile length in bodies; 0 = auto.
+ * @param kind       Softening kernel.
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_tiled_softened(const PhysicsObject *objects, int count,
+                                      int tile, GravitySoftening kind,
+                                      double length, Vec3 *forces_out);
+
+/**
+ * @brief newtonian_gravity_tiled_softened() staging into caller-owned arrays.
+ *
+ * @p soa is grown to @p count if needed and otherwise reused, so steady-state
+ * ticks do not reallocate.
+ *
+ * @param soa        SoA staging. Must not be NULL.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param tile       Source tile length in bodies; 0 = auto.
+ * @param kind       Softening kernel.
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void newtonian_gravity_tiled_ws(GravitySoA *soa, const PhysicsObject *objects,
+                                int count, int tile, GravitySoftening kind,
+                                double length, Vec3 *forces_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GRAVITY_TILED_H */
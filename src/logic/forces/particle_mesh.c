@@ -0,0 +1,383 @@
+/**
+ * @file particle_mesh.c
+ * @brief Particle-mesh deposit, FFT Poisson solve, and force interpolation.
+ *
+ * Complex grids are stored interleaved (re, im) in row-major order with the
+ * last axis contiguous. The FFT is a self-contained iterative radix-2
+ * Cooley–Tukey transform applied line by line along each axis, so no external
+ * FFT library is required.
+ *
+ * @author Steven Kight
+ */
+
+#include "particle_mesh.h"
+#include "gravity.h"
+#include "softening.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Bodies are mapped to node coordinates [PM_MARGIN, n − 1 − PM_MARGIN] so the
+   widest (TSC) stencil plus the central difference never leaves the grid. */
+#define PM_MARGIN 2
+
+/* ------------------------------------------------------------------ */
+/* FFT                                                                   */
+/* ------------------------------------------------------------------ */
+
+/* In-place radix-2 FFT of n interleaved complex values. twiddle holds
+   n/2 interleaved roots e^{-2πik/n}; inverse = 1 conjugates them for the
+   (unnormalised) inverse transform. */
+static void fft_1d(double *data, int n, const double *twiddle, int inverse) {
+    /* Bit-reversal permutation. */
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i]     = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j]     = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len >> 1;
+        int step = n / len;
+        for (int start = 0; start < n; start += len) {
+            for (int k = 0; k < half; k++) {
+                double wr = twiddle[2 * k * step];
+                double wi = inverse ? -twiddle[2 * k * step + 1]
+                                    :  twiddle[2 * k * step + 1];
+                double *a = &data[2 * (start + k)];
+                double *b = &data[2 * (start + k + half)];
+                double br = b[0] * wr - b[1] * wi;
+                double bi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+            }
+        }
+    }
+}
+
+/* 3-D FFT of an m×m×m interleaved complex grid, one axis at a time. lines
+   holds one 2m-double scratch line for each of at most threads threads. */
+static void fft_3d(double *grid, int m, const double *twiddle, double *lines,
+                   int threads, int inverse) {
+    const size_t plane = (size_t)m * m;
+    const size_t strides[3] = { plane, (size_t)m, 1 };
+
+    for (int axis = 0; axis < 3; axis++) {
+        const size_t stride = strides[axis];
+
+        #pragma omp parallel num_threads(threads)
+        {
+#ifdef _OPENMP
+            double *line = lines + 2 * (size_t)m * omp_get_thread_num();
+#else
+            double *line = lines;
+#endif
+
+            #pragma omp for schedule(static)
+            for (int o = 0; o < m; o++) {
+                for (int in = 0; in < m; in++) {
+                    /* The other two axes enumerate the m² independent lines. */
+                    size_t base = axis == 0 ? (size_t)o * m + in
+                                : axis == 1 ? (size_t)o * plane + in
+                                            : (size_t)o * plane + (size_t)in * m;
+                    for (int k = 0; k < m; k++) {
+                        line[2 * k]     = grid[2 * (base + k * stride)];
+                        line[2 * k + 1] = grid[2 * (base + k * stride) + 1];
+                    }
+                    fft_1d(line, m, twiddle, inverse);
+                    for (int k = 0; k < m; k++) {
+                        grid[2 * (base + k * stride)]     = line[2 * k];
+                        grid[2 * (base + k * stride) + 1] = line[2 * k + 1];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Workspace and Green's function cache                                  */
+/* ------------------------------------------------------------------ */
+
+void pm_workspace_init(PMWorkspace *ws) {
+    memset(ws, 0, sizeof(*ws));
+}
+
+void pm_workspace_free(PMWorkspace *ws) {
+    free(ws->green);
+    free(ws->twiddle);
+    free(ws->lines);
+    free(ws->rho);
+    free(ws->acc);
+    pm_workspace_init(ws);
+}
+
+/* Buffers for the padded m³ grid; the Green's function is left stale. */
+static int ensure_grids(PMWorkspace *ws, int m) {
+    if (ws->grid_dim == m)
+        return 0;
+
+    pm_workspace_free(ws);
+
+#ifdef _OPENMP
+    const int threads = omp_get_max_threads();
+#else
+    const int threads = 1;
+#endif
+
+    size_t cells = (size_t)m * m * m;
+    size_t nodes = cells / 8;  /* (m/2)³ */
+    ws->twiddle = malloc((size_t)m * sizeof(double));
+    ws->lines   = malloc(2 * (size_t)m * threads * sizeof(double));
+    ws->rho     = malloc(2 * cells * sizeof(double));
+    ws->acc     = malloc(3 * nodes * sizeof(double));
+    ws->green   = malloc(cells * sizeof(double));
+    if (!ws->twiddle || !ws->lines || !ws->rho || !ws->acc || !ws->green) {
+        pm_workspace_free(ws);
+        return -1;
+    }
+
+    const double two_pi = 2.0 * acos(-1.0);
+    for (int k = 0; k < m / 2; k++) {
+        ws->twiddle[2 * k]     = cos(-two_pi * k / m);
+        ws->twiddle[2 * k + 1] = sin(-two_pi * k / m);
+    }
+
+    ws->line_threads = threads;
+    ws->grid_dim     = m;
+    return 0;
+}
+
+/*
+ * FFT of the unit Green's function φ(r) (r in cells; −1/r unsoftened) for
+ * @p kind with length @p eps cells, on the padded m³ grid. The kernel is real
+ * and even, so its transform is real; only that part is kept. The physical
+ * kernel is G φ / h, i.e. this table scaled by G/h.
+ */
+static int ensure_green(PMWorkspace *ws, int m, GravitySoftening kind, double eps) {
+    if (ensure_grids(ws, m) != 0)
+        return -1;
+    if (ws->green_ready && ws->green_kind == kind && ws->green_eps == eps)
+        return 0;
+
+    /* The density grid is free until the deposit, so it is the work buffer. */
+    double *work = ws->rho;
+    size_t cells = (size_t)m * m * m;
+
+    /* Distances wrap at m/2 so the kernel covers ±(m/2) cells cyclically. */
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < m; i++) {
+        int di = i <= m / 2 ? i : m - i;
+        for (int j = 0; j < m; j++) {
+            int dj = j <= m / 2 ? j : m - j;
+            for (int k = 0; k < m; k++) {
+                int dk = k <= m / 2 ? k : m - k;
+                size_t idx = ((size_t)i * m + j) * m + k;
+                int r2 = di * di + dj * dj + dk * dk;
+                /* Self term only shifts the potential at a body's own nodes;
+                   the symmetric difference stencil cancels it. */
+                work[2 * idx]     = r2 > 0 || kind != GRAVITY_SOFTENING_NONE
+                                  ? softening_potential((double)r2, eps, kind) : -1.0;
+                work[2 * idx + 1] = 0.0;
+            }
+        }
+    }
+
+    fft_3d(work, m, ws->twiddle, ws->lines, ws->line_threads, 0);
+    for (size_t c = 0; c < cells; c++)
+        ws->green[c] = work[2 * c];
+
+    ws->green_ready = 1;
+    ws->green_kind  = kind;
+    ws->green_eps   = eps;
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Assignment kernels                                                    */
+/* ------------------------------------------------------------------ */
+
+/* Fill a 3-node stencil along one axis: nodes first..first+2 with weights w. */
+static void stencil(double u, PMAssignment assignment, int *first, double w[3]) {
+    if (assignment == PM_ASSIGN_TSC) {
+        int    c = (int)floor(u + 0.5);
+        double d = u - c;
+        *first = c - 1;
+        w[0] = 0.5 * (0.5 - d) * (0.5 - d);
+        w[1] = 0.75 - d * d;
+        w[2] = 0.5 * (0.5 + d) * (0.5 + d);
+    } else {
+        int    c = (int)floor(u);
+        double f = u - c;
+        *first = c;
+        w[0] = 1.0 - f;
+        w[1] = f;
+        w[2] = 0.0;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: particle_mesh_gravity                                         */
+/* ------------------------------------------------------------------ */
+
+void particle_mesh_gravity(const PhysicsObject *objects, int count, int grid,
+                           PMAssignment assignment, Vec3 *forces_out) {
+    particle_mesh_gravity_softened(objects, count, grid, assignment,
+                                   GRAVITY_SOFTENING_NONE, 0.0, forces_out);
+}
+
+void particle_mesh_gravity_softened(const PhysicsObject *objects, int count, int grid,
+                                    PMAssignment assignment, GravitySoftening softening,
+                                    double length, Vec3 *forces_out) {
+    PMWorkspace ws;
+    pm_workspace_init(&ws);
+    particle_mesh_gravity_ws(&ws, objects, count, grid, assignment, softening,
+                             length, forces_out);
+    pm_workspace_free(&ws);
+}
+
+void particle_mesh_gravity_ws(PMWorkspace *ws, const PhysicsObject *objects,
+                              int count, int grid, PMAssignment assignment,
+                              GravitySoftening softening, double length,
+                              Vec3 *forces_out) {
+    if (count < 2) {
+        for (int i = 0; i < count; i++)
+            forces_out[i] = (Vec3){ 0.0, 0.0, 0.0 };
+        return;
+    }
+
+    int n = PM_MIN_GRID;
+    while (n < grid && n < PM_MAX_GRID)
+        n <<= 1;
+    const int m = 2 * n;  /* zero-padded FFT grid */
+
+    /* Bounding cube over all positions. */
+    Vec3 lo = objects[0].position, hi = objects[0].position;
+    for (int i = 1; i < count; i++) {
+        Vec3 q = objects[i].position;
+        if (q.x < lo.x) lo.x = q.x;
+        if (q.y < lo.y) lo.y = q.y;
+        if (q.z < lo.z) lo.z = q.z;
+        if (q.x > hi.x) hi.x = q.x;
+        if (q.y > hi.y) hi.y = q.y;
+        if (q.z > hi.z) hi.z = q.z;
+    }
+    double extent = fmax(hi.x - lo.x, fmax(hi.y - lo.y, hi.z - lo.z));
+    if (extent <= 0.0) {
+        /* All bodies coincide — no resolvable field on a mesh. */
+        newtonian_gravity_softened(objects, count, softening, length, forces_out);
+        return;
+    }
+
+    const double h = extent / (n - 1 - 2 * PM_MARGIN);
+    const Vec3 origin = { lo.x - PM_MARGIN * h, lo.y - PM_MARGIN * h,
+                          lo.z - PM_MARGIN * h };
+
+    /* One convolution carries one length: the largest in the scene, so no
+       pair is softened less than the pair rule asks. */
+    double eps = 0.0;
+    if (softening != GRAVITY_SOFTENING_NONE) {
+        for (int i = 0; i < count; i++)
+            eps = fmax(eps, softening_length_of(&objects[i], length));
+    }
+    if (eps <= 0.0)
+        softening = GRAVITY_SOFTENING_NONE;
+
+    size_t cells = (size_t)m * m * m;
+    if (ensure_green(ws, m, softening, eps / h) != 0) {
+        /* Out of memory for the mesh — fall back to exact O(N²) summation. */
+        newtonian_gravity_softened(objects, count, softening, length, forces_out);
+        return;
+    }
+    double *rho = ws->rho, *acc = ws->acc;
+    memset(rho, 0, 2 * cells * sizeof(double));
+    memset(acc, 0, 3 * (size_t)n * n * n * sizeof(double));
+
+    /* ── 1. Deposit masses onto the n³ corner of the padded grid ──────── */
+    #pragma omp parallel for schedule(static)
+    for (int b = 0; b < count; b++) {
+        int f[3];
+        double w[3][3];
+        stencil((objects[b].position.x - origin.x) / h, assignment, &f[0], w[0]);
+        stencil((objects[b].position.y - origin.y) / h, assignment, &f[1], w[1]);
+        stencil((objects[b].position.z - origin.z) / h, assignment, &f[2], w[2]);
+
+        for (int a = 0; a < 3; a++)
+        for (int c = 0; c < 3; c++)
+        for (int e = 0; e < 3; e++) {
+            double wt = w[0][a] * w[1][c] * w[2][e];
+            if (wt == 0.0) continue;
+            size_t idx = ((size_t)(f[0] + a) * m + (f[1] + c)) * m + (f[2] + e);
+            #pragma omp atomic
+            rho[2 * idx] += objects[b].mass * wt;
+        }
+    }
+
+    /* ── 2. φ = IFFT(FFT(ρ) · Ĝ) · G / h, normalised by m³ ────────────── */
+    fft_3d(rho, m, ws->twiddle, ws->lines, ws->line_threads, 0);
+
+    const double *green = ws->green;
+    #pragma omp parallel for schedule(static)
+    for (long long c = 0; c < (long long)cells; c++) {
+        rho[2 * c]     *= green[c];
+        rho[2 * c + 1] *= green[c];
+    }
+
+    fft_3d(rho, m, ws->twiddle, ws->lines, ws->line_threads, 1);
+    const double phi_scale = GRAVITATIONAL_CONSTANT / (h * (double)cells);
+
+    /* ── 3. a = −∇φ by central differences on the n³ region ──────────── */
+    #define PHI(i, j, k) (rho[2 * (((size_t)(i) * m + (j)) * m + (k))] * phi_scale)
+    #pragma omp parallel for schedule(static)
+    for (int i = 1; i < n - 1; i++) {
+        for (int j = 1; j < n - 1; j++) {
+            for (int k = 1; k < n - 1; k++) {
+                size_t idx = 3 * (((size_t)i * n + j) * n + k);
+                acc[idx]     = -(PHI(i + 1, j, k) - PHI(i - 1, j, k)) / (2.0 * h);
+                acc[idx + 1] = -(PHI(i, j + 1, k) - PHI(i, j - 1, k)) / (2.0 * h);
+                acc[idx + 2] = -(PHI(i, j, k + 1) - PHI(i, j, k - 1)) / (2.0 * h);
+            }
+        }
+    }
+    #undef PHI
+
+    /* ── 4. Interpolate accelerations back with the same kernel ───────── */
+    #pragma omp parallel for schedule(static)
+    for (int b = 0; b < count; b++) {
+        int f[3];
+        double w[3][3];
+        stencil((objects[b].position.x - origin.x) / h, assignment, &f[0], w[0]);
+        stencil((objects[b].position.y - origin.y) / h, assignment, &f[1], w[1]);
+        stencil((objects[b].position.z - origin.z) / h, assignment, &f[2], w[2]);
+
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (int a = 0; a < 3; a++)
+        for (int c = 0; c < 3; c++)
+        for (int e = 0; e < 3; e++) {
+            double wt = w[0][a] * w[1][c] * w[2][e];
+            if (wt == 0.0) continue;
+            size_t idx = 3 * (((size_t)(f[0] + a) * n + (f[1] + c)) * n + (f[2] + e));
+            ax += wt * acc[idx];
+            ay += wt * acc[idx + 1];
+            az += wt * acc[idx + 2];
+        }
+
+        double mb = objects[b].mass;
+        forces_out[b] = (Vec3){ mb * ax, mb * ay, mb * az };
+    }
+}
@@ -0,0 +1,132 @@
+/**
+ * @file particle_mesh.h
+ * @brief Particle-mesh (PM) gravity solver using an FFT Poisson solve.
+ *
+ * Masses are deposited onto a cubic grid spanning the scene, the potential is
+ * obtained by convolving the mass grid with the Green's function −G/r through
+ * a CPU FFT, and accelerations are finite-differenced on the grid and
+ * interpolated back to each body with the same assignment kernel:
+ *
+ *   1. Deposit:      ρ[n]  = Σ_i m_i W(x_i − x_n)               (CIC or TSC)
+ *   2. Convolve:     φ     = IFFT( FFT(ρ) · FFT(−G/r) )        (zero-padded)
+ *   3. Differentiate: a[n] = −(φ[n+1] − φ[n−1]) / 2h            (per axis)
+ *   4. Interpolate:  F_i   = m_i Σ_n W(x_i − x_n) a[n]
+ *
+ * The mass grid is zero-padded to twice its size on each axis so the cyclic
+ * FFT convolution reproduces isolated (open) boundary conditions — the scene
+ * is not treated as periodic.
+ *
+ * Cost is O(N + M³ log M) for an M³ grid, i.e. near-linear in N. Forces are
+ * smoothed on the scale of a few cells, so PM suits dense, roughly uniform
+ * distributions where the large-scale field dominates; close pairs are
+ * under-resolved.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef PARTICLE_MESH_H
+#define PARTICLE_MESH_H
+
+#include "../../models/object.h"
+#include "gravity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PM_MIN_GRID 16   /* smallest grid (cells per axis) */
+#define PM_MAX_GRID 256  /* largest grid; the padded FFT grid is twice this */
+
+/**
+ * @brief Grids and the cached Green's function for one padded grid size.
+ *
+ * Everything is sized for the padded m³ grid and reallocated only when m
+ * changes. The density grid (complex, m³) and acceleration grid (3·(m/2)³)
+ * are cleared each call instead of allocated afresh, and the per-thread FFT
+ * scratch lines are sized alongside them so no FFT allocates inside its
+ * parallel region. The transformed Green's function is kept until the
+ * softening kernel or its length in cells changes. Initialise with
+ * pm_workspace_init() and release with pm_workspace_free().
+ */
+typedef struct PMWorkspace {
+    double *green;      /**< Real FFT of the unit Green's function (m³). */
+    double *twiddle;    /**< m/2 interleaved roots of unity. */
+    double *lines;      /**< One 2m-double FFT line per thread. */
+    double *rho;        /**< Interleaved complex density / potential grid (m³). */
+    double *acc;        /**< Node accelerations on the (m/2)³ region. */
+    int     line_threads;  /**< Threads the lines were sized for. */
+    int     grid_dim;      /**< Padded grid size m (0 = none). */
+    int     green_ready;   /**< 1 once green matches green_kind / green_eps. */
+    GravitySoftening green_kind; /**< Kernel green was built for. */
+    double  green_eps;           /**< Softening length in cells green was built for. */
+} PMWorkspace;
+
+/** @brief Initialise an empty workspace (no allocation until first use). */
+void pm_workspace_init(PMWorkspace *ws);
+
+/** @brief Release all grids and reset @p ws to the empty state. */
+void pm_workspace_free(PMWorkspace *ws);
+
+/**
+ * @brief Computes net gravitational forces with the particle-mesh method.
+ *
+ * Same contract as newtonian_gravity(). Builds its grids and Green's
+ * function in a temporary workspace; particle_mesh_gravity_ws() keeps them
+ * between calls. The FFTs are OpenMP-parallel.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param grid       Cells per axis; rounded up to a power of two and clamped
+ *                   to [PM_MIN_GRID, PM_MAX_GRID].
+ * @param assignment Mass-assignment kernel (CIC or TSC).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void particle_mesh_gravity(const PhysicsObject *objects, int count, int grid,
+                           PMAssignment assignment, Vec3 *forces_out);
+
+/**
+ * @brief particle_mesh_gravity() with a softened Green's function.
+ *
+ * The mesh convolves every pair with the same kernel, so it uses a single
+ * length: the largest of @p length and the bodies' own lengths. Even in a
+ * kept workspace the softened Green's function is rebuilt whenever that
+ * length changes in cells, which in a moving scene is most calls (one extra
+ * FFT each).
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param grid       Cells per axis, as for particle_mesh_gravity().
+ * @param assignment Mass-assignment kernel (CIC or TSC).
+ * @param softening  Kernel whose potential replaces −1/r (see softening.h).
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void particle_mesh_gravity_softened(const PhysicsObject *objects, int count, int grid,
+                                    PMAssignment assignment, GravitySoftening softening,
+                                    double length, Vec3 *forces_out);
+
+/**
+ * @brief particle_mesh_gravity_softened() in a caller-owned workspace.
+ *
+ * Calls at the same grid size reuse the grids, and the Green's function too
+ * while the softening length in cells is unchanged.
+ *
+ * @param ws         Workspace. Must not be NULL.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param grid       Cells per axis, as for particle_mesh_gravity().
+ * @param assignment Mass-assignment kernel (CIC or TSC).
+ * @param softening  Kernel whose potential replaces −1/r (see softening.h).
+ * @param length     Global softening length ε (m).
+ * @param forces_out Pre-allocated array of @p count Vec3 values (Newtons).
+ */
+void particle_mesh_gravity_ws(PMWorkspace *ws, const PhysicsObject *objects,
+                              int count, int grid, PMAssignment assignment,
+                              GravitySoftening softening, double length,
+                              Vec3 *forces_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARTICLE_MESH_H */
@@ -0,0 +1,172 @@
+/**
+ * @file softening.h
+ * @brief Gravitational softening kernels shared by the gravity solvers.
+ *
+ * Softening replaces the point-mass 1/r³ pair factor with a kernel that stays
+ * finite as r → 0, so close encounters produce bounded accelerations and the
+ * time step no longer has to resolve near-collisions:
+ *
+ *   PLUMMER  g(r) = 1 / (r² + ε²)^{3/2}
+ *            Smooth everywhere; slightly weakens forces at every range.
+ *
+ *   SPLINE   Cubic-spline (Monaghan–Lattanzio) mass distribution with compact
+ *            support h = 2.8 ε, the Gadget convention that makes its central
+ *            potential match a Plummer sphere of length ε. Exactly Newtonian
+ *            for r ≥ h.
+ *
+ * A pair force is then F_ij = G m_i m_j ΔP[i,j] g(r_ij). Each body may carry
+ * its own length (PhysicsObject.softening); a pair uses the larger of the two
+ * so the kernel stays symmetric and Newton's third law holds.
+ *
+ * Helpers are static inline because they sit in the innermost pair loops.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef SOFTENING_H
+#define SOFTENING_H
+
+#include "gravity.h"
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Spline support radius in units of the Plummer-equivalent length ε. */
+#define SOFTENING_SPLINE_SUPPORT 2.8
+
+/** Softening length of one body: its own if set, else the global length. */
+static inline double softening_length_of(const PhysicsObject *obj, double global) {
+    return obj->softening > 0.0 ? obj->softening : global;
+}
+
+/** Pair length from two per-body lengths (0 = unset): the larger of the two. */
+static inline double softening_combine(double ea, double eb, double global) {
+    if (ea <= 0.0) ea = global;
+    if (eb <= 0.0) eb = global;
+    return ea > eb ? ea : eb;
+}
+
+/** Pair softening length: the larger of the two bodies' lengths. */
+static inline double softening_pair_length(const PhysicsObject *a,
+                                           const PhysicsObject *b,
+                                           double global) {
+    return softening_combine(a->softening, b->softening, global);
+}
+
+/**
+ * @brief Softened pair factor g(r) replacing 1/r³.
+ *
+ * @param r2   Squared separation r².
+ * @param eps  Softening length ε (≤ 0 disables softening).
+ * @param kind Kernel.
+ * @return     g(r); 0 when r = 0 and the kernel is unsoftened.
+ */
+static inline double softening_inv_r3(double r2, double eps, GravitySoftening kind) {
+    if (kind == GRAVITY_SOFTENING_NONE || eps <= 0.0) {
+        if (r2 <= 0.0) return 0.0;
+        double inv_r = 1.0 / sqrt(r2);
+        return inv_r * inv_r * inv_r;
+    }
+
+    if (kind == GRAVITY_SOFTENING_PLUMMER) {
+        double inv = 1.0 / sqrt(r2 + eps * eps);
+        return inv * inv * inv;
+    }
+
+    /* GRAVITY_SOFTENING_SPLINE */
+    const double h = SOFTENING_SPLINE_SUPPORT * eps;
+    if (r2 >= h * h) {
+        double inv_r = 1.0 / sqrt(r2);
+        return inv_r * inv_r * inv_r;
+    }
+
+    const double inv_h3 = 1.0 / (h * h * h);
+    const double u = sqrt(r2) / h;
+    if (u < 0.5) {
+        return inv_h3 * (32.0 / 3.0 + u * u * (32.0 * u - 38.4));
+    }
+    return inv_h3 * (64.0 / 3.0 - 48.0 * u + 38.4 * u * u
+                     - 32.0 / 3.0 * u * u * u - 1.0 / (15.0 * u * u * u));
+}
+
+/**
+ * @brief Softened unit potential φ(r) replacing −1/r, with g(r) = (dφ/dr) / r.
+ *
+ * Used where the kernel enters through a potential rather than a pair force,
+ * such as the particle-mesh Green's function. Plummer gives −1/√(r² + ε²);
+ * the spline is Gadget's closed form, −1/r from its support outward.
+ *
+ * @param r2   Squared separation r².
+ * @param eps  Softening length ε (≤ 0 disables softening).
+ * @param kind Kernel.
+ * @return     φ(r); 0 when r = 0 and the kernel is unsoftened.
+ */
+static inline double softening_potential(double r2, double eps, GravitySoftening kind) {
+    if (kind == GRAVITY_SOFTENING_NONE || eps <= 0.0)
+        return r2 > 0.0 ? -1.0 / sqrt(r2) : 0.0;
+
+    if (kind == GRAVITY_SOFTENING_PLUMMER)
+        return -1.0 / sqrt(r2 + eps * eps);
+
+    /* GRAVITY_SOFTENING_SPLINE */
+    const double h = SOFTENING_SPLINE_SUPPORT * eps;
+    if (r2 >= h * h)
+        return -1.0 / sqrt(r2);
+
+    const double u = sqrt(r2) / h;
+    if (u < 0.5)
+        return (-2.8 + u * u * (16.0 / 3.0 + u * u * (6.4 * u - 9.6))) / h;
+    return (-3.2 + 1.0 / (15.0 * u) +
+            u * u * (32.0 / 3.0 + u * (-16.0 + u * (9.6 - 32.0 / 15.0 * u)))) / h;
+}
+
+/**
+ * @brief Radial derivative of the pair factor, (dg/dr) / r.
+ *
+ * Needed for the jerk, d/dt (ΔP g) = ΔV g + ΔP (ΔP·ΔV) (dg/dr) / r.
+ * Continuous across the spline knots like g itself.
+ *
+ * @param r2   Squared separation r².
+ * @param eps  Softening length ε (≤ 0 disables softening).
+ * @param kind Kernel.
+ * @return     (dg/dr) / r; 0 when r = 0 and the kernel is unsoftened.
+ */
+static inline double softening_dg_over_r(double r2, double eps, GravitySoftening kind) {
+    if (kind == GRAVITY_SOFTENING_NONE || eps <= 0.0) {
+        if (r2 <= 0.0) return 0.0;
+        double inv_r2 = 1.0 / r2;
+        double inv_r  = sqrt(inv_r2);
+        return -3.0 * inv_r * inv_r2 * inv_r2;
+    }
+
+    if (kind == GRAVITY_SOFTENING_PLUMMER) {
+        double inv2 = 1.0 / (r2 + eps * eps);
+        double inv  = sqrt(inv2);
+        return -3.0 * inv * inv2 * inv2;
+    }
+
+    /* GRAVITY_SOFTENING_SPLINE */
+    const double h = SOFTENING_SPLINE_SUPPORT * eps;
+    if (r2 >= h * h) {
+        double inv_r2 = 1.0 / r2;
+        double inv_r  = sqrt(inv_r2);
+        return -3.0 * inv_r * inv_r2 * inv_r2;
+    }
+
+    const double h2 = h * h;
+    const double inv_h5 = 1.0 / (h2 * h2 * h);
+    const double u = sqrt(r2) / h;
+    if (u < 0.5) {
+        return inv_h5 * (96.0 * u - 76.8);
+    }
+    return inv_h5 * (-48.0 / u + 76.8 - 32.0 * u + 0.2 / (u * u * u * u * u));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SOFTENING_H */
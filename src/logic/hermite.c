@@ -0,0 +1,113 @@
+/**
+ * @file hermite.c
+ * @brief Shared-step fourth-order Hermite integrator.
+ *
+ * @author Steven Kight
+ */
+
+#include "hermite.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void hermite_state_init(HermiteState *state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void hermite_state_free(HermiteState *state) {
+    free(state->mass);
+    free(state->soft);
+    free(state->acc);
+    free(state->jerk);
+    free(state->pos);
+    free(state->vel);
+    free(state->acc_new);
+    free(state->jerk_new);
+    hermite_state_init(state);
+}
+
+/* Grow every per-body buffer to hold at least @p count entries. */
+static int hermite_state_reserve(HermiteState *state, int count) {
+    if (count <= state->capacity) return 0;
+
+    hermite_state_free(state);
+
+    const size_t n = (size_t)count;
+    state->mass     = malloc(n * sizeof(double));
+    state->soft     = malloc(n * sizeof(double));
+    state->acc      = malloc(n * sizeof(Vec3));
+    state->jerk     = malloc(n * sizeof(Vec3));
+    state->pos      = malloc(n * sizeof(Vec3));
+    state->vel      = malloc(n * sizeof(Vec3));
+    state->acc_new  = malloc(n * sizeof(Vec3));
+    state->jerk_new = malloc(n * sizeof(Vec3));
+
+    if (!state->mass || !state->soft || !state->acc || !state->jerk ||
+        !state->pos || !state->vel || !state->acc_new || !state->jerk_new) {
+        hermite_state_free(state);
+        return -1;
+    }
+
+    state->capacity = count;
+    return 0;
+}
+
+int hermite_step(HermiteState *state, PhysicsObject *objects, int count,
+                 double time_step, int resync, const GravityConfig *gravity,
+                 SimStats *stats) {
+    if (count <= 0) return 0;
+    if (hermite_state_reserve(state, count) != 0) return -1;
+
+    const GravitySoftening kind = gravity ? gravity->softening : GRAVITY_SOFTENING_NONE;
+    const double length         = gravity ? gravity->softening_length : 0.0;
+
+    for (int i = 0; i < count; i++) {
+        state->mass[i] = objects[i].mass;
+        state->soft[i] = objects[i].softening;
+    }
+
+    if (resync || !state->synced) {
+        for (int i = 0; i < count; i++) {
+            state->pos[i] = objects[i].position;
+            state->vel[i] = objects[i].velocity;
+        }
+        gravity_acc_jerk(state->pos, state->vel, state->mass, state->soft,
+                         count, NULL, count, kind, length,
+                         state->acc, state->jerk);
+        state->synced = 1;
+        if (stats) stats->force_evaluations += count;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        hermite_predict(objects[i].position, objects[i].velocity,
+                        state->acc[i], state->jerk[i], time_step,
+                        &state->pos[i], &state->vel[i]);
+    }
+
+    gravity_acc_jerk(state->pos, state->vel, state->mass, state->soft,
+                     count, NULL, count, kind, length,
+                     state->acc_new, state->jerk_new);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++) {
+        hermite_correct(objects[i].position, objects[i].velocity,
+                        state->acc[i], state->jerk[i],
+                        state->acc_new[i], state->jerk_new[i], time_step,
+                        &objects[i].position, &objects[i].velocity);
+        state->acc[i]  = state->acc_new[i];
+        state->jerk[i] = state->jerk_new[i];
+
+        objects[i].acceleration = state->acc[i];
+        objects[i].force        = (Vec3){0.0, 0.0, 0.0};
+    }
+
+    if (stats) {
+        stats->steps++;
+        stats->force_evaluations += count;
+        if (stats->min_time_step <= 0.0 || time_step < stats->min_time_step) {
+            stats->min_time_step = time_step;
+        }
+    }
+    return 0;
+}
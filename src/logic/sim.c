@@ -1,6 +1,6 @@
 /**
  * @file sim.c
- * @brief Top-level simulation loop: force accumulation and Verlet integration.
+ * @brief Top-level simulation loop: force accumulation and time integration.
  *
  * @author Steven Kight
  * @date 2026-04-14
@@ -8,31 +8,182 @@
 
 #include "sim.h"
 
+#include "block_timestep.h"
+#include "hermite.h"
+#include "symplectic.h"
 #include "forces/gravity.h"
 #include "forces/collision.h"
 #include "collision/collision.h"
 #include "../models/object.h"
+#include "../models/world.h"
 
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <omp.h>
 
-void sim_run(PhysicsObject *objects, int count, double time_step,
-             int num_steps) {
-    Vec3 *forces = malloc(count * sizeof(Vec3));
-    
-    /* Worst-case pair count: every object collides with every other. */
-    int max_pairs = count * (count - 1) / 2;
-    CollisionPair *pairs = malloc((max_pairs > 0 ? max_pairs : 1) * sizeof(CollisionPair));
+void sim_config_default(SimConfig *config) {
+    gravity_config_default(&config->gravity);
+    config->integrator      = SIM_INTEGRATOR_VERLET;
+    config->block_max_level = 10;
+    config->block_eta       = 0.02;
+    config->broad_phase     = COLLISION_BROAD_OCTREE;
+}
+
+int sim_run(PhysicsObject *objects, int count, double time_step,
+            int num_steps) {
+    return sim_run_config(objects, count, time_step, num_steps, NULL);
+}
+
+int sim_run_config(PhysicsObject *objects, int count, double time_step,
+                   int num_steps, const SimConfig *config) {
+    return sim_run_stats(objects, count, time_step, num_steps, config, NULL);
+}
+
+struct SimContext {
+    SimConfig          config;
+    SimIntegrator      integrator; /* config.integrator until a fallback to Verlet */
+    int                count;      /* bodies stepped last call; -1 before the first */
+    int                capacity;   /* entries in forces */
+    Vec3              *forces;
+    CollisionPairBuffer pairs;
+    CollisionWorkspace collision;
+    GravityWorkspace   gravity;
+    BlockState         block;
+    HermiteState       hermite;
+    SymplecticState    symplectic;
+    SimStats           stats;
+};
+
+SimContext *sim_context_create(const SimConfig *config) {
+    SimContext *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) return NULL;
+
+    if (config) ctx->config = *config;
+    else        sim_config_default(&ctx->config);
+    ctx->integrator = ctx->config.integrator;
+    ctx->count      = -1;
+
+    collision_workspace_init(&ctx->collision);
+    collision_workspace_set_broad_phase(&ctx->collision, ctx->config.broad_phase);
+    collision_pairs_init(&ctx->pairs);
+    gravity_workspace_init(&ctx->gravity);
+    block_state_init(&ctx->block);
+    hermite_state_init(&ctx->hermite);
+    symplectic_state_init(&ctx->symplectic);
+    return ctx;
+}
+
+void sim_context_destroy(SimContext *ctx) {
+    if (!ctx) return;
+    collision_workspace_free(&ctx->collision);
+    gravity_workspace_free(&ctx->gravity);
+    block_state_free(&ctx->block);
+    hermite_state_free(&ctx->hermite);
+    symplectic_state_free(&ctx->symplectic);
+    collision_pairs_free(&ctx->pairs);
+    free(ctx->forces);
+    free(ctx);
+}
+
+void sim_context_invalidate(SimContext *ctx) {
+    ctx->block.synced   = 0;
+    ctx->hermite.synced = 0;
+    symplectic_state_invalidate(&ctx->symplectic);
+}
+
+void sim_context_stats(const SimContext *ctx, SimStats *out) {
+    *out = ctx->stats;
+}
+
+CollisionWorkspace *sim_context_collision(SimContext *ctx) {
+    return &ctx->collision;
+}
+
+GravityWorkspace *sim_context_gravity(SimContext *ctx) {
+    return &ctx->gravity;
+}
+
+/* Grow the force buffer to hold @p count bodies. */
+static int sim_context_reserve(SimContext *ctx, int count) {
+    if (count > ctx->capacity) {
+        Vec3 *forces = realloc(ctx->forces, (size_t)count * sizeof(Vec3));
+        if (!forces) return -1;
+        ctx->forces   = forces;
+        ctx->capacity = count;
+    }
+    return 0;
+}
+
+/* Fold one tick's collision detection into the pair counters. */
+static void record_pairs(SimStats *stats, const CollisionPairBuffer *pairs) {
+    if (pairs->count > stats->peak_pairs) stats->peak_pairs = pairs->count;
+    stats->pair_capacity = pairs->capacity;
+}
+
+int sim_step(SimContext *ctx, PhysicsObject *objects, int count,
+             double time_step, int num_steps) {
+    if (count < 0) count = 0;
+    if (sim_context_reserve(ctx, count) != 0) return -1;
+    if (count != ctx->count) {
+        // State carried between ticks belongs to the previous bodies.
+        sim_context_invalidate(ctx);
+        ctx->count = count;
+    }
+
+    const SimConfig *config     = &ctx->config;
+    SimStats *stats             = &ctx->stats;
+    Vec3 *forces                = ctx->forces;
+    CollisionPairBuffer *buffer = &ctx->pairs;
 
     for (int tick = 0; tick < num_steps; tick++) {
-        // Compute net gravitational force on each body.
-        newtonian_gravity(objects, count, forces);
+        if (ctx->integrator != SIM_INTEGRATOR_VERLET) {
+            // These integrators carry accelerations between ticks, so
+            // collisions are resolved first. Impulses change velocities only:
+            // the jerk-based schemes must resync, the splittings need not.
+            int n = collision_detect_ws(&ctx->collision, objects, count, buffer);
+            const CollisionPair *pairs = buffer->pairs;
+            record_pairs(stats, buffer);
+            for (int i = 0; i < n; i++) {
+                inelastic_collision(&objects[pairs[i].index_a],
+                                   &objects[pairs[i].index_b],
+                                   0.5);
+            }
+
+            int rc;
+            switch (ctx->integrator) {
+                case SIM_INTEGRATOR_BLOCK:
+                    rc = block_tick(&ctx->block, objects, count, time_step,
+                                    config->block_max_level, config->block_eta,
+                                    n > 0, &config->gravity, stats);
+                    break;
+                case SIM_INTEGRATOR_HERMITE:
+                    rc = hermite_step(&ctx->hermite, objects, count, time_step,
+                                      n > 0, &config->gravity, stats);
+                    break;
+                default:
+                    rc = symplectic_step(&ctx->symplectic, ctx->integrator,
+                                         objects, count, time_step,
+                                         &config->gravity, &ctx->gravity, stats);
+                    break;
+            }
+            if (rc == 0) continue;
+            /* Out of memory for the integrator state (or an unknown
+               integrator) — finish on Verlet, for this and later calls. */
+            ctx->integrator = SIM_INTEGRATOR_VERLET;
+        }
+
+        // Compute net gravitational force on each body with the scene's solver.
+        gravity_compute_ws(&ctx->gravity, &config->gravity, objects, count,
+                           forces);
 
         for (int i = 0; i < count; i++) {
             objects[i].force = forces[i];
         }
 
-        int n = collision_detect(objects, count, pairs, max_pairs);
+        int n = collision_detect_ws(&ctx->collision, objects, count, buffer);
+        const CollisionPair *pairs = buffer->pairs;
+        record_pairs(stats, buffer);
 
         // TODO: Optimize the list of collisions for parallel work
         for (int i = 0; i < n; i++) {
@@ -46,8 +197,244 @@ void sim_run(PhysicsObject *objects, int count, double time_step,
         for (int i = 0; i < count; i++) {
             object_step(&objects[i], time_step);
         }
+
+        stats->steps++;
+        stats->force_evaluations += count;
+        if (stats->min_time_step <= 0.0 || time_step < stats->min_time_step) {
+            stats->min_time_step = time_step;
+        }
+    }
+    return 0;
+}
+
+int sim_run_stats(PhysicsObject *objects, int count, double time_step,
+                  int num_steps, const SimConfig *config, SimStats *stats) {
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+    }
+
+    SimContext *ctx = sim_context_create(config);
+    if (!ctx) return -1;
+
+    int rc = sim_step(ctx, objects, count, time_step, num_steps);
+    if (stats) sim_context_stats(ctx, stats);
+    sim_context_destroy(ctx);
+    return rc;
+}
+
+/*
+ * Adaptive steps shorter than this fraction of the run are accepted whatever
+ * their error estimate, so a near-singular encounter cannot stall the run.
+ */
+#define SIM_ADAPTIVE_MIN_FRACTION 1e-12
+
+/* Largest factor by which the step may grow between accepted steps. */
+#define SIM_ADAPTIVE_GROWTH 2.0
+
+/* Target relative change of any body's acceleration over one step. */
+#define SIM_ADAPTIVE_CHANGE 0.25
+
+/* Accelerations from one gravity pass with the scene's solver. */
+static void adaptive_accelerations(GravityWorkspace *ws, const SimConfig *config,
+                                   const PhysicsObject *objects, int count,
+                                   Vec3 *forces, Vec3 *acc_out) {
+    gravity_compute_ws(ws, &config->gravity, objects, count, forces);
+    for (int i = 0; i < count; i++) {
+        acc_out[i] = vec3_div(forces[i], objects[i].mass);
+    }
+}
+
+/* min_i sqrt(2 ε / |a_i|); infinite when nothing accelerates. */
+static double adaptive_step_limit(const Vec3 *acc, int count, double tolerance) {
+    double a_max = 0.0;
+    for (int i = 0; i < count; i++) {
+        double a = vec3_magnitude(acc[i]);
+        if (a > a_max) a_max = a;
+    }
+    return a_max > 0.0 ? sqrt(2.0 * tolerance / a_max) : INFINITY;
+}
+
+int sim_run_until(PhysicsObject *objects, int count, double end_time,
+                  double tolerance, const SimConfig *config, SimStats *stats) {
+    SimConfig defaults;
+    if (!config) {
+        sim_config_default(&defaults);
+        config = &defaults;
+    }
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+    }
+    if (count <= 0 || end_time <= 0.0) return 0;
+
+    const size_t n = (size_t)count;
+    Vec3 *forces   = malloc(n * sizeof(Vec3));
+    Vec3 *acc      = malloc(n * sizeof(Vec3));
+    Vec3 *acc_new  = malloc(n * sizeof(Vec3));
+    Vec3 *pos0     = malloc(n * sizeof(Vec3));
+    Vec3 *vel0     = malloc(n * sizeof(Vec3));
+    if (!forces || !acc || !acc_new || !pos0 || !vel0) {
+        free(forces); free(acc); free(acc_new);
+        free(pos0); free(vel0);
+        return -1;
+    }
+    CollisionWorkspace collision;
+    CollisionPairBuffer pairs;
+    GravityWorkspace gravity;
+    collision_workspace_init(&collision);
+    collision_workspace_set_broad_phase(&collision, config->broad_phase);
+    collision_pairs_init(&pairs);
+    gravity_workspace_init(&gravity);
+
+    adaptive_accelerations(&gravity, config, objects, count, forces, acc);
+    if (stats) stats->force_evaluations += count;
+
+    const double min_step = end_time * SIM_ADAPTIVE_MIN_FRACTION;
+    double t  = 0.0;
+    double dt = adaptive_step_limit(acc, count, tolerance);
+
+    while (t < end_time) {
+        if (dt < min_step) dt = min_step;
+        const int last = dt >= end_time - t;
+        if (last) dt = end_time - t;
+
+        // Kick–drift with the accelerations carried over from the last step.
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++) {
+            pos0[i] = objects[i].position;
+            vel0[i] = objects[i].velocity;
+            objects[i].velocity = vec3_add(objects[i].velocity, vec3_scale(acc[i], dt / 2.0));
+            objects[i].position = vec3_add(objects[i].position, vec3_scale(objects[i].velocity, dt));
+        }
+
+        adaptive_accelerations(&gravity, config, objects, count, forces, acc_new);
+        if (stats) stats->force_evaluations += count;
+
+        // Local error of the step, and the largest relative change of any
+        // body's acceleration. A change larger than the acceleration itself
+        // (a turn of more than 60°) means the step skipped an encounter that
+        // the local estimate cannot see.
+        double da_max = 0.0, change = 0.0;
+        for (int i = 0; i < count; i++) {
+            double da = vec3_magnitude(vec3_sub(acc_new[i], acc[i]));
+            double a  = fmax(vec3_magnitude(acc[i]), vec3_magnitude(acc_new[i]));
+            if (da > da_max) da_max = da;
+            if (a > 0.0 && da / a > change) change = da / a;
+        }
+        const double err    = da_max * dt * dt / 12.0;
+        const int    jumped = change > 1.0;
+
+        if ((err > tolerance || jumped) && dt > min_step) {
+            for (int i = 0; i < count; i++) {
+                objects[i].position = pos0[i];
+                objects[i].velocity = vel0[i];
+            }
+            dt /= 2.0;
+            if (stats) stats->rejected_steps++;
+            continue;
+        }
+
+        // Closing kick with the new accelerations, which also start the next step.
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++) {
+            objects[i].velocity = vec3_add(objects[i].velocity, vec3_scale(acc_new[i], dt / 2.0));
+            acc[i] = acc_new[i];
+        }
+
+        if (stats) {
+            stats->steps++;
+            if (stats->min_time_step <= 0.0 || dt < stats->min_time_step) {
+                stats->min_time_step = dt;
+            }
+        }
+        t = last ? end_time : t + dt;
+
+        int n_pairs = collision_detect_ws(&collision, objects, count, &pairs);
+        if (stats) record_pairs(stats, &pairs);
+        for (int i = 0; i < n_pairs; i++) {
+            inelastic_collision(&objects[pairs.pairs[i].index_a],
+                               &objects[pairs.pairs[i].index_b],
+                               0.5);
+        }
+
+        // err ∝ Δt³, so rescale towards the tolerance with a safety margin;
+        // change ∝ Δt, so cap it at SIM_ADAPTIVE_CHANGE for the next step.
+        double next = SIM_ADAPTIVE_GROWTH * dt;
+        if (err > 0.0)    next = fmin(next, 0.9 * dt * cbrt(tolerance / err));
+        if (change > 0.0) next = fmin(next, dt * SIM_ADAPTIVE_CHANGE / change);
+        dt = fmin(next, adaptive_step_limit(acc, count, tolerance));
+    }
+
+    for (int i = 0; i < count; i++) {
+        objects[i].acceleration = acc[i];
+        objects[i].force        = (Vec3){0.0, 0.0, 0.0};
+    }
+
+    free(forces); free(acc); free(acc_new);
+    free(pos0); free(vel0);
+    collision_workspace_free(&collision);
+    collision_pairs_free(&pairs);
+    gravity_workspace_free(&gravity);
+    return 0;
+}
+
+int sim_run_world(PhysicsWorld *world, double time_step, int num_steps,
+                  const SimConfig *config, SimStats *stats) {
+    SimConfig defaults;
+    if (!config) {
+        sim_config_default(&defaults);
+        config = &defaults;
+    }
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+    }
+
+    const int count = world->count;
+    if (config->integrator != SIM_INTEGRATOR_VERLET) {
+        PhysicsObject *objects = malloc((count > 0 ? count : 1) * sizeof(PhysicsObject));
+        if (objects) {
+            world_export(world, objects);
+            int rc = sim_run_stats(objects, count, time_step, num_steps, config,
+                                   stats);
+            if (rc == 0) world_import(world, objects, count);
+            free(objects);
+            return rc;
+        }
+        /* Out of memory for the staging copy — run Verlet on the world. */
+    }
+
+    CollisionWorkspace collision;
+    CollisionPairBuffer pairs;
+    GravityWorkspace gravity;
+    collision_workspace_init(&collision);
+    collision_workspace_set_broad_phase(&collision, config->broad_phase);
+    collision_pairs_init(&pairs);
+    gravity_workspace_init(&gravity);
+
+    for (int tick = 0; tick < num_steps; tick++) {
+        // Gravity writes straight into the force array; nothing else is
+        // accumulated before the step.
+        gravity_compute_world_ws(&gravity, &config->gravity, world, world->force);
+
+        int n = collision_detect_world_ws(&collision, world, &pairs);
+        if (stats) record_pairs(stats, &pairs);
+        for (int i = 0; i < n; i++) {
+            inelastic_collision_world(world, pairs.pairs[i].index_a,
+                                      pairs.pairs[i].index_b, 0.5);
+        }
+
+        world_step(world, time_step);
+
+        if (stats) {
+            stats->steps++;
+            stats->force_evaluations += count;
+            if (stats->min_time_step <= 0.0 || time_step < stats->min_time_step) {
+                stats->min_time_step = time_step;
+            }
+        }
     }
 
-    free(forces);
-    free(pairs);
+    collision_workspace_free(&collision);
+    collision_pairs_free(&pairs);
+    gravity_workspace_free(&gravity);
+    return 0;
 }
@@ -4,7 +4,15 @@
  *
  * Drives a complete N-body simulation: applies forces (gravity) to every
  * object, then advances each object by one Velocity Verlet step, repeating
- * for the requested number of ticks.
+ * for the requested number of ticks. SimConfig can instead select the
+ * fourth-order Hermite integrator (hermite.h), individual block timesteps
+ * (block_timestep.h), which subdivide each tick per body, or a symplectic
+ * splitting scheme (symplectic.h).
+ *
+ * A SimContext keeps every buffer, collision pool and integrator state alive
+ * between calls, so callers that advance a scene a frame at a time
+ * (sim_step()) pay setup cost once. sim_run() and friends wrap a temporary
+ * context.
  *
  * @author Steven Kight
  * @date 2026-04-14
@@ -14,18 +22,68 @@
 #define SIM_H
 
 #include "../models/object.h"
+#include "../models/world.h"
+#include "forces/gravity.h"
+#include "collision/collision.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Time integration scheme used by sim_run_config(). */
+typedef enum {
+    SIM_INTEGRATOR_VERLET = 0,  /**< Shared-step Velocity Verlet via object_step(). */
+    SIM_INTEGRATOR_BLOCK,       /**< Power-of-two individual block steps (see block_timestep.h). */
+    SIM_INTEGRATOR_HERMITE,     /**< Shared-step fourth-order Hermite (see hermite.h). */
+    SIM_INTEGRATOR_KDK,         /**< Kick–drift–kick leapfrog (see symplectic.h). */
+    SIM_INTEGRATOR_YOSHIDA4,    /**< Fourth-order Yoshida triple jump (see symplectic.h). */
+    SIM_INTEGRATOR_FOREST_RUTH, /**< Fourth-order Forest–Ruth-like PEFRL (see symplectic.h). */
+} SimIntegrator;
+
+/**
+ * @brief Per-scene simulation settings.
+ *
+ * Initialise with sim_config_default() and override only the fields a scene
+ * needs, so new settings keep their defaults in existing callers.
+ */
+typedef struct {
+    GravityConfig gravity;    /**< Gravity solver selection and tunables. */
+    SimIntegrator integrator; /**< Time integration scheme. */
+    int block_max_level;      /**< Block steps: finest step is time_step / 2^level. */
+    double block_eta;         /**< Block steps: accuracy η in Δt_i = η |a_i| / |ȧ_i|. */
+    CollisionBroadPhase broad_phase; /**< Collision broad phase (see collision.h). */
+} SimConfig;
+
+/**
+ * @brief Work counters reported by sim_run_stats().
+ *
+ * force_evaluations counts per-body evaluations, so one full-system gravity
+ * pass adds N; comparing it across integrators measures force work directly.
+ */
+typedef struct {
+    long long steps;             /**< Integration steps (block substeps for BLOCK). */
+    long long rejected_steps;    /**< Adaptive steps retried with a smaller Δt. */
+    long long force_evaluations; /**< Bodies whose force was evaluated, summed over steps. */
+    double    min_time_step;     /**< Smallest step any body took (s). */
+    int       peak_pairs;        /**< Most collision pairs confirmed in one tick. */
+    int       pair_capacity;     /**< Collision pair buffer size; grows with contacts, not N². */
+} SimStats;
+
+/**
+ * @brief Fill @p config with the settings used by sim_run().
+ *
+ * Defaults: gravity_config_default(), Velocity Verlet, block steps down to
+ * time_step / 2^10 with η = 0.02, octree broad phase.
+ */
+void sim_config_default(SimConfig *config);
+
 /**
  * @brief Run the simulation for a fixed number of time steps.
  *
  * Runs gravity, collision detection (internally — pairs are not exposed to the
  * caller), and Velocity Verlet integration each tick.
  *
- * Objects that have vertex/face geometry (vertex_count > 0) participate in
+ * Objects that reference a registered mesh (mesh_id != MESH_NONE) participate in
  * collision detection automatically. Objects without geometry are point masses
  * for gravity only.
  *
@@ -33,9 +91,174 @@ extern "C" {
  * @param count      Number of objects (N).
  * @param time_step  Duration of each tick (s).
  * @param num_steps  Total number of ticks to simulate.
+ * @return           0 on success, -1 if the context or its buffers could not
+ *                   be allocated (objects are left unchanged).
+ */
+int sim_run(PhysicsObject *objects, int count, double time_step,
+            int num_steps);
+
+/**
+ * @brief Run the simulation with explicit per-scene settings.
+ *
+ * Identical to sim_run() except that the gravity solver (and any future
+ * tunables) come from @p config.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param time_step  Duration of each tick (s).
+ * @param num_steps  Total number of ticks to simulate.
+ * @param config     Simulation settings. NULL selects sim_config_default().
+ * @return           0 on success, -1 if the context or its buffers could not
+ *                   be allocated (objects are left unchanged).
+ */
+int sim_run_config(PhysicsObject *objects, int count, double time_step,
+                   int num_steps, const SimConfig *config);
+
+/**
+ * @brief sim_run_config() that also reports how much work was done.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param time_step  Duration of each tick (s); the largest block step.
+ * @param num_steps  Total number of ticks to simulate.
+ * @param config     Simulation settings. NULL selects sim_config_default().
+ * @param stats      Receives work counters for this call, or NULL.
+ * @return           0 on success, -1 if the context or its buffers could not
+ *                   be allocated (objects are left unchanged).
+ */
+int sim_run_stats(PhysicsObject *objects, int count, double time_step,
+                  int num_steps, const SimConfig *config, SimStats *stats);
+
+/**
+ * @brief Run until @p end_time with a global step chosen each step.
+ *
+ * Each step is a kick–drift–kick Velocity Verlet step of length
+ *
+ *   Δt = min( sqrt(2 ε / max_i |a_i|),  2 Δt_prev,  Δt from the last step's
+ *             error estimate,  Δt keeping each |Δa_i| / |a_i| near 1/4 )
+ *
+ * where ε = @p tolerance is the distance a body may move under its current
+ * acceleration in one step, so quiet phases take long steps and close
+ * encounters short ones. After the step, the per-step position error is
+ * estimated as max_i |a_i(t+Δt) − a_i(t)| Δt² / 12. A step whose estimate
+ * exceeds ε, or in which some body's acceleration changed by more than its
+ * own magnitude (a jump across an encounter), is rejected: the state is
+ * restored and Δt halved. The accelerations at the end of an accepted step
+ * start the next one, so each attempt costs one gravity pass. Collisions are
+ * resolved after every accepted step.
+ *
+ * Forces come from gravity_compute_ws() with @p config's solver;
+ * @p config->integrator is not used. The last step is shortened to land
+ * exactly on @p end_time.
+ *
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param end_time   Simulated time to advance by (s).
+ * @param tolerance  Per-step position tolerance ε (m). Must be > 0.
+ * @param config     Simulation settings. NULL selects sim_config_default().
+ * @param stats      Receives the accepted and rejected steps, force
+ *                   evaluations and smallest step taken, or NULL.
+ * @return           0 on success, -1 if scratch buffers could not be allocated
+ *                   (objects are left unchanged).
+ */
+int sim_run_until(PhysicsObject *objects, int count, double end_time,
+                  double tolerance, const SimConfig *config, SimStats *stats);
+
+/**
+ * @brief sim_run_stats() over a PhysicsWorld.
+ *
+ * Only the direct solver with the Verlet integrator runs natively on the
+ * world's arrays: newtonian_gravity_world(), collision_detect_world() with
+ * inelastic_collision_world(), then world_step(). Every other solver is
+ * staged into a PhysicsObject copy of the world's kinematics each tick (see
+ * gravity_compute_world_ws()), and every other integrator exports the whole
+ * world to a PhysicsObject array and imports it back at the end. With the
+ * default direct solver the result matches sim_run_stats() bitwise.
+ *
+ * @param world      World to advance. Must not be NULL.
+ * @param time_step  Duration of each tick (s).
+ * @param num_steps  Total number of ticks to simulate.
+ * @param config     Simulation settings. NULL selects sim_config_default().
+ * @param stats      Receives work counters for this call, or NULL.
+ * @return           0 on success, -1 if a staged integrator could not allocate
+ *                   its context (the world is left unchanged).
+ */
+int sim_run_world(PhysicsWorld *world, double time_step, int num_steps,
+                  const SimConfig *config, SimStats *stats);
+
+/**
+ * @brief Simulation state persisted across sim_step() calls.
+ *
+ * Owns the force and collision-pair buffers, a CollisionWorkspace, a
+ * GravityWorkspace and the block, Hermite and symplectic integrator states,
+ * so contexts share no mutable state and may step on separate threads. Buffers grow with the
+ * body count and are never shrunk. Opaque; create with sim_context_create().
+ */
+typedef struct SimContext SimContext;
+
+/**
+ * @brief Create a context that steps scenes with @p config.
+ *
+ * @param config  Simulation settings, copied. NULL selects sim_config_default().
+ * @return        New context, or NULL on allocation failure.
+ */
+SimContext *sim_context_create(const SimConfig *config);
+
+/** @brief Release @p ctx and everything it owns. NULL is ignored. */
+void sim_context_destroy(SimContext *ctx);
+
+/**
+ * @brief Advance @p objects by @p num_steps ticks, continuing from the last call.
+ *
+ * Any split of the same ticks across calls gives bitwise the same result as
+ * one call. The integrators that carry accelerations between ticks reuse them
+ * across calls too, so stepping one tick per frame costs no extra gravity
+ * passes. Call sim_context_invalidate() first if the objects were changed
+ * outside the context; a change of @p count invalidates automatically.
+ *
+ * @param ctx        Context from sim_context_create(). Must not be NULL.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param time_step  Duration of each tick (s).
+ * @param num_steps  Number of ticks to simulate.
+ * @return           0 on success, -1 if buffers could not be grown for
+ *                   @p count (objects are left unchanged).
+ */
+int sim_step(SimContext *ctx, PhysicsObject *objects, int count,
+             double time_step, int num_steps);
+
+/**
+ * @brief Discard state carried between ticks.
+ *
+ * Needed after positions, velocities or masses were edited between
+ * sim_step() calls (e.g. a keyframed object); the next tick recomputes
+ * forces from scratch.
+ */
+void sim_context_invalidate(SimContext *ctx);
+
+/**
+ * @brief Work counters accumulated over every sim_step() since creation.
+ *
+ * @param ctx  Context to query.
+ * @param out  Receives the counters. Must not be NULL.
+ */
+void sim_context_stats(const SimContext *ctx, SimStats *out);
+
+/**
+ * @brief The collision workspace owned by @p ctx.
+ *
+ * Read its high-water marks with collision_workspace_usage(), or pre-size it
+ * with collision_workspace_reserve() before the first sim_step().
+ */
+CollisionWorkspace *sim_context_collision(SimContext *ctx);
+
+/**
+ * @brief The gravity workspace owned by @p ctx.
+ *
+ * Every solver keeps its scratch and cached state here, so nothing is shared
+ * with gravity_compute() or other contexts.
  */
-void sim_run(PhysicsObject *objects, int count, double time_step,
-             int num_steps);
+GravityWorkspace *sim_context_gravity(SimContext *ctx);
 
 
 #ifdef __cplusplus
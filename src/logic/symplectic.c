@@ -0,0 +1,164 @@
+/**
+ * @file symplectic.c
+ * @brief Table-driven symplectic splitting integrators.
+ *
+ * @author Steven Kight
+ */
+
+#include "symplectic.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SPLIT_MAX_OPS 9
+
+/* One sub-step: a drift (x += c v Δt) or a kick (v += c a Δt). */
+typedef struct {
+    int    kick;
+    double coef;
+} SplitOp;
+
+typedef struct {
+    int     count;
+    SplitOp ops[SPLIT_MAX_OPS];
+} SplitScheme;
+
+/* Yoshida triple-jump weights: w1 = 1 / (2 − 2^(1/3)), w0 = 1 − 2 w1. */
+#define YOSHIDA_W1  1.3512071919596576
+#define YOSHIDA_W0 -1.7024143839193153
+
+/* Omelyan, Mryglod & Folk (2002) PEFRL coefficients. */
+#define PEFRL_XI      0.1786178958448091
+#define PEFRL_LAMBDA -0.2123418310626054
+#define PEFRL_CHI    -0.06626458266981849
+
+static const SplitScheme s_kdk = { 3, {
+    {1, 0.5}, {0, 1.0}, {1, 0.5},
+} };
+
+static const SplitScheme s_yoshida4 = { 7, {
+    {1, YOSHIDA_W1 / 2.0},
+    {0, YOSHIDA_W1},
+    {1, (YOSHIDA_W1 + YOSHIDA_W0) / 2.0},
+    {0, YOSHIDA_W0},
+    {1, (YOSHIDA_W0 + YOSHIDA_W1) / 2.0},
+    {0, YOSHIDA_W1},
+    {1, YOSHIDA_W1 / 2.0},
+} };
+
+static const SplitScheme s_forest_ruth = { 9, {
+    {0, PEFRL_XI},
+    {1, (1.0 - 2.0 * PEFRL_LAMBDA) / 2.0},
+    {0, PEFRL_CHI},
+    {1, PEFRL_LAMBDA},
+    {0, 1.0 - 2.0 * (PEFRL_CHI + PEFRL_XI)},
+    {1, PEFRL_LAMBDA},
+    {0, PEFRL_CHI},
+    {1, (1.0 - 2.0 * PEFRL_LAMBDA) / 2.0},
+    {0, PEFRL_XI},
+} };
+
+static const SplitScheme *scheme_for(SimIntegrator scheme) {
+    switch (scheme) {
+        case SIM_INTEGRATOR_KDK:         return &s_kdk;
+        case SIM_INTEGRATOR_YOSHIDA4:    return &s_yoshida4;
+        case SIM_INTEGRATOR_FOREST_RUTH: return &s_forest_ruth;
+        default:                         return NULL;
+    }
+}
+
+void symplectic_state_init(SymplecticState *state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void symplectic_state_free(SymplecticState *state) {
+    free(state->forces);
+    free(state->acc);
+    symplectic_state_init(state);
+}
+
+void symplectic_state_invalidate(SymplecticState *state) {
+    state->valid = 0;
+}
+
+int symplectic_evaluations_per_step(SimIntegrator scheme) {
+    const SplitScheme *s = scheme_for(scheme);
+    if (!s) return 0;
+
+    // Kicks after a drift need fresh forces. Steps repeat, so a scheme that
+    // ends on a kick hands its accelerations to the next step's first kick.
+    int passes = 0, drifted = !s->ops[s->count - 1].kick;
+    for (int k = 0; k < s->count; k++) {
+        if (!s->ops[k].kick) drifted = 1;
+        else if (drifted) { passes++; drifted = 0; }
+    }
+    return passes;
+}
+
+/* Grow the buffers to hold at least @p count entries. */
+static int symplectic_state_reserve(SymplecticState *state, int count) {
+    if (count <= state->capacity) return 0;
+
+    symplectic_state_free(state);
+    state->forces = malloc((size_t)count * sizeof(Vec3));
+    state->acc    = malloc((size_t)count * sizeof(Vec3));
+    if (!state->forces || !state->acc) {
+        symplectic_state_free(state);
+        return -1;
+    }
+    state->capacity = count;
+    return 0;
+}
+
+int symplectic_step(SymplecticState *state, SimIntegrator scheme,
+                    PhysicsObject *objects, int count, double time_step,
+                    const GravityConfig *gravity, GravityWorkspace *gravity_ws,
+                    SimStats *stats) {
+    const SplitScheme *s = scheme_for(scheme);
+    if (!s) return -1;
+    if (count <= 0) return 0;
+    if (symplectic_state_reserve(state, count) != 0) return -1;
+
+    for (int k = 0; k < s->count; k++) {
+        const double h = s->ops[k].coef * time_step;
+
+        if (!s->ops[k].kick) {
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < count; i++) {
+                objects[i].position = vec3_add(objects[i].position,
+                                               vec3_scale(objects[i].velocity, h));
+            }
+            state->valid = 0;
+            continue;
+        }
+
+        if (!state->valid) {
+            gravity_compute_ws(gravity_ws, gravity, objects, count,
+                               state->forces);
+            for (int i = 0; i < count; i++) {
+                state->acc[i] = vec3_div(state->forces[i], objects[i].mass);
+            }
+            state->valid = 1;
+            if (stats) stats->force_evaluations += count;
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++) {
+            objects[i].velocity = vec3_add(objects[i].velocity,
+                                           vec3_scale(state->acc[i], h));
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (state->valid) objects[i].acceleration = state->acc[i];
+        objects[i].force = (Vec3){0.0, 0.0, 0.0};
+    }
+
+    if (stats) {
+        stats->steps++;
+        if (stats->min_time_step <= 0.0 || time_step < stats->min_time_step) {
+            stats->min_time_step = time_step;
+        }
+    }
+    return 0;
+}
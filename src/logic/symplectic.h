@@ -0,0 +1,101 @@
+/**
+ * @file symplectic.h
+ * @brief Symplectic splitting integrators: KDK leapfrog, Yoshida, Forest–Ruth.
+ *
+ * Each scheme is a fixed sequence of drifts x += c_k v Δt and kicks
+ * v += d_k a(x) Δt. Because every sub-step is an exact flow of part of the
+ * Hamiltonian, the composition is symplectic: energy errors oscillate
+ * instead of drifting, which is what long orbital runs need.
+ *
+ *   Scheme                   Order  Gravity passes / step
+ *   KDK leapfrog             2      1
+ *   Yoshida (triple jump)    4      3
+ *   Forest–Ruth (PEFRL)      4      4
+ *
+ * Yoshida composes three leapfrogs with weights w₁, w₀, w₁
+ * (w₁ = 1 / (2 − 2^⅓), w₀ = 1 − 2w₁) in kick-first form. Forest–Ruth here is
+ * Omelyan, Mryglod and Folk's position-extended Forest–Ruth-like scheme,
+ * which spends one more pass than Yoshida for an error constant roughly two
+ * orders of magnitude smaller.
+ *
+ * A kick reuses the accelerations of the previous kick when no drift has
+ * happened since, so kick-first schemes evaluate forces once fewer per step
+ * ("first same as last"). Forces come from gravity_compute_ws(), so any solver
+ * selected in the scene's GravityConfig can drive these integrators.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef SYMPLECTIC_H
+#define SYMPLECTIC_H
+
+#include "sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Accelerations carried between steps.
+ *
+ * Zero-initialise (or call symplectic_state_init()) before first use; buffers
+ * are reused across steps and only grow.
+ */
+typedef struct {
+    int   capacity;
+    int   valid;   /**< 1 while acc matches the objects' current positions. */
+    Vec3 *forces;
+    Vec3 *acc;
+} SymplecticState;
+
+/** Zero-initialise @p state. */
+void symplectic_state_init(SymplecticState *state);
+
+/** Release the buffers owned by @p state and reset it. */
+void symplectic_state_free(SymplecticState *state);
+
+/**
+ * @brief Mark cached accelerations stale after positions changed externally.
+ *
+ * Velocity-only changes such as collision impulses do not require this, as
+ * accelerations depend on positions alone.
+ */
+void symplectic_state_invalidate(SymplecticState *state);
+
+/**
+ * @brief Gravity passes per step of @p scheme once accelerations are cached.
+ *
+ * @return 1, 3 or 4 for KDK, Yoshida and Forest–Ruth; 0 for integrators
+ *         that are not symplectic splittings.
+ */
+int symplectic_evaluations_per_step(SimIntegrator scheme);
+
+/**
+ * @brief Advance every object by one step of @p scheme.
+ *
+ * On return each object's acceleration field holds the last evaluated
+ * acceleration and its force is reset to zero, matching object_step().
+ *
+ * @param state      Persistent accelerations.
+ * @param scheme     SIM_INTEGRATOR_KDK, SIM_INTEGRATOR_YOSHIDA4 or
+ *                   SIM_INTEGRATOR_FOREST_RUTH.
+ * @param objects    Pointer to an array of PhysicsObject. Must not be NULL.
+ * @param count      Number of objects (N).
+ * @param time_step  Step length Δt (s).
+ * @param gravity    Gravity solver and tunables.
+ * @param gravity_ws Gravity solver state, or NULL for the shared workspace
+ *                   (see gravity_compute_ws()).
+ * @param stats      Counters to accumulate into, or NULL.
+ * @return           0 on success, -1 if @p scheme is not a splitting scheme or
+ *                   the buffers could not be allocated (objects unchanged).
+ */
+int symplectic_step(SymplecticState *state, SimIntegrator scheme,
+                    PhysicsObject *objects, int count, double time_step,
+                    const GravityConfig *gravity, GravityWorkspace *gravity_ws,
+                    SimStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYMPLECTIC_H */
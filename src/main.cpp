@@ -1,11 +1,22 @@
 
 
+#include "logic/forces/gravity.h"
+#include "logic/forces/gravity_simd.h"
+#include "logic/forces/gravity_tiled.h"
 #include "logic/sim.h"
+#include "logic/collision/aabb_tree.h"
+#include "logic/collision/octree.h"
+#include "logic/collision/spatial_hash.h"
+#include "logic/collision/sweep_prune.h"
 #include "math/matrix.h"
 #include "models/object.h"
+#include "models/world.h"
 
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 
 static void test_matrix() {
     const int n = 2, m = 2;
@@ -71,8 +82,214 @@ static void test_sim() {
               << objects[1].position.z << ")" << std::endl;
 }
 
+// Times one direct-sum gravity evaluation and reports wall time and GFLOP/s,
+// counting GRAVITY_FLOPS_PER_PAIR per ordered pair (N² − N pairs).
+static void bench_gravity_kernel(const char *name, const std::vector<PhysicsObject> &objects,
+                                 void (*kernel)(const PhysicsObject *, int, Vec3 *)) {
+    const int n = static_cast<int>(objects.size());
+    std::vector<Vec3> forces(n);
+
+    kernel(objects.data(), n, forces.data()); // warm-up: first-touch and cached buffers
+
+    auto start = std::chrono::high_resolution_clock::now();
+    kernel(objects.data(), n, forces.data());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double flops = static_cast<double>(GRAVITY_FLOPS_PER_PAIR) * n * (n - 1.0);
+    std::cout << "  " << name << ": " << seconds * 1e3 << " ms, "
+              << flops / seconds * 1e-9 << " GFLOP/s" << std::endl;
+}
+
+// The SIMD and tiled kernels run through gravity_compute() so their staging
+// stays in the shared workspace between the warm-up and the timed call.
+static void gravity_simd_shared(const PhysicsObject *objects, int count, Vec3 *forces_out) {
+    GravityConfig config;
+    gravity_config_default(&config);
+    config.solver = GRAVITY_SOLVER_SIMD;
+    gravity_compute(&config, objects, count, forces_out);
+}
+
+static void gravity_tiled_auto(const PhysicsObject *objects, int count, Vec3 *forces_out) {
+    GravityConfig config;
+    gravity_config_default(&config);
+    config.solver = GRAVITY_SOLVER_TILED; // tile_size 0: sized from L1
+    gravity_compute(&config, objects, count, forces_out);
+}
+
+static void bench_gravity_world(const std::vector<PhysicsObject> &objects) {
+    const int n = static_cast<int>(objects.size());
+    std::vector<Vec3> forces(n);
+    PhysicsWorld world;
+    world_init(&world);
+    if (world_import(&world, objects.data(), n) != 0) return;
+
+    newtonian_gravity_world(&world, GRAVITY_SOFTENING_NONE, 0.0, forces.data());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    newtonian_gravity_world(&world, GRAVITY_SOFTENING_NONE, 0.0, forces.data());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double flops = static_cast<double>(GRAVITY_FLOPS_PER_PAIR) * n * (n - 1.0);
+    std::cout << "  world soa: " << seconds * 1e3 << " ms, "
+              << flops / seconds * 1e-9 << " GFLOP/s" << std::endl;
+    world_free(&world);
+}
+
+static void bench_gravity() {
+    const int n = 4096;
+    std::vector<PhysicsObject> objects(n);
+    srand(42);
+    for (int i = 0; i < n; i++) {
+        object_init(&objects[i], 1.0e6 + rand() % 1000,
+                    rand() % 10000, rand() % 10000, rand() % 10000);
+    }
+
+    std::cout << "Gravity kernels, N = " << n << " (SIMD dispatch: "
+              << gravity_simd_level_name(gravity_simd_detect()) << ", tile: "
+              << gravity_tile_size_auto() << ")" << std::endl;
+    bench_gravity_kernel("direct   ", objects, newtonian_gravity_direct);
+    bench_gravity_kernel("symmetric", objects, newtonian_gravity_symmetric);
+    bench_gravity_kernel("simd     ", objects, gravity_simd_shared);
+    bench_gravity_kernel("tiled    ", objects, gravity_tiled_auto);
+    bench_gravity_kernel("mixed    ", objects, newtonian_gravity_mixed);
+    bench_gravity_world(objects);
+}
+
+// Times octree_build() + octree_query_pairs() on cube lattices 0.9 m apart,
+// where every cube overlaps its 26 neighbours, and reports the cost per
+// candidate pair so the scaling of pair deduplication is visible.
+static void bench_broad_phase() {
+    static const Vec3 verts[8] = {
+        {-0.5, -0.5, -0.5}, {0.5, -0.5, -0.5}, {0.5, 0.5, -0.5}, {-0.5, 0.5, -0.5},
+        {-0.5, -0.5, 0.5},  {0.5, -0.5, 0.5},  {0.5, 0.5, 0.5},  {-0.5, 0.5, 0.5},
+    };
+    static const int faces[12][3] = {
+        {0, 1, 2}, {0, 2, 3}, {4, 6, 5}, {4, 7, 6}, {0, 3, 7}, {0, 7, 4},
+        {1, 5, 6}, {1, 6, 2}, {0, 4, 5}, {0, 5, 1}, {3, 2, 6}, {3, 6, 7},
+    };
+    const int mesh = mesh_register(verts, 8, faces, 12);
+
+    OctreePool pool;
+    CollisionPairBuffer candidates;
+    octree_pool_init(&pool);
+    collision_pairs_init(&candidates);
+
+    std::cout << "Octree broad phase, cube lattice" << std::endl;
+    for (int side : {6, 10, 16, 22, 28}) {
+        const int n = side * side * side;
+        std::vector<CollisionBody> bodies(n);
+        for (int i = 0; i < n; i++) {
+            Vec3 p = {0.9 * (i % side), 0.9 * (i / side % side), 0.9 * (i / (side * side))};
+            bodies[i] = collision_body_make(p, mesh);
+        }
+
+        octree_build(&pool, bodies.data(), n); // warm-up: grow the buffers
+        octree_query_pairs(&pool, &candidates);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        octree_build(&pool, bodies.data(), n);
+        int pairs = octree_query_pairs(&pool, &candidates);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << "  N = " << n << ": " << pairs << " candidates, " << ms << " ms, "
+                  << ms * 1e6 / pairs << " ns/candidate" << std::endl;
+    }
+
+    octree_pool_free(&pool);
+    collision_pairs_free(&candidates);
+}
+
+// Moving-debris scene: unit cubes drifting through a box, advanced a little
+// each tick. Compares the per-tick broad-phase cost of rebuilding the octree,
+// sweep and prune re-sorting its previous endpoints, rebuilding the spatial
+// hash grid, and refitting the AABB tree.
+static void bench_broad_phase_debris() {
+    static const Vec3 verts[8] = {
+        {-0.5, -0.5, -0.5}, {0.5, -0.5, -0.5}, {0.5, 0.5, -0.5}, {-0.5, 0.5, -0.5},
+        {-0.5, -0.5, 0.5},  {0.5, -0.5, 0.5},  {0.5, 0.5, 0.5},  {-0.5, 0.5, 0.5},
+    };
+    static const int faces[12][3] = {
+        {0, 1, 2}, {0, 2, 3}, {4, 6, 5}, {4, 7, 6}, {0, 3, 7}, {0, 7, 4},
+        {1, 5, 6}, {1, 6, 2}, {0, 4, 5}, {0, 5, 1}, {3, 2, 6}, {3, 6, 7},
+    };
+    const int mesh = mesh_register(verts, 8, faces, 12);
+    const int ticks = 20;
+
+    std::cout << "Broad phase on moving debris (" << ticks << " ticks)" << std::endl;
+    for (int n : {2000, 20000, 100000}) {
+        const double side = 3.0 * std::cbrt(static_cast<double>(n));  // ~0.3 overlaps per body
+        std::vector<Vec3> position(n), velocity(n);
+        srand(5);
+        for (int i = 0; i < n; i++) {
+            position[i] = {side * rand() / RAND_MAX, side * rand() / RAND_MAX,
+                           side * rand() / RAND_MAX};
+            velocity[i] = {0.02 * rand() / RAND_MAX - 0.01, 0.02 * rand() / RAND_MAX - 0.01,
+                           0.02 * rand() / RAND_MAX - 0.01};
+        }
+
+        OctreePool pool;
+        SweepPrune sap;
+        SpatialHash grid;
+        AabbTree tree;
+        CollisionPairBuffer candidates;
+        octree_pool_init(&pool);
+        sweep_prune_init(&sap);
+        spatial_hash_init(&grid);
+        aabb_tree_init(&tree);
+        collision_pairs_init(&candidates);
+
+        std::vector<CollisionBody> bodies(n);
+        double octree_ms = 0.0, sweep_ms = 0.0, grid_ms = 0.0, tree_ms = 0.0;
+        int octree_pairs = 0, sweep_pairs = 0, grid_pairs = 0, tree_pairs = 0;
+        for (int tick = 0; tick <= ticks; tick++) {
+            for (int i = 0; i < n; i++) {
+                position[i] = vec3_add(position[i], velocity[i]);
+                bodies[i]   = collision_body_make(position[i], mesh);
+            }
+
+            auto t0 = std::chrono::high_resolution_clock::now();
+            octree_build(&pool, bodies.data(), n);
+            octree_pairs = octree_query_pairs(&pool, &candidates);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            sweep_prune_update(&sap, bodies.data(), n);
+            sweep_pairs = sweep_prune_query_pairs(&sap, &candidates);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            spatial_hash_build(&grid, bodies.data(), n);
+            grid_pairs = spatial_hash_query_pairs(&grid, &candidates);
+            auto t3 = std::chrono::high_resolution_clock::now();
+            aabb_tree_update(&tree, bodies.data(), n);
+            tree_pairs = aabb_tree_query_pairs(&tree, &candidates);
+            auto t4 = std::chrono::high_resolution_clock::now();
+
+            if (tick == 0) continue;  // warm-up: buffers grow, first full sort
+            octree_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            sweep_ms  += std::chrono::duration<double, std::milli>(t2 - t1).count();
+            grid_ms   += std::chrono::duration<double, std::milli>(t3 - t2).count();
+            tree_ms   += std::chrono::duration<double, std::milli>(t4 - t3).count();
+        }
+
+        std::cout << "  N = " << n << ": octree " << octree_ms / ticks << " ms/tick ("
+                  << octree_pairs << " candidates), sweep " << sweep_ms / ticks
+                  << " ms/tick (" << sweep_pairs << " candidates), grid " << grid_ms / ticks
+                  << " ms/tick (" << grid_pairs << " candidates), tree " << tree_ms / ticks
+                  << " ms/tick (" << tree_pairs << " candidates)" << std::endl;
+
+        octree_pool_free(&pool);
+        sweep_prune_free(&sap);
+        spatial_hash_free(&grid);
+        aabb_tree_free(&tree);
+        collision_pairs_free(&candidates);
+    }
+}
+
 int main() {
     // test_matrix();
     test_sim();
+    bench_gravity();
+    bench_broad_phase();
+    bench_broad_phase_debris();
     return 0;
 }
@@ -27,12 +27,21 @@ contains
     real(c_double), intent(in)  :: A(*)
     real(c_double), intent(in)  :: power
     real(c_double), intent(out) :: C(*)
-    integer :: i, j, idx
-    do i = 1, n
-      do j = 1, m
-        idx = (i - 1) * m + j
+    integer :: idx
+    ! A real exponent makes ** a pow() call per element. The gravity pipeline
+    ! only uses squares and square roots, so those get vectorisable loops.
+    if (power == 2.0_c_double) then
+      do idx = 1, n * m
+        C(idx) = A(idx) * A(idx)
+      end do
+    else if (power == 0.5_c_double) then
+      do idx = 1, n * m
+        C(idx) = sqrt(A(idx))
+      end do
+    else
+      do idx = 1, n * m
         C(idx) = A(idx) ** power
       end do
-    end do
+    end if
   end subroutine matrix_power
 end module matrix_power_mod
@@ -0,0 +1,114 @@
+/**
+ * @file mesh.c
+ * @brief Process-wide mesh registry backed by shared vertex and face pools.
+ *
+ * @author Steven Kight
+ */
+
+#include "mesh.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Mesh records (id k at s_meshes[k - 1]) and the pools they index. All three
+ * arrays grow geometrically and are never shrunk until cleared. Growth moves
+ * them, so registration must not overlap any lookup (see mesh.h).
+ */
+static ObjectMesh *s_meshes        = NULL;
+static int         s_mesh_count    = 0;
+static int         s_mesh_capacity = 0;
+
+static Vec3 *s_verts           = NULL;
+static int   s_vertex_count    = 0;
+static int   s_vertex_capacity = 0;
+
+static int (*s_faces)[3]     = NULL;
+static int   s_face_count    = 0;
+static int   s_face_capacity = 0;
+
+/* Grow *pool (elements of @p size bytes) to hold at least @p needed entries. */
+static int pool_reserve(void **pool, int *capacity, int needed, size_t size) {
+    if (needed <= *capacity) return 0;
+
+    int grown = *capacity ? *capacity : 64;
+    while (grown < needed) {
+        grown = grown > INT_MAX / 2 ? needed : 2 * grown;
+    }
+    void *block = realloc(*pool, (size_t)grown * size);
+    if (!block) return -1;
+    *pool     = block;
+    *capacity = grown;
+    return 0;
+}
+
+int mesh_register(const Vec3 *verts, int vertex_count,
+                  const int (*faces)[3], int face_count) {
+    if (!verts || !faces || vertex_count <= 0 || face_count <= 0) return -1;
+    if (vertex_count > INT_MAX - s_vertex_count) return -1;
+    if (face_count > INT_MAX - s_face_count) return -1;
+    for (int f = 0; f < face_count; f++) {
+        for (int k = 0; k < 3; k++) {
+            if (faces[f][k] < 0 || faces[f][k] >= vertex_count) return -1;
+        }
+    }
+
+    // Reserve everything before appending, so a failure leaves the registry
+    // unchanged.
+    if (pool_reserve((void **)&s_meshes, &s_mesh_capacity,
+                     s_mesh_count + 1, sizeof(ObjectMesh)) != 0 ||
+        pool_reserve((void **)&s_verts, &s_vertex_capacity,
+                     s_vertex_count + vertex_count, sizeof(Vec3)) != 0 ||
+        pool_reserve((void **)&s_faces, &s_face_capacity,
+                     s_face_count + face_count, sizeof(s_faces[0])) != 0) {
+        return -1;
+    }
+
+    ObjectMesh *mesh    = &s_meshes[s_mesh_count];
+    mesh->vertex_offset = s_vertex_count;
+    mesh->vertex_count  = vertex_count;
+    mesh->face_offset   = s_face_count;
+    mesh->face_count    = face_count;
+
+    memcpy(s_verts + s_vertex_count, verts, (size_t)vertex_count * sizeof(Vec3));
+    memcpy(s_faces + s_face_count, faces, (size_t)face_count * sizeof(s_faces[0]));
+    s_vertex_count += vertex_count;
+    s_face_count   += face_count;
+
+    return ++s_mesh_count;
+}
+
+const ObjectMesh *mesh_get(int mesh_id) {
+    if (mesh_id <= MESH_NONE || mesh_id > s_mesh_count) return NULL;
+    return &s_meshes[mesh_id - 1];
+}
+
+const Vec3 *mesh_vertex_pool(void) {
+    return s_verts;
+}
+
+const int (*mesh_face_pool(void))[3] {
+    return (const int (*)[3])s_faces;
+}
+
+int mesh_registry_count(void) {
+    return s_mesh_count;
+}
+
+void mesh_registry_usage(int *vertices, int *faces) {
+    if (vertices) *vertices = s_vertex_count;
+    if (faces)    *faces    = s_face_count;
+}
+
+void mesh_registry_clear(void) {
+    free(s_meshes);
+    free(s_verts);
+    free(s_faces);
+    s_meshes = NULL;
+    s_verts  = NULL;
+    s_faces  = NULL;
+    s_mesh_count = s_mesh_capacity = 0;
+    s_vertex_count = s_vertex_capacity = 0;
+    s_face_count = s_face_capacity = 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file mesh.h
+ * @brief Mesh registry: convex collision meshes stored once, shared by id.
+ *
+ * Scenes typically reuse a handful of hulls (debris chunks, asteroids) across
+ * thousands of bodies. Each distinct mesh is registered once and bodies refer
+ * to it through PhysicsObject.mesh_id, so a body carries a 4-byte reference
+ * instead of its own copy of the geometry and copying body state stays cheap.
+ *
+ * Geometry of every mesh is appended to two shared pools, one of vertices and
+ * one of triangles, and a mesh is an offset+count range into each. Meshes can
+ * therefore be any size, and each costs exactly the storage of its own
+ * vertices and faces.
+ *
+ * Id MESH_NONE (0) means "no mesh": the body is a point mass for collision
+ * detection, which is also what a zero-initialised PhysicsObject gets.
+ *
+ * The registry is process-wide and unsynchronised. Register and clear meshes
+ * only while no run is in progress; runs themselves only read it, so any
+ * number of SimContexts may collide against the same meshes concurrently.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef MESH_H
+#define MESH_H
+
+#include "object.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Id of "no mesh" (point mass). Registered meshes get ids 1, 2, … */
+#define MESH_NONE 0
+
+/**
+ * @brief Convex collision mesh in local space, as ranges of the shared pools.
+ *
+ * Face indices are relative to the mesh's own first vertex, so
+ * mesh_faces(m)[f][k] indexes mesh_vertices(m).
+ */
+typedef struct {
+    int vertex_offset; /**< First vertex in mesh_vertex_pool(). */
+    int vertex_count;  /**< Vertices in the range (> 0). */
+    int face_offset;   /**< First triangle in mesh_face_pool(). */
+    int face_count;    /**< Triangles in the range (> 0). */
+} ObjectMesh;
+
+/**
+ * @brief Append a convex mesh to the pools and return its id.
+ *
+ * CONVEX GEOMETRY ONLY: the SAT narrow phase assumes every registered mesh is
+ * convex.
+ *
+ * @param verts         Local-space vertex positions.
+ * @param vertex_count  Entries in @p verts (> 0).
+ * @param faces         Vertex index triples (CCW winding), each index in
+ *                      [0, vertex_count).
+ * @param face_count    Entries in @p faces (> 0).
+ * @return              The new mesh id (> 0), or -1 if the mesh is empty, an
+ *                      index is out of range or the pools could not grow.
+ */
+int mesh_register(const Vec3 *verts, int vertex_count,
+                  const int (*faces)[3], int face_count);
+
+/**
+ * @brief Look up a registered mesh.
+ *
+ * @return The mesh, or NULL for MESH_NONE and unknown ids. Valid until the
+ *         next mesh_register() or mesh_registry_clear().
+ */
+const ObjectMesh *mesh_get(int mesh_id);
+
+/**
+ * @brief Base of the shared vertex pool.
+ *
+ * Like every pointer into the registry, valid until the next
+ * mesh_register() or mesh_registry_clear().
+ */
+const Vec3 *mesh_vertex_pool(void);
+
+/** Base of the shared triangle pool (same lifetime as mesh_vertex_pool()). */
+const int (*mesh_face_pool(void))[3];
+
+/** Local-space vertices of @p mesh. */
+static inline const Vec3 *mesh_vertices(const ObjectMesh *mesh) {
+    return mesh_vertex_pool() + mesh->vertex_offset;
+}
+
+/** Triangles of @p mesh, indexing mesh_vertices(). */
+static inline const int (*mesh_faces(const ObjectMesh *mesh))[3] {
+    return mesh_face_pool() + mesh->face_offset;
+}
+
+/** Number of registered meshes (the largest valid id). */
+int mesh_registry_count(void);
+
+/**
+ * @brief Total vertices and triangles held in the pools.
+ *
+ * @param vertices  Receives the vertex total, or NULL.
+ * @param faces     Receives the triangle total, or NULL.
+ */
+void mesh_registry_usage(int *vertices, int *faces);
+
+/** Forget every mesh and release the pools. Ids restart at 1. */
+void mesh_registry_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESH_H */
@@ -6,6 +6,7 @@
  */
 
 #include "object.h"
+#include "mesh.h"
 
 #include <math.h>
 
@@ -27,6 +28,12 @@ void object_init(PhysicsObject *obj, double mass, double x, double y, double z)
     obj->position.x = x;
     obj->position.y = y;
     obj->position.z = z;
+
+    /* No mesh: a point mass for collision detection until one is attached. */
+    obj->mesh_id = MESH_NONE;
+    obj->_pad0   = 0;
+
+    obj->softening = 0.0;
 }
 
 void object_step(PhysicsObject *obj, double time_step) {
@@ -14,20 +14,15 @@
 extern "C" {
 #endif
 
-/** Maximum vertices and triangular faces per convex mesh. */
-#define PHYS_MAX_VERTICES 64
-#define PHYS_MAX_FACES    32
-
 /**
  * @brief A rigid body with mass, kinematics, an accumulated net force, and
  *        an optional convex collision mesh.
  *
  * Kinematic fields (mass … force) are at fixed offsets and unchanged from the
- * original layout. Geometry fields are appended at the end and default to zero
- * (vertex_count == 0 means no collision geometry assigned).
- *
- * Mesh vertices are stored in local (body) space centred at the origin.
- * face_indices[f] holds three vertex indices forming triangle f in CCW winding.
+ * original layout. Collision geometry lives in the mesh registry (mesh.h);
+ * the object holds only its id, and MESH_NONE (0, the zero-initialised value)
+ * means no collision geometry assigned. Per-object gravity settings follow
+ * (also zero = solver defaults).
  */
 typedef struct {
     /* --- Kinematic fields (offsets unchanged) --- */
@@ -37,13 +32,12 @@ typedef struct {
     Vec3 acceleration; /**< Acceleration from the previous step (m/s^2). */
     Vec3 force;        /**< Accumulated net force; reset to zero by step(). */
 
-    /* --- Convex mesh geometry (local space) --- */
-    int  vertex_count; /**< Number of valid entries in local_verts (0 = no mesh). */
+    /* --- Convex mesh geometry --- */
+    int  mesh_id;      /**< Registered mesh (mesh_register()); 0 = no mesh. */
     int  _pad0;        /**< Alignment padding — do not use. */
-    Vec3 local_verts[PHYS_MAX_VERTICES]; /**< Vertex positions in local space. */
-    int  face_count;   /**< Number of valid triangles in face_indices. */
-    int  _pad1;        /**< Alignment padding — do not use. */
-    int  face_indices[PHYS_MAX_FACES][3]; /**< Vertex index triples, CCW winding. */
+
+    /* --- Gravity --- */
+    double softening;  /**< Gravitational softening length (m); 0 = use the solver's global length. */
 } PhysicsObject;
 
 /**
@@ -0,0 +1,125 @@
+/**
+ * @file world.c
+ * @brief PhysicsWorld allocation, AoS conversion and integration.
+ *
+ * @author Steven Kight
+ */
+
+#include "world.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void world_init(PhysicsWorld *world) {
+    memset(world, 0, sizeof(*world));
+}
+
+void world_free(PhysicsWorld *world) {
+    free(world->mass);
+    free(world->position);
+    free(world->velocity);
+    free(world->acceleration);
+    free(world->force);
+    free(world->softening);
+    free(world->mesh_id);
+    world_init(world);
+}
+
+int world_reserve(PhysicsWorld *world, int capacity) {
+    if (capacity <= world->capacity) return 0;
+
+    const size_t n = (size_t)capacity;
+    PhysicsWorld grown = {
+        .count        = world->count,
+        .capacity     = capacity,
+        .mass         = malloc(n * sizeof(double)),
+        .position     = malloc(n * sizeof(Vec3)),
+        .velocity     = malloc(n * sizeof(Vec3)),
+        .acceleration = malloc(n * sizeof(Vec3)),
+        .force        = malloc(n * sizeof(Vec3)),
+        .softening    = malloc(n * sizeof(double)),
+        .mesh_id      = malloc(n * sizeof(int)),
+    };
+    if (!grown.mass || !grown.position || !grown.velocity ||
+        !grown.acceleration || !grown.force || !grown.softening || !grown.mesh_id) {
+        world_free(&grown);
+        return -1;
+    }
+
+    const size_t live = (size_t)world->count;
+    if (live > 0) {
+        memcpy(grown.mass,         world->mass,         live * sizeof(double));
+        memcpy(grown.position,     world->position,     live * sizeof(Vec3));
+        memcpy(grown.velocity,     world->velocity,     live * sizeof(Vec3));
+        memcpy(grown.acceleration, world->acceleration, live * sizeof(Vec3));
+        memcpy(grown.force,        world->force,        live * sizeof(Vec3));
+        memcpy(grown.softening,    world->softening,    live * sizeof(double));
+        memcpy(grown.mesh_id,      world->mesh_id,      live * sizeof(int));
+    }
+
+    world_free(world);
+    *world = grown;
+    return 0;
+}
+
+int world_import(PhysicsWorld *world, const PhysicsObject *objects, int count) {
+    if (count < 0) count = 0;
+    if (world_reserve(world, count) != 0) return -1;
+
+    for (int i = 0; i < count; i++) {
+        const PhysicsObject *obj = &objects[i];
+        world->mass[i]         = obj->mass;
+        world->position[i]     = obj->position;
+        world->velocity[i]     = obj->velocity;
+        world->acceleration[i] = obj->acceleration;
+        world->force[i]        = obj->force;
+        world->softening[i]    = obj->softening;
+        world->mesh_id[i]      = obj->mesh_id;
+    }
+    world->count = count;
+    return 0;
+}
+
+void world_export(const PhysicsWorld *world, PhysicsObject *objects) {
+    for (int i = 0; i < world->count; i++) {
+        PhysicsObject *obj = &objects[i];
+
+        obj->mass         = world->mass[i];
+        obj->position     = world->position[i];
+        obj->velocity     = world->velocity[i];
+        obj->acceleration = world->acceleration[i];
+        obj->force        = world->force[i];
+        obj->softening    = world->softening[i];
+
+        obj->mesh_id      = world->mesh_id[i];
+        obj->_pad0        = 0;
+    }
+}
+
+void world_step(PhysicsWorld *world, double time_step) {
+    // Same expressions as object_step(), applied array by array.
+    const double dt2 = pow(time_step, 2);
+
+    // Each body's update reads and writes only index i, as in object_step().
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < world->count; i++) {
+        const Vec3 a = world->acceleration[i];
+        const Vec3 v = world->velocity[i];
+
+        // a_{t+dt} = F_net / m
+        Vec3 next_a = vec3_div(world->force[i], world->mass[i]);
+
+        // v_{t+dt} = v_t + ((a_t + a_{t+dt}) / 2) * dt
+        world->velocity[i] = vec3_add(
+            v, vec3_scale(vec3_div(vec3_add(a, next_a), 2), time_step));
+
+        // x_{t+dt} = x_t + v_t * dt + (1/2) * a_t * dt^2
+        world->position[i] = vec3_add(
+            vec3_add(world->position[i], vec3_scale(v, time_step)),
+            vec3_div(vec3_scale(a, dt2), 2));
+
+        world->acceleration[i] = next_a;
+        world->force[i]        = (Vec3){0.0, 0.0, 0.0};
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file world.h
+ * @brief PhysicsWorld: structure-of-arrays storage for simulation state.
+ *
+ * The gravity and integration loops read only a few fields of each body, but
+ * an array of PhysicsObject interleaves every field. PhysicsWorld stores each
+ * field in its own contiguous array, so those loops stream just the fields
+ * they use, and the mesh reference sits in a cold array touched only by
+ * collision detection:
+ *
+ *   mass[i], position[i], velocity[i], acceleration[i], force[i], softening[i]
+ *   mesh_id[i]   (registered mesh, read by the collision pipeline)
+ *
+ * Index i refers to the same body in every array. world_import() and
+ * world_export() convert to and from the PhysicsObject layout, so callers can
+ * adopt the world incrementally.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "object.h"
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Simulation state for @c count bodies as parallel arrays.
+ *
+ * Arrays hold @c capacity entries; only the first @c count are live.
+ * Zero-initialise (or call world_init()) before first use.
+ */
+typedef struct {
+    int         count;
+    int         capacity;
+    double     *mass;          /**< Mass (kg). */
+    Vec3       *position;      /**< Position (m). */
+    Vec3       *velocity;      /**< Velocity (m/s). */
+    Vec3       *acceleration;  /**< Acceleration from the previous step (m/s^2). */
+    Vec3       *force;         /**< Accumulated net force; reset to zero by world_step(). */
+    double     *softening;     /**< Gravitational softening length (m); 0 = global. */
+    int        *mesh_id;       /**< Registered mesh id; MESH_NONE = point (cold). */
+} PhysicsWorld;
+
+/** Zero-initialise @p world. */
+void world_init(PhysicsWorld *world);
+
+/** Release all arrays owned by @p world and reset it. */
+void world_free(PhysicsWorld *world);
+
+/**
+ * @brief Ensure room for at least @p capacity bodies, preserving live bodies.
+ *
+ * @return 0 on success, -1 on allocation failure (the world is unchanged).
+ */
+int world_reserve(PhysicsWorld *world, int capacity);
+
+/**
+ * @brief Replace the world's contents with a copy of @p objects.
+ *
+ * @return 0 on success, -1 on allocation failure (the world is unchanged).
+ */
+int world_import(PhysicsWorld *world, const PhysicsObject *objects, int count);
+
+/**
+ * @brief Write every body back into @p objects (world->count entries).
+ *
+ * Kinematics, softening and mesh id are copied; alignment padding is zeroed.
+ */
+void world_export(const PhysicsWorld *world, PhysicsObject *objects);
+
+/**
+ * @brief Advance every body by one Velocity Verlet step.
+ *
+ * Performs exactly the arithmetic of object_step() on each body, so a world
+ * and the equivalent PhysicsObject array stay bitwise identical, then resets
+ * every force to zero.
+ *
+ * @param world      World to advance.
+ * @param time_step  Duration of the step (s).
+ */
+void world_step(PhysicsWorld *world, double time_step);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WORLD_H */
@@ -0,0 +1,223 @@
+/**
+ * @file broad_phase_fixtures.h
+ * @brief Scenes and equivalence checks shared by the broad-phase tests.
+ *
+ * Every broad phase must report exactly the pairs whose AABBs overlap, and
+ * collision_detect_ws() must confirm the same pairs whichever one the
+ * workspace uses. The checks here state both once; each test file runs them
+ * against its own phase and keeps only the tests specific to that phase.
+ *
+ * Checks return NULL on success or the failed assertion's message, like a
+ * minunit test body, so a test can simply return their result.
+ *
+ * @author Steven Kight
+ */
+
+#ifndef BROAD_PHASE_FIXTURES_H
+#define BROAD_PHASE_FIXTURES_H
+
+#include "sim.h"
+#include "collision/collision.h"
+#include "minunit.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Scenes                                                                 */
+/* ------------------------------------------------------------------ */
+
+/* Axis-aligned cube of side @p side centred on (x, y, z); one mesh per side. */
+static inline void make_cube(PhysicsObject *obj, double side,
+                             double x, double y, double z) {
+    enum { SIZES = 8 };
+    static double sides[SIZES];
+    static int ids[SIZES], registered;
+
+    int k = 0;
+    while (k < registered && sides[k] != side) k++;
+    if (k == registered) {
+        const double h = side / 2.0;
+        const Vec3 verts[8] = {
+            { -h, -h, -h }, {  h, -h, -h }, {  h,  h, -h }, { -h,  h, -h },
+            { -h, -h,  h }, {  h, -h,  h }, {  h,  h,  h }, { -h,  h,  h },
+        };
+        static const int faces[12][3] = {
+            {0, 1, 2}, {0, 2, 3}, {4, 6, 5}, {4, 7, 6}, {0, 3, 7}, {0, 7, 4},
+            {1, 5, 6}, {1, 6, 2}, {0, 4, 5}, {0, 5, 1}, {3, 2, 6}, {3, 6, 7},
+        };
+        sides[k] = side;
+        ids[k]   = mesh_register(verts, 8, faces, 12);
+        registered++;
+    }
+    memset(obj, 0, sizeof(*obj));
+    obj->mass     = 1.0;
+    obj->position = (Vec3){ x, y, z };
+    obj->mesh_id  = ids[k];
+}
+
+/* Unit cube centred on (x, y, z); same fixture as test_collision.c. */
+static inline void make_unit_cube(PhysicsObject *obj, double x, double y, double z) {
+    make_cube(obj, 1.0, x, y, z);
+}
+
+/* Debris field: cubes scattered through a 20 m box with small velocities. */
+static inline void make_debris(PhysicsObject *objects, int count) {
+    srand(3);
+    for (int i = 0; i < count; i++) {
+        make_unit_cube(&objects[i], rand() % 2000 * 0.01, rand() % 2000 * 0.01,
+                       rand() % 2000 * 0.01);
+        objects[i].velocity = (Vec3){ (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3 };
+    }
+}
+
+static inline void drift(PhysicsObject *objects, int count, double dt) {
+    for (int i = 0; i < count; i++)
+        objects[i].position = vec3_add(objects[i].position,
+                                       vec3_scale(objects[i].velocity, dt));
+}
+
+static inline void make_bodies(const PhysicsObject *objects, CollisionBody *bodies,
+                               int count) {
+    for (int i = 0; i < count; i++)
+        bodies[i] = collision_body_from_object(&objects[i]);
+}
+
+/* ------------------------------------------------------------------ */
+/* Pair sets                                                              */
+/* ------------------------------------------------------------------ */
+
+static inline int pair_cmp(const void *a, const void *b) {
+    const CollisionPair *p = a, *q = b;
+    if (p->index_a != q->index_a) return p->index_a < q->index_a ? -1 : 1;
+    return (p->index_b > q->index_b) - (p->index_b < q->index_b);
+}
+
+/* 1 if the two pair lists hold the same set (sorts both in place). */
+static inline int same_pairs(CollisionPair *a, int na, CollisionPair *b, int nb) {
+    if (na != nb) return 0;
+    qsort(a, na, sizeof(*a), pair_cmp);
+    qsort(b, nb, sizeof(*b), pair_cmp);
+    return memcmp(a, b, (size_t)na * sizeof(*a)) == 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Equivalence checks                                                     */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Brings a broad phase up to date with @p bodies and writes its candidate
+ * pairs to @p out. Returns the pair count, or -1 on failure.
+ */
+typedef int (*BroadPhaseCandidates)(void *phase, const CollisionBody *bodies,
+                                    int count, CollisionPairBuffer *out);
+
+/**
+ * Each of @p ticks ticks, the candidates are exactly the pairs whose AABBs
+ * overlap, found by brute force, each reported once as (lower, higher)
+ * index; the scene drifts by @p dt between ticks. @p count is at most 400.
+ */
+static inline char *check_matches_brute_force(PhysicsObject *objects, int count,
+                                              int ticks, double dt,
+                                              BroadPhaseCandidates candidates,
+                                              void *phase) {
+    enum { MAX_BODIES = 400, MAX = MAX_BODIES * (MAX_BODIES - 1) / 2 };
+    static CollisionBody bodies[MAX_BODIES];
+    static CollisionPair expected[MAX];
+    mu_assert("scene too large for the check", count <= MAX_BODIES);
+
+    CollisionPairBuffer out;
+    collision_pairs_init(&out);
+
+    char *message = NULL;
+    for (int tick = 0; tick < ticks && !message; tick++) {
+        make_bodies(objects, bodies, count);
+
+        int ne = 0;
+        for (int i = 0; i < count; i++)
+            for (int j = i + 1; j < count; j++)
+                if (aabb_overlaps(aabb_from_body(&bodies[i]), aabb_from_body(&bodies[j])))
+                    expected[ne++] = (CollisionPair){ i, j };
+
+        int n = candidates(phase, bodies, count, &out);
+        if (n < 0) {
+            message = "broad phase failed";
+        } else if (ne == 0) {
+            message = "scene has overlaps";
+        } else {
+            for (int k = 0; k < n; k++)
+                if (out.pairs[k].index_a >= out.pairs[k].index_b)
+                    message = "pair not canonical";
+            if (!message && !same_pairs(out.pairs, n, expected, ne))
+                message = "candidates differ from brute force";
+        }
+
+        drift(objects, count, dt);
+    }
+
+    collision_pairs_free(&out);
+    return message;
+}
+
+/**
+ * collision_detect_ws() confirms the same pairs with @p broad_phase as with
+ * the octree, each of @p ticks ticks, the scene drifting by @p dt between.
+ */
+static inline char *check_detect_matches_octree(PhysicsObject *objects, int count,
+                                                int ticks, double dt,
+                                                CollisionBroadPhase broad_phase) {
+    CollisionWorkspace octree, other;
+    CollisionPairBuffer a, b;
+    collision_workspace_init(&octree);
+    collision_workspace_init(&other);
+    collision_workspace_set_broad_phase(&other, broad_phase);
+    collision_pairs_init(&a);
+    collision_pairs_init(&b);
+
+    char *message = NULL;
+    for (int tick = 0; tick < ticks && !message; tick++) {
+        int na = collision_detect_ws(&octree, objects, count, &a);
+        int nb = collision_detect_ws(&other, objects, count, &b);
+        if (na == 0)
+            message = "scene has collisions";
+        else if (!same_pairs(a.pairs, na, b.pairs, nb))
+            message = "confirmed pairs differ";
+        drift(objects, count, dt);
+    }
+
+    collision_workspace_free(&octree);
+    collision_workspace_free(&other);
+    collision_pairs_free(&a);
+    collision_pairs_free(&b);
+    return message;
+}
+
+/**
+ * A simulation with one colliding pair follows the octree run bitwise when
+ * SimConfig selects @p broad_phase.
+ */
+static inline char *check_sim_matches_octree(CollisionBroadPhase broad_phase) {
+    enum { N = 6 };
+    PhysicsObject a[N], b[N];
+    for (int i = 0; i < N; i++)
+        make_unit_cube(&a[i], 5.0 * i, 0.0, 0.0);
+    a[1].position.x = 1.2;
+    a[1].velocity   = (Vec3){ -1.0, 0.0, 0.0 };
+    memcpy(b, a, sizeof(a));
+
+    SimConfig config;
+    sim_config_default(&config);
+    sim_run_config(a, N, 0.05, 40, &config);
+    config.broad_phase = broad_phase;
+    sim_run_config(b, N, 0.05, 40, &config);
+
+    mu_assert("cubes did not collide", a[1].velocity.x > -1.0);
+    for (int i = 0; i < N; i++) {
+        mu_assert("position differs", a[i].position.x == b[i].position.x);
+        mu_assert("velocity differs", a[i].velocity.x == b[i].velocity.x);
+    }
+    return NULL;
+}
+
+#endif /* BROAD_PHASE_FIXTURES_H */
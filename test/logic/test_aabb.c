@@ -9,16 +9,28 @@
 #include "test_runner.h"
 #include <string.h>
 
+/* Unit cube centred at the origin: verts at ±0.5 on each axis. */
+static int unit_cube_mesh(void) {
+    static const Vec3 verts[8] = {
+        { -0.5, -0.5, -0.5 }, {  0.5, -0.5, -0.5 },
+        {  0.5,  0.5, -0.5 }, { -0.5,  0.5, -0.5 },
+        { -0.5, -0.5,  0.5 }, {  0.5, -0.5,  0.5 },
+        {  0.5,  0.5,  0.5 }, { -0.5,  0.5,  0.5 },
+    };
+    static const int faces[1][3] = { {0, 1, 2} };  /* AABB reads vertices only */
+    return mesh_register(verts, 8, faces, 1);
+}
+
 /* ------------------------------------------------------------------ */
 /* aabb_from_object                                                       */
 /* ------------------------------------------------------------------ */
 
 static char *test_aabb_point_object() {
-    /* vertex_count == 0 → AABB is a single point at position */
+    /* No mesh → AABB is a single point at position */
     PhysicsObject obj;
     memset(&obj, 0, sizeof(obj));
     obj.position = (Vec3){ 3.0, -1.0, 2.0 };
-    obj.vertex_count = 0;
+    obj.mesh_id = MESH_NONE;
 
     AABB box = aabb_from_object(&obj);
 
@@ -36,15 +48,7 @@ static char *test_aabb_unit_cube_at_origin() {
     PhysicsObject obj;
     memset(&obj, 0, sizeof(obj));
     obj.position = (Vec3){ 0.0, 0.0, 0.0 };
-    obj.vertex_count = 8;
-    obj.local_verts[0] = (Vec3){ -0.5, -0.5, -0.5 };
-    obj.local_verts[1] = (Vec3){  0.5, -0.5, -0.5 };
-    obj.local_verts[2] = (Vec3){  0.5,  0.5, -0.5 };
-    obj.local_verts[3] = (Vec3){ -0.5,  0.5, -0.5 };
-    obj.local_verts[4] = (Vec3){ -0.5, -0.5,  0.5 };
-    obj.local_verts[5] = (Vec3){  0.5, -0.5,  0.5 };
-    obj.local_verts[6] = (Vec3){  0.5,  0.5,  0.5 };
-    obj.local_verts[7] = (Vec3){ -0.5,  0.5,  0.5 };
+    obj.mesh_id = unit_cube_mesh();
 
     AABB box = aabb_from_object(&obj);
 
@@ -62,15 +66,7 @@ static char *test_aabb_offset_position() {
     PhysicsObject obj;
     memset(&obj, 0, sizeof(obj));
     obj.position = (Vec3){ 2.0, 3.0, 4.0 };
-    obj.vertex_count = 8;
-    obj.local_verts[0] = (Vec3){ -0.5, -0.5, -0.5 };
-    obj.local_verts[1] = (Vec3){  0.5, -0.5, -0.5 };
-    obj.local_verts[2] = (Vec3){  0.5,  0.5, -0.5 };
-    obj.local_verts[3] = (Vec3){ -0.5,  0.5, -0.5 };
-    obj.local_verts[4] = (Vec3){ -0.5, -0.5,  0.5 };
-    obj.local_verts[5] = (Vec3){  0.5, -0.5,  0.5 };
-    obj.local_verts[6] = (Vec3){  0.5,  0.5,  0.5 };
-    obj.local_verts[7] = (Vec3){ -0.5,  0.5,  0.5 };
+    obj.mesh_id = unit_cube_mesh();
 
     AABB box = aabb_from_object(&obj);
 
@@ -0,0 +1,170 @@
+/**
+ * @file test_aabb_tree.c
+ * @brief Unit tests for the dynamic AABB tree broad phase.
+ *
+ * Tests cover: reinsertion of only the bodies that leave their fat boxes, a
+ * margin for point bodies without a mesh, and a balanced height for bodies
+ * inserted in sorted order, plus the shared checks from
+ * broad_phase_fixtures.h run on the tree: brute-force candidates over
+ * several ticks of motion, and the same confirmed pairs and simulation
+ * results as the octree.
+ *
+ * @author Steven Kight
+ */
+
+#include "collision/aabb_tree.h"
+#include "broad_phase_fixtures.h"
+#include "test_runner.h"
+
+/* ------------------------------------------------------------------ */
+/* Tests                                                                  */
+/* ------------------------------------------------------------------ */
+
+static int tree_candidates(void *phase, const CollisionBody *bodies, int count,
+                           CollisionPairBuffer *out) {
+    if (aabb_tree_update(phase, bodies, count) != 0) return -1;
+    return aabb_tree_query_pairs(phase, out);
+}
+
+/**
+ * Each tick of a drifting debris field the candidates match brute force —
+ * first from a fresh tree, then after reinsertions as bodies leave their
+ * fat boxes.
+ */
+static char *test_matches_brute_force() {
+    enum { N = 300 };
+    static PhysicsObject objects[N];
+    make_debris(objects, N);
+
+    AabbTree tree;
+    aabb_tree_init(&tree);
+    char *message = check_matches_brute_force(objects, N, 10, 5.0, tree_candidates, &tree);
+    aabb_tree_free(&tree);
+    return message;
+}
+
+/**
+ * Motion within the fat margin leaves the tree untouched; moving one body
+ * far away reinserts just that body; a change in body count rebuilds.
+ */
+static char *test_reinserts_only_escapees() {
+    enum { N = 500 };
+    static PhysicsObject objects[N];
+    static CollisionBody bodies[N];
+    make_debris(objects, N);
+
+    AabbTree tree;
+    aabb_tree_init(&tree);
+
+    make_bodies(objects, bodies, N);
+    aabb_tree_update(&tree, bodies, N);
+    const int nodes = tree.node_count;
+    mu_assert("tree should hold 2N - 1 nodes", nodes == 2 * N - 1);
+
+    drift(objects, N, 1.0);  // at most 0.1 m, inside the 0.25 m margin
+    make_bodies(objects, bodies, N);
+    aabb_tree_update(&tree, bodies, N);
+    mu_assert("small motion should reinsert nothing", tree.reinserted == 0);
+
+    objects[17].position = vec3_add(objects[17].position, (Vec3){ 50.0, 0.0, 0.0 });
+    make_bodies(objects, bodies, N);
+    aabb_tree_update(&tree, bodies, N);
+    mu_assert("only the moved body should be reinserted", tree.reinserted == 1);
+    mu_assert("reinsertion should recycle nodes", tree.node_count == nodes);
+
+    aabb_tree_update(&tree, bodies, N - 1);
+    mu_assert("count change not rebuilt", tree.count == N - 1 && tree.node_count == 2 * N - 3);
+
+    aabb_tree_free(&tree);
+    return NULL;
+}
+
+/**
+ * Point bodies (no mesh) have zero extent but still get the median-based
+ * margin floor, so small drift reinserts nothing — with cubes alongside
+ * them, and with no meshed body at all.
+ */
+static char *test_meshless_bodies_keep_margin() {
+    enum { N = 500 };
+    static PhysicsObject objects[N];
+    static CollisionBody bodies[N];
+
+    for (int stride = 2; stride >= 1; stride--) {
+        make_debris(objects, N);
+        for (int i = 0; i < N; i += stride)
+            objects[i].mesh_id = MESH_NONE;
+
+        AabbTree tree;
+        aabb_tree_init(&tree);
+        make_bodies(objects, bodies, N);
+        aabb_tree_update(&tree, bodies, N);
+        mu_assert("no margin floor", tree.min_margin > 0.0);
+
+        drift(objects, N, 1.0);  // at most 0.1 m
+        make_bodies(objects, bodies, N);
+        aabb_tree_update(&tree, bodies, N);
+        mu_assert("point bodies reinserted every tick", tree.reinserted == 0);
+        aabb_tree_free(&tree);
+    }
+    return NULL;
+}
+
+/**
+ * Cubes inserted in order along a line would build a chain without
+ * rebalancing; rotations keep the height logarithmic.
+ */
+static char *test_balanced_height() {
+    enum { N = 1024 };
+    static PhysicsObject objects[N];
+    static CollisionBody bodies[N];
+    for (int i = 0; i < N; i++)
+        make_unit_cube(&objects[i], 2.0 * i, 0.0, 0.0);
+    make_bodies(objects, bodies, N);
+
+    AabbTree tree;
+    aabb_tree_init(&tree);
+    aabb_tree_update(&tree, bodies, N);
+    int height = aabb_tree_height(&tree);
+    mu_assert("tree is not balanced", height >= 10 && height <= 20);
+
+    CollisionPairBuffer out;
+    collision_pairs_init(&out);
+    mu_assert("separated cubes should not pair", aabb_tree_query_pairs(&tree, &out) == 0);
+
+    aabb_tree_free(&tree);
+    collision_pairs_free(&out);
+    return NULL;
+}
+
+/**
+ * collision_detect_ws() confirms the same pairs with the AABB tree as with
+ * the octree, tick after tick.
+ */
+static char *test_detect_matches_octree() {
+    enum { N = 400 };
+    static PhysicsObject objects[N];
+    make_debris(objects, N);
+    return check_detect_matches_octree(objects, N, 5, 1.0, COLLISION_BROAD_BVH);
+}
+
+/**
+ * A simulation selecting the AABB tree through SimConfig follows the octree
+ * run bitwise.
+ */
+static char *test_sim_broad_phase() {
+    return check_sim_matches_octree(COLLISION_BROAD_BVH);
+}
+
+static const TestCase tests[] = {
+    {"matches_brute_force",         test_matches_brute_force},
+    {"reinserts_only_escapees",     test_reinserts_only_escapees},
+    {"meshless_bodies_keep_margin", test_meshless_bodies_keep_margin},
+    {"balanced_height",             test_balanced_height},
+    {"detect_matches_octree",       test_detect_matches_octree},
+    {"sim_broad_phase",             test_sim_broad_phase},
+};
+
+int main(void) {
+    int failed = run_suite("AABB Tree", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_adaptive_timestep.c
+ * @brief Unit tests for the adaptive global timestep controller.
+ *
+ * Tests cover: an eccentric orbit closing after one period with far fewer
+ * force evaluations than a fixed step at the periapsis resolution, a free
+ * body crossing the whole run in one step, and a fast flyby that the step
+ * criterion underestimates being caught by step rejection.
+ *
+ * @author Steven Kight
+ */
+
+#include "sim.h"
+#include "test_runner.h"
+#include <math.h>
+#include <stdio.h>
+
+static const double G = GRAVITATIONAL_CONSTANT;
+
+/**
+ * Equal-mass binary with e = 0.9 started at apoapsis: the periapsis passage is
+ * ~400× faster than apoapsis, so a fixed step wastes nearly all its work.
+ */
+static char *test_eccentric_orbit() {
+    const double mass = 1.0e20, a = 1.0e3, e = 0.9;
+    const double gm     = G * 2.0 * mass;
+    const double period = 2.0 * M_PI * sqrt(a * a * a / gm);
+    const double r_apo  = a * (1.0 + e);
+    const double v_apo  = sqrt(gm * (1.0 - e) / r_apo);   /* relative speed */
+
+    PhysicsObject objects[2];
+    object_init(&objects[0], mass, -r_apo / 2.0, 0.0, 0.0);
+    object_init(&objects[1], mass,  r_apo / 2.0, 0.0, 0.0);
+    objects[0].velocity = (Vec3){0.0, -v_apo / 2.0, 0.0};
+    objects[1].velocity = (Vec3){0.0,  v_apo / 2.0, 0.0};
+
+    SimStats stats;
+    mu_assert("sim_run_until failed",
+              sim_run_until(objects, 2, period, 1e-2, NULL, &stats) == 0);
+
+    double err = vec3_magnitude(vec3_sub(objects[1].position, (Vec3){r_apo / 2.0, 0.0, 0.0}));
+    double fixed = 2.0 * (period / stats.min_time_step);
+    printf("    %lld steps (%lld rejected), %lld evaluations vs %.0f fixed, closure %.3e m\n",
+           stats.steps, stats.rejected_steps, stats.force_evaluations, fixed, err);
+
+    mu_assert("orbit did not close", err < 1e-2 * a);
+    mu_assert("adaptive steps saved too little work",
+              (double)stats.force_evaluations * 5.0 < fixed);
+    return NULL;
+}
+
+/**
+ * With no acceleration the only limit is the end time: one step, exact drift.
+ */
+static char *test_free_body_single_step() {
+    PhysicsObject body;
+    object_init(&body, 1.0, 0.0, 0.0, 0.0);
+    body.velocity = (Vec3){1.0, -2.0, 0.5};
+
+    SimStats stats;
+    mu_assert("sim_run_until failed",
+              sim_run_until(&body, 1, 100.0, 1e-3, NULL, &stats) == 0);
+
+    mu_assert("free body took more than one step", stats.steps == 1);
+    mu_assert_double_eq("x", body.position.x, 100.0, 1e-12);
+    mu_assert_double_eq("y", body.position.y, -200.0, 1e-12);
+    mu_assert_double_eq("z", body.position.z, 50.0, 1e-12);
+    return NULL;
+}
+
+/**
+ * Two bodies start far apart on a fast hyperbolic flyby, where |a| is tiny
+ * and sqrt(2ε/|a|) proposes steps that would jump straight through the
+ * encounter. Rejection must catch this and the flyby must conserve energy.
+ */
+static char *test_rejects_fast_flyby() {
+    const double mass = 1.0e20, b = 50.0, speed = 1.0e5, d = 1.0e3;
+
+    PhysicsObject objects[2];
+    object_init(&objects[0], mass, -d, -b / 2.0, 0.0);
+    object_init(&objects[1], mass,  d,  b / 2.0, 0.0);
+    objects[0].velocity = (Vec3){ speed / 2.0, 0.0, 0.0};
+    objects[1].velocity = (Vec3){-speed / 2.0, 0.0, 0.0};
+
+    const double e0 = 0.25 * mass * speed * speed
+                    - G * mass * mass / vec3_magnitude(vec3_sub(objects[1].position, objects[0].position));
+
+    SimStats stats;
+    mu_assert("sim_run_until failed",
+              sim_run_until(objects, 2, 4.0 * d / speed, 1.0, NULL, &stats) == 0);
+
+    double v0 = vec3_magnitude(objects[0].velocity), v1 = vec3_magnitude(objects[1].velocity);
+    double e1 = 0.5 * mass * (v0 * v0 + v1 * v1)
+              - G * mass * mass / vec3_magnitude(vec3_sub(objects[1].position, objects[0].position));
+    printf("    %lld steps (%lld rejected), relative energy error %.3e\n",
+           stats.steps, stats.rejected_steps, fabs(e1 - e0) / fabs(e0));
+
+    mu_assert("no step was rejected", stats.rejected_steps > 0);
+    mu_assert("flyby did not conserve energy", fabs(e1 - e0) < 1e-3 * fabs(e0));
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"eccentric_orbit",        test_eccentric_orbit},
+    {"free_body_single_step",  test_free_body_single_step},
+    {"rejects_fast_flyby",     test_rejects_fast_flyby},
+};
+
+int main(void) {
+    int failed = run_suite("Adaptive Timestep", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file test_barnes_hut.c
+ * @brief Unit tests for the Barnes–Hut gravity solver.
+ *
+ * Tests cover: tree mass moments, exact agreement with direct summation at
+ * theta = 0, bounded error at a typical opening angle, coincident bodies that
+ * would otherwise split forever, and solver selection through sim_run_config().
+ *
+ * @author Steven Kight
+ */
+
+#include "forces/barnes_hut.h"
+#include "forces/gravity.h"
+#include "sim.h"
+#include "test_runner.h"
+#include <stdio.h>
+
+/* Deterministic pseudo-random cluster (LCG) so failures are reproducible. */
+static void make_cluster(PhysicsObject *objects, int count) {
+    unsigned int state = 12345u;
+    for (int i = 0; i < count; i++) {
+        double c[3];
+        for (int k = 0; k < 3; k++) {
+            state = state * 1664525u + 1013904223u;
+            c[k] = (double)(state >> 8) / (double)(1u << 24) * 200.0 - 100.0;
+        }
+        objects[i] = (PhysicsObject){
+            .mass     = 1.0e6 * (1.0 + (i % 7)),
+            .position = { c[0], c[1], c[2] },
+        };
+    }
+}
+
+/* RMS of |F_test − F_ref| / |F_ref| over all bodies. */
+static double rms_relative_error(const Vec3 *ref, const Vec3 *got, int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        Vec3 d = vec3_sub(got[i], ref[i]);
+        double r = vec3_magnitude(ref[i]);
+        if (r > 0.0) {
+            double e = vec3_magnitude(d) / r;
+            sum += e * e;
+        }
+    }
+    return sqrt(sum / count);
+}
+
+/**
+ * The root carries the total mass and the mass-weighted centre of all bodies.
+ */
+static char *test_tree_root_moments() {
+    PhysicsObject objects[3] = {
+        { .mass = 1.0, .position = {0.0, 0.0, 0.0} },
+        { .mass = 1.0, .position = {2.0, 0.0, 0.0} },
+        { .mass = 2.0, .position = {0.0, 4.0, 0.0} },
+    };
+    BHTree tree;
+    bh_tree_init(&tree);
+
+    mu_assert("build failed", bh_tree_build(&tree, objects, 3) == 0);
+    mu_assert_double_eq("root mass",  tree.nodes[0].mass,  4.0, 1e-12);
+    mu_assert_double_eq("root com.x", tree.nodes[0].com.x, 0.5, 1e-12);
+    mu_assert_double_eq("root com.y", tree.nodes[0].com.y, 2.0, 1e-12);
+    mu_assert_double_eq("root com.z", tree.nodes[0].com.z, 0.0, 1e-12);
+
+    bh_tree_free(&tree);
+    return NULL;
+}
+
+/**
+ * theta = 0 never accepts a multipole, so every pair is summed exactly.
+ */
+static char *test_theta_zero_matches_direct() {
+    enum { N = 64 };
+    PhysicsObject objects[N];
+    Vec3 direct[N], tree[N];
+    make_cluster(objects, N);
+
+    newtonian_gravity_direct(objects, N, direct);
+    barnes_hut_gravity(objects, N, 0.0, tree);
+
+    double err = rms_relative_error(direct, tree, N);
+    printf("    theta=0 rms relative error: %.3e\n", err);
+    mu_assert("theta=0 must reproduce direct summation", err < 1e-12);
+    return NULL;
+}
+
+/**
+ * theta = 0.5 is the usual production setting and should stay well below 1 %.
+ */
+static char *test_theta_half_error_bound() {
+    enum { N = 2000 };
+    static PhysicsObject objects[N];
+    static Vec3 direct[N], tree[N];
+    make_cluster(objects, N);
+
+    newtonian_gravity_direct(objects, N, direct);
+    barnes_hut_gravity(objects, N, 0.5, tree);
+
+    double err = rms_relative_error(direct, tree, N);
+    printf("    theta=0.5 rms relative error: %.3e\n", err);
+    mu_assert("theta=0.5 error above 1%", err < 1e-2);
+    return NULL;
+}
+
+/**
+ * Coincident bodies stop splitting at BH_MAX_DEPTH and share a leaf; a third,
+ * distinct body still feels their combined pull.
+ */
+static char *test_coincident_bodies() {
+    PhysicsObject objects[3] = {
+        { .mass = 1.0, .position = {1.0, 1.0, 1.0} },
+        { .mass = 1.0, .position = {1.0, 1.0, 1.0} },
+        { .mass = 1.0, .position = {4.0, 1.0, 1.0} },
+    };
+    Vec3 forces[3];
+
+    barnes_hut_gravity(objects, 3, 0.5, forces);
+
+    double expected = -2.0 * GRAVITATIONAL_CONSTANT / 9.0;
+    mu_assert_double_eq("far body Fx", forces[2].x, expected, 1e-22);
+    return NULL;
+}
+
+/**
+ * sim_run_config() drives the selected solver: with theta = 0 the Barnes–Hut
+ * trajectory is indistinguishable from the direct one.
+ */
+static char *test_sim_selects_solver() {
+    enum { N = 16 };
+    PhysicsObject a[N], b[N];
+    make_cluster(a, N);
+    make_cluster(b, N);
+
+    SimConfig direct, tree;
+    sim_config_default(&direct);
+    sim_config_default(&tree);
+    direct.gravity.solver = GRAVITY_SOLVER_DIRECT;
+    tree.gravity.solver   = GRAVITY_SOLVER_BARNES_HUT;
+    tree.gravity.theta    = 0.0;
+
+    sim_run_config(a, N, 10.0, 5, &direct);
+    sim_run_config(b, N, 10.0, 5, &tree);
+
+    for (int i = 0; i < N; i++) {
+        mu_assert_double_eq("position x diverged", a[i].position.x, b[i].position.x, 1e-9);
+        mu_assert_double_eq("position y diverged", a[i].position.y, b[i].position.y, 1e-9);
+        mu_assert_double_eq("position z diverged", a[i].position.z, b[i].position.z, 1e-9);
+    }
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"tree_root_moments",        test_tree_root_moments},
+    {"theta_zero_matches_direct",test_theta_zero_matches_direct},
+    {"theta_half_error_bound",   test_theta_half_error_bound},
+    {"coincident_bodies",        test_coincident_bodies},
+    {"sim_selects_solver",       test_sim_selects_solver},
+};
+
+int main(void) {
+    int failed = run_suite("Barnes-Hut Gravity", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_block_timestep.c
+ * @brief Unit tests for the hierarchical block timestep integrator.
+ *
+ * The scene is a tight binary orbited by a distant field of light bodies —
+ * the case block steps exist for. Tests cover: agreement with the analytic
+ * binary orbit and a fine shared-step run for the field, force work well
+ * below that of a shared step fine enough for the binary, and isolated
+ * bodies staying on one step per tick.
+ *
+ * @author Steven Kight
+ */
+
+#include "block_timestep.h"
+#include "sim.h"
+#include "test_runner.h"
+#include <math.h>
+#include <stdio.h>
+
+#define FIELD_COUNT 62
+#define SCENE_COUNT (FIELD_COUNT + 2)
+
+static const double G = GRAVITATIONAL_CONSTANT;
+
+static const double binary_mass = 1.0e20;  /* each member (kg) */
+static const double binary_sep  = 1.0e3;   /* separation (m); period ≈ 1.7 s */
+static const double field_mass  = 1.0e10;
+static const double field_r     = 1.0e6;
+
+static void build_scene(PhysicsObject *objects) {
+    const double v = sqrt(G * binary_mass / (2.0 * binary_sep));
+    object_init(&objects[0], binary_mass, -binary_sep / 2.0, 0.0, 0.0);
+    object_init(&objects[1], binary_mass,  binary_sep / 2.0, 0.0, 0.0);
+    objects[0].velocity = (Vec3){0.0, -v, 0.0};
+    objects[1].velocity = (Vec3){0.0,  v, 0.0};
+
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        const double phi = 2.0 * M_PI * i / FIELD_COUNT;
+        const double z   = field_r * 0.5 * sin(3.0 * phi);
+        object_init(&objects[i + 2], field_mass,
+                    field_r * cos(phi), field_r * sin(phi), z);
+    }
+}
+
+/**
+ * Four ticks (about 2.3 orbits) on block steps: the binary stays on its
+ * analytic circular orbit and the field bodies' infall matches a shared
+ * Velocity Verlet run 4096× finer.
+ */
+static char *test_matches_reference() {
+    const double time_step = 1.0;
+    const int    ticks     = 4;
+    const int    refine    = 4096;
+
+    PhysicsObject block[SCENE_COUNT], ref[SCENE_COUNT];
+    build_scene(block);
+    build_scene(ref);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = SIM_INTEGRATOR_BLOCK;
+    sim_run_config(block, SCENE_COUNT, time_step, ticks, &config);
+
+    sim_run_config(ref, SCENE_COUNT, time_step / refine, ticks * refine, NULL);
+
+    /* The field is 10 orders lighter, so the binary is Keplerian. */
+    const double omega = sqrt(G * 2.0 * binary_mass / pow(binary_sep, 3.0));
+    const double phase = omega * ticks * time_step;
+    const Vec3 orbit = { binary_sep / 2.0 * cos(phase), binary_sep / 2.0 * sin(phase), 0.0 };
+
+    double worst_binary = fmax(
+        vec3_magnitude(vec3_sub(block[1].position, orbit)),
+        vec3_magnitude(vec3_add(block[0].position, orbit)));
+
+    double worst_field = 0.0;
+    for (int i = 2; i < SCENE_COUNT; i++) {
+        double err = vec3_magnitude(vec3_sub(block[i].position, ref[i].position));
+        if (err > worst_field) worst_field = err;
+    }
+    printf("    position error: binary %.3e m, field %.3e m\n", worst_binary, worst_field);
+
+    mu_assert("binary left its orbit",        worst_binary < 1e-3 * binary_sep);
+    mu_assert("field drifted from reference", worst_field  < 1e-3);
+    return NULL;
+}
+
+/**
+ * The binary sets the smallest step; a shared-step run at that step would
+ * evaluate every body every substep. Block steps must do at least 10× less.
+ */
+static char *test_fewer_force_evaluations() {
+    const double time_step = 1.0;
+    const int    ticks     = 4;
+
+    PhysicsObject objects[SCENE_COUNT];
+    build_scene(objects);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = SIM_INTEGRATOR_BLOCK;
+
+    SimStats stats;
+    sim_run_stats(objects, SCENE_COUNT, time_step, ticks, &config, &stats);
+
+    const double shared = SCENE_COUNT * (ticks * time_step / stats.min_time_step);
+    printf("    %lld substeps, %lld force evaluations vs %.0f shared (min dt %.3e s)\n",
+           stats.steps, stats.force_evaluations, shared, stats.min_time_step);
+
+    mu_assert("binary was not refined", stats.min_time_step < time_step / 64.0);
+    mu_assert("block steps saved too little work",
+              (double)stats.force_evaluations * 10.0 < shared);
+    return NULL;
+}
+
+/**
+ * Widely separated bodies in uniform motion have no jerk and take exactly one
+ * step per tick, advancing in a straight line.
+ */
+static char *test_isolated_bodies_one_step() {
+    PhysicsObject objects[2];
+    object_init(&objects[0], 1.0, 0.0, 0.0, 0.0);
+    object_init(&objects[1], 1.0, 1.0e9, 0.0, 0.0);
+    objects[0].velocity = (Vec3){1.0, 2.0, 3.0};
+    objects[1].velocity = (Vec3){1.0, 2.0, 3.0};
+
+    BlockState state;
+    block_state_init(&state);
+    GravityConfig gravity;
+    gravity_config_default(&gravity);
+
+    SimStats stats = {0};
+    for (int tick = 0; tick < 5; tick++) {
+        mu_assert("block_tick failed",
+                  block_tick(&state, objects, 2, 2.0, 10, 0.02, 0, &gravity, &stats) == 0);
+    }
+    block_state_free(&state);
+
+    mu_assert("isolated bodies took extra substeps", stats.steps == 5);
+    mu_assert_double_eq("x", objects[0].position.x, 10.0, 1e-9);
+    mu_assert_double_eq("y", objects[0].position.y, 20.0, 1e-9);
+    mu_assert_double_eq("z", objects[0].position.z, 30.0, 1e-9);
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"matches_reference",         test_matches_reference},
+    {"fewer_force_evaluations",   test_fewer_force_evaluations},
+    {"isolated_bodies_one_step",  test_isolated_bodies_one_step},
+};
+
+int main(void) {
+    int failed = run_suite("Block Timesteps", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -11,6 +11,8 @@
 #include "collision/collision.h"
 #include "collision/sat.h"
 #include "test_runner.h"
+#include <math.h>
+#include <stdio.h>
 #include <string.h>
 
 /* ------------------------------------------------------------------ */
@@ -20,36 +22,36 @@
 /*
  * Unit cube centred at the origin in local space.
  * 8 vertices, 12 triangular faces (2 per axis-aligned square face), CCW winding.
+ * Registered once; every cube in the tests shares the same mesh id.
  */
+static int unit_cube_mesh(void) {
+    static int id = MESH_NONE;
+    if (id != MESH_NONE) return id;
+
+    static const Vec3 verts[8] = {
+        { -0.5, -0.5, -0.5 }, {  0.5, -0.5, -0.5 },
+        {  0.5,  0.5, -0.5 }, { -0.5,  0.5, -0.5 },
+        { -0.5, -0.5,  0.5 }, {  0.5, -0.5,  0.5 },
+        {  0.5,  0.5,  0.5 }, { -0.5,  0.5,  0.5 },
+    };
+    static const int faces[12][3] = {
+        /* -z face */ {0, 1, 2}, {0, 2, 3},
+        /* +z face */ {4, 6, 5}, {4, 7, 6},
+        /* -x face */ {0, 3, 7}, {0, 7, 4},
+        /* +x face */ {1, 5, 6}, {1, 6, 2},
+        /* -y face */ {0, 4, 5}, {0, 5, 1},
+        /* +y face */ {3, 2, 6}, {3, 6, 7},
+    };
+    id = mesh_register(verts, 8, faces, 12);
+    return id;
+}
+
 static void make_unit_cube(PhysicsObject *obj, double mass,
                              double x, double y, double z) {
     memset(obj, 0, sizeof(*obj));
     obj->mass     = mass;
     obj->position = (Vec3){ x, y, z };
-
-    obj->vertex_count = 8;
-    obj->local_verts[0] = (Vec3){ -0.5, -0.5, -0.5 };
-    obj->local_verts[1] = (Vec3){  0.5, -0.5, -0.5 };
-    obj->local_verts[2] = (Vec3){  0.5,  0.5, -0.5 };
-    obj->local_verts[3] = (Vec3){ -0.5,  0.5, -0.5 };
-    obj->local_verts[4] = (Vec3){ -0.5, -0.5,  0.5 };
-    obj->local_verts[5] = (Vec3){  0.5, -0.5,  0.5 };
-    obj->local_verts[6] = (Vec3){  0.5,  0.5,  0.5 };
-    obj->local_verts[7] = (Vec3){ -0.5,  0.5,  0.5 };
-
-    obj->face_count = 12;
-    /* -z face */  obj->face_indices[0][0]=0; obj->face_indices[0][1]=1; obj->face_indices[0][2]=2;
-                   obj->face_indices[1][0]=0; obj->face_indices[1][1]=2; obj->face_indices[1][2]=3;
-    /* +z face */  obj->face_indices[2][0]=4; obj->face_indices[2][1]=6; obj->face_indices[2][2]=5;
-                   obj->face_indices[3][0]=4; obj->face_indices[3][1]=7; obj->face_indices[3][2]=6;
-    /* -x face */  obj->face_indices[4][0]=0; obj->face_indices[4][1]=3; obj->face_indices[4][2]=7;
-                   obj->face_indices[5][0]=0; obj->face_indices[5][1]=7; obj->face_indices[5][2]=4;
-    /* +x face */  obj->face_indices[6][0]=1; obj->face_indices[6][1]=5; obj->face_indices[6][2]=6;
-                   obj->face_indices[7][0]=1; obj->face_indices[7][1]=6; obj->face_indices[7][2]=2;
-    /* -y face */  obj->face_indices[8][0]=0; obj->face_indices[8][1]=4; obj->face_indices[8][2]=5;
-                   obj->face_indices[9][0]=0; obj->face_indices[9][1]=5; obj->face_indices[9][2]=1;
-    /* +y face */  obj->face_indices[10][0]=3; obj->face_indices[10][1]=2; obj->face_indices[10][2]=6;
-                   obj->face_indices[11][0]=3; obj->face_indices[11][1]=6; obj->face_indices[11][2]=7;
+    obj->mesh_id  = unit_cube_mesh();
 }
 
 /* ------------------------------------------------------------------ */
@@ -83,6 +85,48 @@ static char *test_sat_touching_face() {
     return NULL;
 }
 
+/*
+ * Regular 40-gon prism of radius 1 and height 1: 80 vertices and 156 faces,
+ * more than a PhysicsObject could hold inline before meshes were pooled.
+ */
+static int prism_mesh(void) {
+    enum { SIDES = 40 };
+    static int id = MESH_NONE;
+    if (id != MESH_NONE) return id;
+
+    Vec3 verts[2 * SIDES];
+    int faces[2 * (SIDES - 2) + 2 * SIDES][3];
+    int f = 0;
+    for (int i = 0; i < SIDES; i++) {
+        double t = 2.0 * M_PI * i / SIDES;
+        verts[i]         = (Vec3){ cos(t), sin(t), -0.5 };
+        verts[i + SIDES] = (Vec3){ cos(t), sin(t),  0.5 };
+
+        int j = (i + 1) % SIDES;
+        faces[f][0] = i; faces[f][1] = j;         faces[f][2] = j + SIDES; f++;
+        faces[f][0] = i; faces[f][1] = j + SIDES; faces[f][2] = i + SIDES; f++;
+    }
+    for (int i = 1; i < SIDES - 1; i++) {
+        faces[f][0] = 0;     faces[f][1] = i + 1;         faces[f][2] = i;             f++;
+        faces[f][0] = SIDES; faces[f][1] = SIDES + i;     faces[f][2] = SIDES + i + 1; f++;
+    }
+    id = mesh_register(verts, 2 * SIDES, (const int (*)[3])faces, f);
+    return id;
+}
+
+static char *test_sat_large_mesh() {
+    PhysicsObject a, b, c;
+    memset(&a, 0, sizeof(a)); memset(&b, 0, sizeof(b)); memset(&c, 0, sizeof(c));
+    a.mesh_id = b.mesh_id = c.mesh_id = prism_mesh();
+    mu_assert("80-vertex mesh must register", a.mesh_id > 0);
+
+    b.position = (Vec3){ 1.9, 0.0, 0.0 };
+    c.position = (Vec3){ 2.1, 0.0, 0.0 };
+    mu_assert("overlapping prisms must intersect", sat_test_one(&a, &b));
+    mu_assert("separated prisms must not intersect", !sat_test_one(&a, &c));
+    return NULL;
+}
+
 /* ------------------------------------------------------------------ */
 /* collision_detect                                                       */
 /* ------------------------------------------------------------------ */
@@ -202,10 +246,150 @@ static char *test_detect_determinism() {
     return NULL;
 }
 
+static char *test_detect_growable_buffer() {
+    /*
+     * 6×6×6 lattice of unit cubes 0.9 m apart: each cube overlaps all 26
+     * neighbours, giving ((6 + 2·5)^3 − 216) / 2 = 1940 pairs — more than
+     * a thread's local SAT buffer holds. The pair buffer grows to the
+     * candidate count, not the 216·215/2 worst case, and drops nothing.
+     */
+    enum { SIDE = 6, N = SIDE * SIDE * SIDE };
+    static PhysicsObject objects[N];
+    for (int i = 0; i < N; i++)
+        make_unit_cube(&objects[i], 1.0, 0.9 * (i % SIDE),
+                       0.9 * (i / SIDE % SIDE), 0.9 * (i / (SIDE * SIDE)));
+
+    CollisionPairBuffer buffer;
+    collision_pairs_init(&buffer);
+    int n = collision_detect_ws(NULL, objects, N, &buffer);
+
+    mu_assert("all lattice pairs found", n == 1940);
+    mu_assert("count recorded", buffer.count == n);
+    for (int i = 0; i < n; i++) {
+        mu_assert("index_a < index_b", buffer.pairs[i].index_a < buffer.pairs[i].index_b);
+        for (int j = i + 1; j < n; j++)
+            mu_assert("no duplicate pairs",
+                      buffer.pairs[j].index_a != buffer.pairs[i].index_a ||
+                      buffer.pairs[j].index_b != buffer.pairs[i].index_b);
+    }
+    mu_assert("capacity covers pairs", buffer.capacity >= n);
+    mu_assert("capacity below N^2 worst case", buffer.capacity < N * (N - 1) / 2);
+
+    /* Reuse: a second, emptier call keeps the storage and resets the count. */
+    int capacity = buffer.capacity;
+    mu_assert("single body has no pairs", collision_detect_ws(NULL, objects, 1, &buffer) == 0);
+    mu_assert("count reset", buffer.count == 0);
+    mu_assert("capacity kept", buffer.capacity == capacity);
+
+    collision_pairs_free(&buffer);
+    mu_assert("freed", buffer.pairs == NULL && buffer.capacity == 0);
+    return NULL;
+}
+
+static char *test_detect_dense_lattice() {
+    /*
+     * 10×10×10 lattice, as above: ((10 + 2·9)^3 − 1000) / 2 = 10476 pairs,
+     * beyond the 8192 candidates a fixed buffer once held. The workspace grows
+     * to fit, and its high-water marks can pre-size a fresh workspace so the
+     * same scene runs without growing again.
+     */
+    enum { SIDE = 10, N = SIDE * SIDE * SIDE };
+    static PhysicsObject objects[N];
+    for (int i = 0; i < N; i++)
+        make_unit_cube(&objects[i], 1.0, 0.9 * (i % SIDE),
+                       0.9 * (i / SIDE % SIDE), 0.9 * (i / (SIDE * SIDE)));
+
+    CollisionWorkspace ws;
+    CollisionPairBuffer buffer;
+    collision_workspace_init(&ws);
+    collision_pairs_init(&buffer);
+
+    mu_assert("all lattice pairs found",
+              collision_detect_ws(&ws, objects, N, &buffer) == 10476);
+
+    CollisionUsage usage;
+    collision_workspace_usage(&ws, &usage);
+    printf("    nodes %d/%d, candidates %d/%d (high water/capacity)\n",
+           usage.node_high_water, usage.node_capacity,
+           usage.candidate_high_water, usage.candidate_capacity);
+    mu_assert("candidates beyond old limit", usage.candidate_high_water > 8192);
+    mu_assert("candidate capacity", usage.candidate_capacity >= usage.candidate_high_water);
+    mu_assert("node capacity", usage.node_capacity >= usage.node_high_water);
+    mu_assert("bodies", usage.body_capacity == N);
+
+    CollisionWorkspace sized;
+    collision_workspace_init(&sized);
+    mu_assert("reserve failed",
+              collision_workspace_reserve(&sized, usage.node_high_water,
+                                          usage.candidate_high_water) == 0);
+    mu_assert("same pairs from pre-sized workspace",
+              collision_detect_ws(&sized, objects, N, &buffer) == 10476);
+    CollisionUsage sized_usage;
+    collision_workspace_usage(&sized, &sized_usage);
+    mu_assert("pre-sized nodes grew", sized_usage.node_capacity == usage.node_high_water);
+    mu_assert("pre-sized candidates grew",
+              sized_usage.candidate_capacity == usage.candidate_high_water);
+
+    collision_workspace_free(&sized);
+    collision_workspace_free(&ws);
+    collision_pairs_free(&buffer);
+    return NULL;
+}
+
+static char *test_detect_deep_cluster() {
+    /*
+     * Twenty mutually overlapping cubes 1 cm apart, with two far cubes
+     * stretching the world to ~1 km. The cluster lands in one leaf at
+     * OCTREE_MAX_DEPTH (~4 m wide) holding more than OCTREE_LEAF_CAPACITY
+     * bodies; overflow blocks keep all of them, so all 190 pairs are found.
+     */
+    enum { CLUSTER = 20, N = CLUSTER + 2 };
+    PhysicsObject objects[N];
+    for (int i = 0; i < CLUSTER; i++)
+        make_unit_cube(&objects[i], 1.0, 0.01 * i, 0.0, 0.0);
+    make_unit_cube(&objects[CLUSTER],     1.0, -500.0, -500.0, -500.0);
+    make_unit_cube(&objects[CLUSTER + 1], 1.0,  500.0,  500.0,  500.0);
+
+    CollisionPairBuffer buffer;
+    collision_pairs_init(&buffer);
+    int n = collision_detect_ws(NULL, objects, N, &buffer);
+    mu_assert("cluster pairs lost at max depth", n == CLUSTER * (CLUSTER - 1) / 2);
+    collision_pairs_free(&buffer);
+    return NULL;
+}
+
+static char *test_detect_coincident_cluster() {
+    /*
+     * Thirty cubes at one point each span every octant of the root, so
+     * splitting cannot separate them. The root keeps them in overflow blocks
+     * rather than subdividing to OCTREE_MAX_DEPTH (8^8 leaves).
+     */
+    enum { N = 30 };
+    PhysicsObject objects[N];
+    for (int i = 0; i < N; i++)
+        make_unit_cube(&objects[i], 1.0, 0.0, 0.0, 0.0);
+
+    CollisionWorkspace ws;
+    CollisionPairBuffer buffer;
+    collision_workspace_init(&ws);
+    collision_pairs_init(&buffer);
+
+    mu_assert("coincident pairs",
+              collision_detect_ws(&ws, objects, N, &buffer) == N * (N - 1) / 2);
+    CollisionUsage usage;
+    collision_workspace_usage(&ws, &usage);
+    mu_assert("cluster subdivided", usage.node_high_water <= N);
+
+    collision_workspace_free(&ws);
+    collision_pairs_free(&buffer);
+    return NULL;
+}
+
 static const TestCase tests[] = {
     {"sat_separated",           test_sat_separated},
     {"sat_overlapping",         test_sat_overlapping},
     {"sat_touching_face",       test_sat_touching_face},
+    {"sat_large_mesh",          test_sat_large_mesh},
     {"detect_empty",            test_detect_empty},
     {"detect_single",           test_detect_single},
     {"detect_two_separated",    test_detect_two_separated},
@@ -214,6 +398,10 @@ static const TestCase tests[] = {
     {"detect_three_all_overlap",test_detect_three_all_overlap},
     {"detect_no_duplicates",    test_detect_no_duplicates},
     {"detect_determinism",      test_detect_determinism},
+    {"detect_growable_buffer",  test_detect_growable_buffer},
+    {"detect_dense_lattice",    test_detect_dense_lattice},
+    {"detect_deep_cluster",     test_detect_deep_cluster},
+    {"detect_coincident_cluster", test_detect_coincident_cluster},
 };
 
 int main(void) {
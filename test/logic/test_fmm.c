@@ -0,0 +1,105 @@
+/**
+ * @file test_fmm.c
+ * @brief Unit tests for the fast multipole method gravity solver.
+ *
+ * Tests cover: small scenes falling back to exact summation, error decreasing
+ * as the expansion order rises, a bounded error at the default order, and
+ * selection through gravity_compute().
+ *
+ * @author Steven Kight
+ */
+
+#include "forces/fmm.h"
+#include "forces/gravity.h"
+#include "test_runner.h"
+#include <stdio.h>
+
+/* Deterministic pseudo-random cluster (LCG) so failures are reproducible. */
+static void make_cluster(PhysicsObject *objects, int count) {
+    unsigned int state = 424242u;
+    for (int i = 0; i < count; i++) {
+        double c[3];
+        for (int k = 0; k < 3; k++) {
+            state = state * 1664525u + 1013904223u;
+            c[k] = (double)(state >> 8) / (double)(1u << 24) * 200.0 - 100.0;
+        }
+        objects[i] = (PhysicsObject){
+            .mass     = 1.0e6 * (1.0 + (i % 5)),
+            .position = { c[0], c[1], c[2] },
+        };
+    }
+}
+
+/**
+ * Below two tree levels every leaf is adjacent to every other, so the solver
+ * must reproduce direct summation to rounding.
+ */
+static char *test_small_scene_exact() {
+    enum { N = 100 };
+    PhysicsObject objects[N];
+    make_cluster(objects, N);
+
+    double err = fmm_gravity_error(objects, N, 4);
+    printf("    N=%d rms relative error: %.3e\n", N, err);
+    mu_assert("small scene must match direct summation", err >= 0.0 && err < 1e-12);
+    return NULL;
+}
+
+/**
+ * Raising the order must shrink the far-field error; the reported estimate
+ * is what a scene author would use to pick an order.
+ */
+static char *test_error_decreases_with_order() {
+    enum { N = 4000 };
+    static PhysicsObject objects[N];
+    make_cluster(objects, N);
+
+    double prev = 1.0;
+    for (int p = 1; p <= 6; p++) {
+        double err = fmm_gravity_error(objects, N, p);
+        printf("    order %d rms relative error: %.3e\n", p, err);
+        mu_assert("error estimate failed", err >= 0.0);
+        mu_assert("error did not decrease with order", err < prev);
+        prev = err;
+    }
+    mu_assert("order 6 error above 0.2%", prev < 2e-3);
+    return NULL;
+}
+
+/**
+ * gravity_compute() routes GRAVITY_SOLVER_FMM with the configured order, and
+ * the result is deterministic regardless of OpenMP scheduling.
+ */
+static char *test_gravity_compute_selects_fmm() {
+    enum { N = 4000 };
+    static PhysicsObject objects[N];
+    static Vec3 expected[N], got[N];
+    make_cluster(objects, N);
+
+    GravityConfig config;
+    gravity_config_default(&config);
+    config.solver    = GRAVITY_SOLVER_FMM;
+    config.fmm_order = 5;
+
+    fmm_gravity(objects, N, 5, expected);
+    gravity_compute(&config, objects, N, got);
+
+    for (int i = 0; i < N; i++) {
+        mu_assert("Fx differs", got[i].x == expected[i].x);
+        mu_assert("Fy differs", got[i].y == expected[i].y);
+        mu_assert("Fz differs", got[i].z == expected[i].z);
+    }
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"small_scene_exact",            test_small_scene_exact},
+    {"error_decreases_with_order",   test_error_decreases_with_order},
+    {"gravity_compute_selects_fmm",  test_gravity_compute_selects_fmm},
+};
+
+int main(void) {
+    int failed = run_suite("Fast Multipole Method", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
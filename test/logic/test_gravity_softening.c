@@ -0,0 +1,300 @@
+/**
+ * @file test_gravity_softening.c
+ * @brief Unit tests for Plummer and spline gravitational softening.
+ *
+ * Tests cover: the kernels' closed forms, per-object lengths overriding the
+ * global one, every solver honouring softening (the SIMD levels included,
+ * and FMM, mixed precision and PM within their own algorithms), and the
+ * point of the feature — a head-on encounter at a coarse time step stays
+ * bounded instead of being flung apart.
+ *
+ * @author Steven Kight
+ */
+
+#include "forces/barnes_hut.h"
+#include "forces/fmm.h"
+#include "forces/gravity.h"
+#include "forces/gravity_simd.h"
+#include "forces/particle_mesh.h"
+#include "forces/softening.h"
+#include "sim.h"
+#include "test_runner.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const double G = GRAVITATIONAL_CONSTANT;
+
+/**
+ * Plummer at r = ε gives exactly r / (2ε²)^{3/2}; the spline is continuous at
+ * u = 0.5 and u = 1 and Newtonian beyond its support; each potential's
+ * slope is its pair factor.
+ */
+static char *test_kernel_values() {
+    const double eps = 2.0;
+
+    double plummer = softening_inv_r3(eps * eps, eps, GRAVITY_SOFTENING_PLUMMER);
+    mu_assert_double_eq("plummer at r = eps", plummer, 1.0 / pow(2.0 * eps * eps, 1.5), 1e-15);
+
+    const double h = SOFTENING_SPLINE_SUPPORT * eps;
+    double knots[2] = { 0.5 * h, h };
+    for (int k = 0; k < 2; k++) {
+        double r = knots[k];
+        double below = softening_inv_r3((r * (1.0 - 1e-9)) * (r * (1.0 - 1e-9)), eps, GRAVITY_SOFTENING_SPLINE);
+        double above = softening_inv_r3((r * (1.0 + 1e-9)) * (r * (1.0 + 1e-9)), eps, GRAVITY_SOFTENING_SPLINE);
+        mu_assert_double_eq("spline discontinuous", below, above, 1e-6 * above);
+    }
+
+    double r = 1.5 * h;
+    mu_assert_double_eq("spline not Newtonian beyond h",
+                        softening_inv_r3(r * r, eps, GRAVITY_SOFTENING_SPLINE),
+                        1.0 / (r * r * r), 1e-18);
+
+    /* Bounded core: the spline's central value is finite, 32/3 h⁻³. */
+    mu_assert_double_eq("spline core value",
+                        softening_inv_r3(0.0, eps, GRAVITY_SOFTENING_SPLINE),
+                        32.0 / 3.0 / (h * h * h), 1e-15);
+
+    /* The potential's slope is the pair factor: (dφ/dr) / r = g(r). */
+    const GravitySoftening kinds[2] = { GRAVITY_SOFTENING_PLUMMER, GRAVITY_SOFTENING_SPLINE };
+    const double radii[4] = { 0.3 * h, 0.7 * h, 1.2 * h, 2.0 * h };
+    for (int s = 0; s < 2; s++) {
+        for (int k = 0; k < 4; k++) {
+            double r = radii[k], dr = 1e-6 * r;
+            double slope = (softening_potential((r + dr) * (r + dr), eps, kinds[s]) -
+                            softening_potential((r - dr) * (r - dr), eps, kinds[s])) / (2.0 * dr);
+            double g = softening_inv_r3(r * r, eps, kinds[s]);
+            mu_assert_double_eq("potential slope is not the pair factor", slope / r, g, 1e-6 * g);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * A body's own length overrides the global one, and a pair uses the larger.
+ */
+static char *test_per_object_length() {
+    PhysicsObject objects[2] = {
+        { .mass = 1.0, .position = {0.0, 0.0, 0.0} },
+        { .mass = 1.0, .position = {1.0, 0.0, 0.0}, .softening = 3.0 },
+    };
+    Vec3 forces[2];
+
+    newtonian_gravity_softened(objects, 2, GRAVITY_SOFTENING_PLUMMER, 0.5, forces);
+
+    double expected = G * 1.0 / pow(1.0 + 9.0, 1.5);
+    mu_assert_double_eq("body 0 Fx", forces[0].x,  expected, 1e-12 * expected);
+    mu_assert_double_eq("body 1 Fx", forces[1].x, -expected, 1e-12 * expected);
+    return NULL;
+}
+
+/* 64 bodies close enough that many pairs fall inside the spline support. */
+static void make_softened_cloud(PhysicsObject *objects, int count) {
+    for (int i = 0; i < count; i++) {
+        objects[i] = (PhysicsObject){
+            .mass      = 1.0e6 + 1.0e4 * i,
+            .position  = { (i * 7) % 11 - 5.0, (i * 5) % 13 * 0.5, (i * 3) % 17 * 0.25 },
+            .softening = (i % 4 == 0) ? 0.8 : 0.0,
+        };
+    }
+}
+
+/**
+ * Every exact solver (Barnes–Hut at theta = 0, FMM below its tree size)
+ * agrees with the softened direct sum to rounding under both kernels.
+ */
+static char *test_solvers_agree() {
+    enum { N = 64 };
+    PhysicsObject objects[N];
+    Vec3 direct[N], other[N];
+    make_softened_cloud(objects, N);
+
+    const GravitySolver solvers[] = {
+        GRAVITY_SOLVER_MATRIX, GRAVITY_SOLVER_SYMMETRIC, GRAVITY_SOLVER_BARNES_HUT,
+        GRAVITY_SOLVER_SIMD, GRAVITY_SOLVER_TILED, GRAVITY_SOLVER_FMM,
+    };
+    const GravitySoftening kinds[2] = { GRAVITY_SOFTENING_PLUMMER, GRAVITY_SOFTENING_SPLINE };
+
+    for (int s = 0; s < 2; s++) {
+        GravityConfig config;
+        gravity_config_default(&config);
+        config.softening        = kinds[s];
+        config.softening_length = 0.3;
+        gravity_compute(&config, objects, N, direct);
+
+        config.theta = 0.0;
+        for (size_t k = 0; k < sizeof(solvers) / sizeof(solvers[0]); k++) {
+            config.solver = solvers[k];
+            gravity_compute(&config, objects, N, other);
+            for (int i = 0; i < N; i++) {
+                double scale = vec3_magnitude(direct[i]);
+                mu_assert_double_eq("Fx differs", other[i].x, direct[i].x, 1e-10 * scale);
+                mu_assert_double_eq("Fy differs", other[i].y, direct[i].y, 1e-10 * scale);
+                mu_assert_double_eq("Fz differs", other[i].z, direct[i].z, 1e-10 * scale);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* RMS over bodies of |F − F_ref| / |F_ref|. */
+static double rms_error(const Vec3 *forces, const Vec3 *ref, int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        double e = vec3_magnitude(vec3_sub(forces[i], ref[i])) / vec3_magnitude(ref[i]);
+        sum += e * e;
+    }
+    return sqrt(sum / count);
+}
+
+/* Bodies scattered through a 100 m cube, every tenth with a partner 0.2 m away. */
+static void make_close_pairs(PhysicsObject *objects, int count) {
+    srand(5);
+    for (int i = 0; i < count; i++) {
+        if (i % 10 == 1) {
+            objects[i] = objects[i - 1];
+            objects[i].position.x += 0.2;
+            continue;
+        }
+        objects[i] = (PhysicsObject){
+            .mass      = 1.0e6 * (1 + rand() % 5),
+            .position  = { rand() % 10000 * 0.01, rand() % 10000 * 0.01,
+                           rand() % 10000 * 0.01 },
+            .softening = (i % 7 == 0) ? 0.8 : 0.0,
+        };
+    }
+}
+
+/**
+ * FMM, mixed precision and PM soften inside their own algorithms: on a
+ * scene of close pairs each tracks the softened direct sum to its usual
+ * accuracy, while its unsoftened run is far off. PM gets a length of a few
+ * cells, since the mesh cannot resolve anything shorter, and no per-body
+ * lengths, since it applies one length to every pair.
+ */
+static char *test_fast_solvers_soften() {
+    enum { N = 2000 };
+    static PhysicsObject objects[N];
+    static Vec3 ref[N], soft[N], plain[N];
+
+    const GravitySoftening kinds[2] = { GRAVITY_SOFTENING_PLUMMER, GRAVITY_SOFTENING_SPLINE };
+    for (int s = 0; s < 2; s++) {
+        make_close_pairs(objects, N);
+
+        GravityConfig config;
+        gravity_config_default(&config);
+        config.softening        = kinds[s];
+        config.softening_length = 0.5;
+        gravity_compute(&config, objects, N, ref);
+
+        config.fmm_order = 8;
+        config.solver    = GRAVITY_SOLVER_FMM;
+        gravity_compute(&config, objects, N, soft);
+        fmm_gravity(objects, N, config.fmm_order, plain);
+        double fmm = rms_error(soft, ref, N), fmm_plain = rms_error(plain, ref, N);
+
+        config.solver = GRAVITY_SOLVER_MIXED;
+        gravity_compute(&config, objects, N, soft);
+        newtonian_gravity_mixed(objects, N, plain);
+        double mixed = rms_error(soft, ref, N), mixed_plain = rms_error(plain, ref, N);
+
+        for (int i = 0; i < N; i++)
+            objects[i].softening = 0.0;
+        config.solver = GRAVITY_SOLVER_DIRECT;
+        config.softening_length = 8.0;
+        gravity_compute(&config, objects, N, ref);
+        config.solver = GRAVITY_SOLVER_PM;
+        gravity_compute(&config, objects, N, soft);
+        particle_mesh_gravity(objects, N, config.pm_grid, config.pm_assignment, plain);
+        double pm = rms_error(soft, ref, N), pm_plain = rms_error(plain, ref, N);
+
+        printf("    kernel %d RMS error softened / unsoftened: FMM %.1e / %.1e, "
+               "mixed %.1e / %.1e, PM %.1e / %.1e\n",
+               (int)kinds[s], fmm, fmm_plain, mixed, mixed_plain, pm, pm_plain);
+        mu_assert("FMM far from the softened sum", fmm < 1e-3);
+        mu_assert("mixed far from the softened sum", mixed < 1e-6);
+        mu_assert("PM far from the softened sum", pm < 2e-2);
+        mu_assert("scene does not need softening",
+                  fmm_plain > 1.0 && mixed_plain > 1.0 && pm_plain > 0.1);
+    }
+    return NULL;
+}
+
+/**
+ * Each SIMD level (clamped to what the CPU supports) matches the softened
+ * direct sum, covering the vector Plummer path and the scalar spline patch.
+ */
+static char *test_simd_levels() {
+    enum { N = 61 }; /* not a multiple of the vector width */
+    PhysicsObject objects[N];
+    Vec3 direct[N], simd[N];
+    make_softened_cloud(objects, N);
+
+    const GravitySimdLevel levels[3] = { GRAVITY_SIMD_SCALAR, GRAVITY_SIMD_AVX2, GRAVITY_SIMD_AVX512 };
+    const GravitySoftening kinds[2]  = { GRAVITY_SOFTENING_PLUMMER, GRAVITY_SOFTENING_SPLINE };
+
+    for (int s = 0; s < 2; s++) {
+        newtonian_gravity_softened(objects, N, kinds[s], 0.3, direct);
+        for (int k = 0; k < 3; k++) {
+            newtonian_gravity_simd_softened(levels[k], objects, N, kinds[s], 0.3, simd);
+            for (int i = 0; i < N; i++) {
+                double scale = vec3_magnitude(direct[i]);
+                mu_assert_double_eq("Fx differs", simd[i].x, direct[i].x, 1e-10 * scale);
+                mu_assert_double_eq("Fy differs", simd[i].y, direct[i].y, 1e-10 * scale);
+                mu_assert_double_eq("Fz differs", simd[i].z, direct[i].z, 1e-10 * scale);
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Two bodies dropped head-on at a step 10× too coarse to resolve periapsis:
+ * unsoftened, the step that lands them nearly on top of each other flings
+ * them apart at far beyond escape speed; Plummer softening caps the speed
+ * near √(2 G M / ε), the depth of the softened potential well.
+ */
+static char *test_coarse_step_stays_bounded() {
+    const double mass = 1.0e10, eps = 4.0, dt = 2.0;
+    const double v_cap = sqrt(2.0 * G * 2.0 * mass / eps);
+
+    double peak[2] = {0.0, 0.0};
+    for (int run = 0; run < 2; run++) {
+        PhysicsObject objects[2];
+        object_init(&objects[0], mass, -10.0, 0.0, 0.0);
+        object_init(&objects[1], mass,  10.0, 0.0, 0.0);
+
+        SimConfig config;
+        sim_config_default(&config);
+        if (run == 1) {
+            config.gravity.softening        = GRAVITY_SOFTENING_PLUMMER;
+            config.gravity.softening_length = eps;
+        }
+
+        for (int step = 0; step < 400; step++) {
+            sim_run_config(objects, 2, dt, 1, &config);
+            double v = vec3_magnitude(vec3_sub(objects[1].velocity, objects[0].velocity));
+            if (v > peak[run]) peak[run] = v;
+        }
+    }
+    printf("    peak relative speed: unsoftened %.3e, plummer %.3e (cap %.3e)\n",
+           peak[0], peak[1], v_cap);
+
+    mu_assert("softened encounter exceeded the well depth", peak[1] < 1.05 * v_cap);
+    mu_assert("unsoftened encounter unexpectedly tame", peak[0] > 10.0 * v_cap);
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"kernel_values",              test_kernel_values},
+    {"per_object_length",          test_per_object_length},
+    {"solvers_agree",              test_solvers_agree},
+    {"fast_solvers_soften",        test_fast_solvers_soften},
+    {"simd_levels",                test_simd_levels},
+    {"coarse_step_stays_bounded",  test_coarse_step_stays_bounded},
+};
+
+int main(void) {
+    int failed = run_suite("Gravitational Softening", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
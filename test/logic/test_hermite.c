@@ -0,0 +1,129 @@
+/**
+ * @file test_hermite.c
+ * @brief Unit tests for the fourth-order Hermite integrator.
+ *
+ * Tests cover: fourth-order convergence on a circular binary, accuracy at a
+ * step several times larger than Velocity Verlet needs, and the block
+ * integrator reducing to shared-step Hermite when every body is on level 0.
+ *
+ * @author Steven Kight
+ */
+
+#include "block_timestep.h"
+#include "hermite.h"
+#include "sim.h"
+#include "test_runner.h"
+#include <math.h>
+#include <stdio.h>
+
+static const double G = GRAVITATIONAL_CONSTANT;
+
+static const double binary_mass = 1.0e20;  /* each member (kg) */
+static const double binary_sep  = 1.0e3;   /* separation (m) */
+
+static double binary_omega(void) {
+    return sqrt(G * 2.0 * binary_mass / pow(binary_sep, 3.0));
+}
+
+static void build_binary(PhysicsObject *objects) {
+    const double v = sqrt(G * binary_mass / (2.0 * binary_sep));
+    object_init(&objects[0], binary_mass, -binary_sep / 2.0, 0.0, 0.0);
+    object_init(&objects[1], binary_mass,  binary_sep / 2.0, 0.0, 0.0);
+    objects[0].velocity = (Vec3){0.0, -v, 0.0};
+    objects[1].velocity = (Vec3){0.0,  v, 0.0};
+}
+
+/* Distance of body 1 from its analytic circular-orbit position at time t. */
+static double orbit_error(const PhysicsObject *objects, double t) {
+    const double phase = binary_omega() * t;
+    const Vec3 exact = { binary_sep / 2.0 * cos(phase), binary_sep / 2.0 * sin(phase), 0.0 };
+    return vec3_magnitude(vec3_sub(objects[1].position, exact));
+}
+
+/* Error after one orbit in @p steps steps with the given integrator. */
+static double one_orbit_error(SimIntegrator integrator, int steps) {
+    const double period = 2.0 * M_PI / binary_omega();
+
+    PhysicsObject objects[2];
+    build_binary(objects);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = integrator;
+    sim_run_config(objects, 2, period / steps, steps, &config);
+
+    return orbit_error(objects, period);
+}
+
+/**
+ * Halving the step cuts the error by ~2⁴ = 16.
+ */
+static char *test_fourth_order_convergence() {
+    double coarse = one_orbit_error(SIM_INTEGRATOR_HERMITE, 64);
+    double fine   = one_orbit_error(SIM_INTEGRATOR_HERMITE, 128);
+    printf("    one-orbit error: %.3e m (P/64), %.3e m (P/128), ratio %.1f\n",
+           coarse, fine, coarse / fine);
+
+    mu_assert("Hermite did not converge at fourth order", coarse / fine > 12.0);
+    return NULL;
+}
+
+/**
+ * Hermite at P/64 beats Velocity Verlet at P/512 — an 8× larger step.
+ */
+static char *test_larger_steps_same_accuracy() {
+    double hermite = one_orbit_error(SIM_INTEGRATOR_HERMITE, 64);
+    double verlet  = one_orbit_error(SIM_INTEGRATOR_VERLET, 512);
+    printf("    one-orbit error: hermite %.3e m (P/64), verlet %.3e m (P/512)\n",
+           hermite, verlet);
+
+    mu_assert("Hermite at 8x the step was less accurate than Verlet", hermite < verlet);
+    mu_assert("Hermite error above 1e-3 of the separation", hermite < 1e-3 * binary_sep);
+    return NULL;
+}
+
+/**
+ * With max_level = 0 every body takes the whole tick, so block steps and the
+ * shared-step integrator perform identical arithmetic.
+ */
+static char *test_block_level0_matches_hermite() {
+    PhysicsObject shared[2], block[2];
+    build_binary(shared);
+    build_binary(block);
+
+    GravityConfig gravity;
+    gravity_config_default(&gravity);
+
+    HermiteState hs;
+    BlockState bs;
+    hermite_state_init(&hs);
+    block_state_init(&bs);
+    for (int step = 0; step < 50; step++) {
+        mu_assert("hermite_step failed", hermite_step(&hs, shared, 2, 0.02, 0, &gravity, NULL) == 0);
+        mu_assert("block_tick failed",   block_tick(&bs, block, 2, 0.02, 0, 0.02, 0, &gravity, NULL) == 0);
+    }
+    hermite_state_free(&hs);
+    block_state_free(&bs);
+
+    for (int i = 0; i < 2; i++) {
+        mu_assert("position differs", shared[i].position.x == block[i].position.x &&
+                                      shared[i].position.y == block[i].position.y &&
+                                      shared[i].position.z == block[i].position.z);
+        mu_assert("velocity differs", shared[i].velocity.x == block[i].velocity.x &&
+                                      shared[i].velocity.y == block[i].velocity.y &&
+                                      shared[i].velocity.z == block[i].velocity.z);
+    }
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"fourth_order_convergence",     test_fourth_order_convergence},
+    {"larger_steps_same_accuracy",   test_larger_steps_same_accuracy},
+    {"block_level0_matches_hermite", test_block_level0_matches_hermite},
+};
+
+int main(void) {
+    int failed = run_suite("Hermite Integrator", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
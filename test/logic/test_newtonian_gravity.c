@@ -4,7 +4,11 @@
  *
  * Tests cover: single-body (zero force), two-body axis-aligned force magnitude,
  * Newton's third law (action-reaction symmetry), three-body collinear superposition,
- * and diagonal force direction via a 3-4-5 right triangle.
+ * and diagonal force direction via a 3-4-5 right triangle. The fused direct
+ * solver is cross-checked against the matrix pipeline on a scattered cluster,
+ * and mixed precision against its error bound, including close binaries in
+ * a cloud 1e5 times wider than they are. A private GravityWorkspace must
+ * reproduce the shared one for every solver.
  *
  * All tests run through the public newtonian_gravity() entry point, which
  * automatically selects the Fortran (CPU) backend for small N (since these
@@ -172,12 +176,341 @@ static char *test_two_body_diagonal() {
     return NULL;
 }
 
+/**
+ * Fills @p objects with a deterministic, irregular cluster of bodies with
+ * distinct masses so every pair has a different separation and direction.
+ */
+static void make_cluster(PhysicsObject *objects, int count) {
+    for (int i = 0; i < count; i++) {
+        objects[i] = (PhysicsObject){
+            .mass     = 1.0e3 + 37.0 * i,
+            .position = { (double)((i * 7) % 11) - 5.0,
+                          (double)((i * 5) % 13) * 0.5 - 3.0,
+                          (double)((i * 3) % 17) * 0.25 - 2.0 },
+        };
+    }
+}
+
+/**
+ * Largest component-wise difference between two force arrays, relative to the
+ * largest force magnitude component in @p ref.
+ */
+static double max_relative_diff(const Vec3 *ref, const Vec3 *got, int count) {
+    double scale = 0.0, diff = 0.0;
+    for (int i = 0; i < count; i++) {
+        double r[3] = { ref[i].x, ref[i].y, ref[i].z };
+        double o[3] = { got[i].x, got[i].y, got[i].z };
+        for (int k = 0; k < 3; k++) {
+            if (fabs(r[k]) > scale) scale = fabs(r[k]);
+            if (fabs(r[k] - o[k]) > diff) diff = fabs(r[k] - o[k]);
+        }
+    }
+    return scale > 0.0 ? diff / scale : diff;
+}
+
+/**
+ * The direct solver reproduces the hand-computed 3-4-5 result exactly as the
+ * matrix pipeline does.
+ */
+static char *test_direct_two_body_diagonal() {
+    PhysicsObject objects[2] = {
+        { .mass = 1.0, .position = {0.0, 0.0, 0.0} },
+        { .mass = 1.0, .position = {3.0, 4.0, 0.0} },
+    };
+    Vec3 forces[2];
+
+    GravityConfig config = { .solver = GRAVITY_SOLVER_DIRECT };
+    gravity_compute(&config, objects, 2, forces);
+
+    double F = G / 25.0;
+    mu_assert_double_eq("body 0: Fx wrong", forces[0].x,  F * 0.6, 1e-22);
+    mu_assert_double_eq("body 0: Fy wrong", forces[0].y,  F * 0.8, 1e-22);
+    mu_assert_double_eq("body 0: Fz != 0",  forces[0].z,  0.0,     1e-30);
+    mu_assert_double_eq("body 1: Fx wrong", forces[1].x, -F * 0.6, 1e-22);
+    mu_assert_double_eq("body 1: Fy wrong", forces[1].y, -F * 0.8, 1e-22);
+    return NULL;
+}
+
+/**
+ * On a 40-body cluster the fused direct kernel and the staged matrix pipeline
+ * differ only by floating-point reassociation (a few ULPs per pair).
+ */
+static char *test_direct_matches_matrix() {
+    enum { N = 40 };
+    PhysicsObject objects[N];
+    Vec3 matrix_forces[N], direct_forces[N];
+    make_cluster(objects, N);
+
+    GravityConfig matrix = { .solver = GRAVITY_SOLVER_MATRIX };
+    GravityConfig direct = { .solver = GRAVITY_SOLVER_DIRECT };
+    gravity_compute(&matrix, objects, N, matrix_forces);
+    gravity_compute(&direct, objects, N, direct_forces);
+
+    double err = max_relative_diff(matrix_forces, direct_forces, N);
+    printf("    max relative diff (direct vs matrix): %.3e\n", err);
+    mu_assert("direct solver diverges from matrix pipeline", err < 1e-12);
+    return NULL;
+}
+
+/**
+ * The i<j symmetric kernel matches the row kernel to rounding, and forces sum
+ * to zero because every pair contributes exactly ±F.
+ */
+static char *test_symmetric_matches_direct() {
+    enum { N = 41 }; /* odd: the middle row is processed unpaired */
+    PhysicsObject objects[N];
+    Vec3 direct_forces[N], sym_forces[N];
+    make_cluster(objects, N);
+
+    GravityConfig direct = { .solver = GRAVITY_SOLVER_DIRECT };
+    GravityConfig sym    = { .solver = GRAVITY_SOLVER_SYMMETRIC };
+    gravity_compute(&direct, objects, N, direct_forces);
+    gravity_compute(&sym, objects, N, sym_forces);
+
+    double err = max_relative_diff(direct_forces, sym_forces, N);
+    printf("    max relative diff (symmetric vs direct): %.3e\n", err);
+    mu_assert("symmetric solver diverges from direct", err < 1e-12);
+
+    Vec3 total = {0.0, 0.0, 0.0};
+    for (int i = 0; i < N; i++) total = vec3_add(total, sym_forces[i]);
+    double scale = fabs(sym_forces[0].x) + fabs(sym_forces[0].y);
+    mu_assert_double_eq("net Fx != 0", total.x, 0.0, 1e-12 * scale);
+    mu_assert_double_eq("net Fy != 0", total.y, 0.0, 1e-12 * scale);
+    mu_assert_double_eq("net Fz != 0", total.z, 0.0, 1e-12 * scale);
+    return NULL;
+}
+
+/**
+ * Repeated calls produce bitwise-identical forces: the per-thread reduction
+ * order does not depend on thread timing.
+ */
+static char *test_symmetric_deterministic() {
+    enum { N = 200 };
+    static PhysicsObject objects[N];
+    static Vec3 first[N], second[N];
+    make_cluster(objects, N);
+
+    newtonian_gravity_symmetric(objects, N, first);
+    newtonian_gravity_symmetric(objects, N, second);
+
+    for (int i = 0; i < N; i++) {
+        mu_assert("Fx not reproducible", first[i].x == second[i].x);
+        mu_assert("Fy not reproducible", first[i].y == second[i].y);
+        mu_assert("Fz not reproducible", first[i].z == second[i].z);
+    }
+    return NULL;
+}
+
+/**
+ * A caller-owned workspace reproduces newtonian_gravity() bitwise, grows when
+ * N increases and is reused without reallocation when N shrinks.
+ */
+static char *test_workspace_reuse() {
+    enum { N = 40 };
+    PhysicsObject objects[N];
+    Vec3 ref[N], got[N];
+    make_cluster(objects, N);
+
+    GravityWorkspace ws;
+    gravity_workspace_init(&ws);
+
+    newtonian_gravity_ws(&ws, objects, 10, got);
+    mu_assert("workspace did not grow to 10", ws.capacity == 10);
+
+    newtonian_gravity_ws(&ws, objects, N, got);
+    mu_assert("workspace did not grow to N", ws.capacity == N);
+    double *block = ws.block;
+
+    newtonian_gravity(objects, N, ref);
+    for (int i = 0; i < N; i++) {
+        mu_assert("Fx differs from newtonian_gravity", got[i].x == ref[i].x);
+        mu_assert("Fy differs from newtonian_gravity", got[i].y == ref[i].y);
+        mu_assert("Fz differs from newtonian_gravity", got[i].z == ref[i].z);
+    }
+
+    /* Smaller N reuses the same buffers; stale contents must not leak in. */
+    newtonian_gravity_ws(&ws, objects, 25, got);
+    newtonian_gravity(objects, 25, ref);
+    mu_assert("workspace reallocated for smaller N", ws.block == block);
+    mu_assert("workspace shrank", ws.capacity == N);
+    for (int i = 0; i < 25; i++) {
+        mu_assert("Fx wrong after shrink", got[i].x == ref[i].x);
+        mu_assert("Fy wrong after shrink", got[i].y == ref[i].y);
+        mu_assert("Fz wrong after shrink", got[i].z == ref[i].z);
+    }
+
+    gravity_workspace_free(&ws);
+    mu_assert("free did not reset capacity", ws.capacity == 0);
+    return NULL;
+}
+
+/**
+ * Every solver run through gravity_compute_ws() in a private workspace gives
+ * the same forces as gravity_compute() on the shared one, on the first call
+ * and when the workspace is reused. The workspace takes the tree and mesh it
+ * needed, and gravity_workspace_free() releases them.
+ */
+static char *test_workspace_every_solver() {
+    enum { N = 40 };
+    PhysicsObject objects[N];
+    Vec3 ref[N], got[N];
+    make_cluster(objects, N);
+
+    const GravitySolver solvers[] = {
+        GRAVITY_SOLVER_MATRIX, GRAVITY_SOLVER_DIRECT, GRAVITY_SOLVER_BARNES_HUT,
+        GRAVITY_SOLVER_FMM, GRAVITY_SOLVER_PM, GRAVITY_SOLVER_SYMMETRIC,
+        GRAVITY_SOLVER_SIMD, GRAVITY_SOLVER_TILED, GRAVITY_SOLVER_MIXED,
+    };
+    const int n_solvers = sizeof(solvers) / sizeof(solvers[0]);
+
+    GravityWorkspace ws;
+    gravity_workspace_init(&ws);
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int s = 0; s < n_solvers; s++) {
+            GravityConfig config;
+            gravity_config_default(&config);
+            config.solver  = solvers[s];
+            config.pm_grid = 16;
+
+            gravity_compute(&config, objects, N, ref);
+            gravity_compute_ws(&ws, &config, objects, N, got);
+
+            /* The mesh deposit adds with atomics, so only its order varies. */
+            const double tol = solvers[s] == GRAVITY_SOLVER_PM ? 1e-12 : 0.0;
+            for (int i = 0; i < N; i++) {
+                double d = vec3_magnitude(vec3_sub(got[i], ref[i]));
+                mu_assert("private workspace differs from shared",
+                          d <= tol * vec3_magnitude(ref[i]));
+            }
+        }
+    }
+
+    mu_assert("tree not kept", ws.tree != NULL);
+    mu_assert("mesh not kept", ws.mesh != NULL);
+    mu_assert("SoA not kept", ws.soa.capacity >= N);
+    mu_assert("mixed staging not kept", ws.mixed_capacity >= N);
+
+    gravity_workspace_free(&ws);
+    mu_assert("tree not released", ws.tree == NULL);
+    mu_assert("mesh not released", ws.mesh == NULL);
+    mu_assert("SoA not released", ws.soa.capacity == 0);
+    return NULL;
+}
+
+/*
+ * Worst ratio of newtonian_gravity_mixed()'s per-body error to its documented
+ * bound Σ_j ε (20 + 32 ε R / r_ij) |F_ij|, and worst relative error, against
+ * the double kernel.
+ */
+static void mixed_error(const PhysicsObject *objects, int count, Vec3 *ref, Vec3 *mixed,
+                        double *worst_ratio, double *worst_rel) {
+    newtonian_gravity_direct(objects, count, ref);
+    newtonian_gravity_mixed(objects, count, mixed);
+
+    Vec3 centre = {0.0, 0.0, 0.0};
+    for (int i = 0; i < count; i++) centre = vec3_add(centre, objects[i].position);
+    centre = vec3_scale(centre, 1.0 / count);
+    double radius = 0.0;
+    for (int i = 0; i < count; i++) {
+        double d = vec3_magnitude(vec3_sub(objects[i].position, centre));
+        if (d > radius) radius = d;
+    }
+
+    const double eps = GRAVITY_MIXED_EPSILON;
+    *worst_ratio = 0.0;
+    *worst_rel   = 0.0;
+    for (int i = 0; i < count; i++) {
+        double bound = 0.0;
+        for (int j = 0; j < count; j++) {
+            if (j == i) continue;
+            double r = vec3_magnitude(vec3_sub(objects[j].position, objects[i].position));
+            double f = G * objects[i].mass * objects[j].mass / (r * r);
+            bound += eps * (20.0 + 32.0 * eps * radius / r) * f;
+        }
+        double err = vec3_magnitude(vec3_sub(mixed[i], ref[i]));
+        double rel = err / vec3_magnitude(ref[i]);
+        if (err / bound > *worst_ratio) *worst_ratio = err / bound;
+        if (rel > *worst_rel) *worst_rel = rel;
+    }
+    printf("    max error / bound: %.3f, max relative error: %.3e\n",
+           *worst_ratio, *worst_rel);
+}
+
+/* Uniform pseudo-random coordinate in [-half, half). */
+static double scatter(unsigned int *state, double half) {
+    *state = *state * 1664525u + 1013904223u;
+    return (double)(*state >> 8) / (double)(1u << 24) * 2.0 * half - half;
+}
+
+/**
+ * Mixed precision stays within its documented per-body bound on a cloud far
+ * from the origin (so the local origin matters) with masses spanning six
+ * orders of magnitude.
+ */
+static char *test_mixed_error_bound() {
+    enum { N = 300 };
+    static PhysicsObject objects[N];
+    static Vec3 ref[N], mixed[N];
+
+    unsigned int state = 2024u;
+    for (int i = 0; i < N; i++) {
+        double c[3];
+        for (int k = 0; k < 3; k++)
+            c[k] = scatter(&state, 1.0e9);
+        objects[i] = (PhysicsObject){
+            .mass     = 1.0e24 * pow(10.0, i % 7),
+            .position = { 1.5e11 + c[0], c[1], c[2] },
+        };
+    }
+
+    double worst_ratio, worst_rel;
+    mixed_error(objects, N, ref, mixed, &worst_ratio, &worst_rel);
+    mu_assert("mixed-precision error exceeds documented bound", worst_ratio <= 1.0);
+    mu_assert("mixed-precision relative error above 1e-4", worst_rel < 1e-4);
+    return NULL;
+}
+
+/**
+ * Close binaries scattered through a cloud 1e5 times their separation keep
+ * the same precision: each displacement is re-centred on its target, so the
+ * cloud radius does not enter the error.
+ */
+static char *test_mixed_wide_cloud() {
+    enum { N = 200 };
+    static PhysicsObject objects[N];
+    static Vec3 ref[N], mixed[N];
+
+    unsigned int state = 77u;
+    for (int i = 0; i < N; i += 2) {
+        Vec3 c = { 1.5e11 + scatter(&state, 1.0e9), scatter(&state, 1.0e9),
+                   scatter(&state, 1.0e9) };
+        Vec3 d = { scatter(&state, 1.0e4), scatter(&state, 1.0e4), scatter(&state, 1.0e4) };
+        objects[i]     = (PhysicsObject){ .mass = 1.0e24, .position = c };
+        objects[i + 1] = (PhysicsObject){ .mass = 3.0e24, .position = vec3_add(c, d) };
+    }
+
+    double worst_ratio, worst_rel;
+    mixed_error(objects, N, ref, mixed, &worst_ratio, &worst_rel);
+    mu_assert("mixed-precision error exceeds documented bound", worst_ratio <= 1.0);
+    mu_assert("close pairs lost precision in a wide cloud", worst_rel < 1e-5);
+    return NULL;
+}
+
 static const TestCase tests[] = {
     {"single_body",          test_single_body},
     {"two_body_axis",        test_two_body_axis},
     {"newton_third_law",     test_newton_third_law},
     {"three_body_collinear", test_three_body_collinear},
     {"two_body_diagonal",    test_two_body_diagonal},
+    {"direct_two_body_diagonal", test_direct_two_body_diagonal},
+    {"direct_matches_matrix",    test_direct_matches_matrix},
+    {"symmetric_matches_direct", test_symmetric_matches_direct},
+    {"symmetric_deterministic",  test_symmetric_deterministic},
+    {"workspace_reuse",          test_workspace_reuse},
+    {"workspace_every_solver",   test_workspace_every_solver},
+    {"mixed_error_bound",        test_mixed_error_bound},
+    {"mixed_wide_cloud",         test_mixed_wide_cloud},
 };
 
 int main(void) {
@@ -0,0 +1,118 @@
+/**
+ * @file test_particle_mesh.c
+ * @brief Unit tests for the particle-mesh gravity solver.
+ *
+ * PM smooths forces on the scale of a few cells, so tests use configurations
+ * whose forces are dominated by large-scale structure: well-separated bodies
+ * and well-separated clusters.
+ *
+ * @author Steven Kight
+ */
+
+#include "forces/gravity.h"
+#include "forces/particle_mesh.h"
+#include "test_runner.h"
+#include <stdio.h>
+
+/* Deterministic cluster of count bodies in a cube of half-width r at centre c. */
+static void make_clump(PhysicsObject *objects, int count, Vec3 c, double r,
+                       unsigned int seed) {
+    unsigned int state = seed;
+    for (int i = 0; i < count; i++) {
+        double u[3];
+        for (int k = 0; k < 3; k++) {
+            state = state * 1664525u + 1013904223u;
+            u[k] = (double)(state >> 8) / (double)(1u << 24) * 2.0 - 1.0;
+        }
+        objects[i] = (PhysicsObject){
+            .mass     = 1.0e6,
+            .position = { c.x + r * u[0], c.y + r * u[1], c.z + r * u[2] },
+        };
+    }
+}
+
+/**
+ * A single body feels no force; fewer than two bodies short-circuit.
+ */
+static char *test_single_body() {
+    PhysicsObject obj = { .mass = 1.0, .position = {1.0, 2.0, 3.0} };
+    Vec3 force = {1.0, 1.0, 1.0};
+
+    particle_mesh_gravity(&obj, 1, 32, PM_ASSIGN_CIC, &force);
+
+    mu_assert_double_eq("single body: Fx != 0", force.x, 0.0, 1e-30);
+    mu_assert_double_eq("single body: Fy != 0", force.y, 0.0, 1e-30);
+    mu_assert_double_eq("single body: Fz != 0", force.z, 0.0, 1e-30);
+    return NULL;
+}
+
+/**
+ * Two bodies spanning the mesh are many cells apart, so the mesh force
+ * matches Newton's law to well under 1 % with either kernel, and isolated
+ * boundaries mean no periodic image pulls them the other way.
+ */
+static char *test_two_body_far() {
+    PhysicsObject objects[2] = {
+        { .mass = 1.0, .position = {  0.0, 0.0, 0.0} },
+        { .mass = 1.0, .position = {100.0, 0.0, 0.0} },
+    };
+    Vec3 forces[2];
+    double expected = GRAVITATIONAL_CONSTANT / (100.0 * 100.0);
+
+    particle_mesh_gravity(objects, 2, 64, PM_ASSIGN_CIC, forces);
+    printf("    CIC: Fx=%.6e (expected %.6e)\n", forces[0].x, expected);
+    mu_assert_double_eq("CIC body 0 Fx", forces[0].x,  expected, 1e-2 * expected);
+    mu_assert_double_eq("CIC body 1 Fx", forces[1].x, -expected, 1e-2 * expected);
+
+    particle_mesh_gravity(objects, 2, 64, PM_ASSIGN_TSC, forces);
+    printf("    TSC: Fx=%.6e (expected %.6e)\n", forces[0].x, expected);
+    mu_assert_double_eq("TSC body 0 Fx", forces[0].x,  expected, 1e-2 * expected);
+    mu_assert_double_eq("TSC body 1 Fx", forces[1].x, -expected, 1e-2 * expected);
+    mu_assert_double_eq("TSC body 0 Fy", forces[0].y, 0.0, 1e-3 * expected);
+    return NULL;
+}
+
+/**
+ * The net force on each of two distant clusters approaches G M_A M_B / d²:
+ * internal forces cancel and the large-scale field is resolved by the mesh.
+ */
+static char *test_cluster_net_force() {
+    enum { HALF = 500, N = 2 * HALF };
+    static PhysicsObject objects[N];
+    static Vec3 forces[N];
+    make_clump(objects,        HALF, (Vec3){ -50.0, 0.0, 0.0 }, 5.0, 11u);
+    make_clump(objects + HALF, HALF, (Vec3){  50.0, 0.0, 0.0 }, 5.0, 29u);
+
+    GravityConfig config;
+    gravity_config_default(&config);
+    config.solver  = GRAVITY_SOLVER_PM;
+    config.pm_grid = 64;
+    gravity_compute(&config, objects, N, forces);
+
+    Vec3 net_a = {0.0, 0.0, 0.0}, net_b = {0.0, 0.0, 0.0};
+    for (int i = 0; i < HALF; i++) {
+        net_a = vec3_add(net_a, forces[i]);
+        net_b = vec3_add(net_b, forces[HALF + i]);
+    }
+
+    double mass = HALF * 1.0e6;
+    double expected = GRAVITATIONAL_CONSTANT * mass * mass / (100.0 * 100.0);
+    printf("    net A: Fx=%.6e  net B: Fx=%.6e  (expected ±%.6e)\n",
+           net_a.x, net_b.x, expected);
+
+    mu_assert_double_eq("cluster A net Fx", net_a.x,  expected, 2e-2 * expected);
+    mu_assert_double_eq("cluster B net Fx", net_b.x, -expected, 2e-2 * expected);
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"single_body",        test_single_body},
+    {"two_body_far",       test_two_body_far},
+    {"cluster_net_force",  test_cluster_net_force},
+};
+
+int main(void) {
+    int failed = run_suite("Particle-Mesh Gravity", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,313 @@
+/**
+ * @file test_sim_context.c
+ * @brief Unit tests for the persistent SimContext / sim_step() API.
+ *
+ * Tests cover: one tick per call matching one call for every integrator,
+ * gravity passes saved across calls by the splittings, invalidation on a
+ * change of body count or on request, pair buffer and workspace counters, the
+ * smallest step kept across calls, sim_run_stats() agreeing with a default
+ * context, and contexts stepping concurrently without sharing solver state.
+ *
+ * @author Steven Kight
+ */
+
+#include "sim.h"
+#include "symplectic.h"
+#include "test_runner.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Test fixtures                                                          */
+/* ------------------------------------------------------------------ */
+
+/* Unit cube centred on (x, y, z); same fixture as test_collision.c. */
+static void make_unit_cube(PhysicsObject *obj, double mass,
+                           double x, double y, double z) {
+    static int id = MESH_NONE;
+    if (id == MESH_NONE) {
+        static const Vec3 verts[8] = {
+            { -0.5, -0.5, -0.5 }, {  0.5, -0.5, -0.5 },
+            {  0.5,  0.5, -0.5 }, { -0.5,  0.5, -0.5 },
+            { -0.5, -0.5,  0.5 }, {  0.5, -0.5,  0.5 },
+            {  0.5,  0.5,  0.5 }, { -0.5,  0.5,  0.5 },
+        };
+        static const int faces[12][3] = {
+            {0, 1, 2}, {0, 2, 3}, {4, 6, 5}, {4, 7, 6}, {0, 3, 7}, {0, 7, 4},
+            {1, 5, 6}, {1, 6, 2}, {0, 4, 5}, {0, 5, 1}, {3, 2, 6}, {3, 6, 7},
+        };
+        id = mesh_register(verts, 8, faces, 12);
+    }
+    memset(obj, 0, sizeof(*obj));
+    obj->mass     = mass;
+    obj->position = (Vec3){ x, y, z };
+    obj->mesh_id  = id;
+}
+
+/* Point-mass cloud plus two cubes that collide within the first ticks. */
+static void make_scene(PhysicsObject *objects, int count) {
+    srand(11);
+    for (int i = 0; i < count; i++) {
+        object_init(&objects[i], 1.0e10 * (1 + rand() % 100),
+                    rand() % 2000 - 1000.0, rand() % 2000 - 1000.0,
+                    rand() % 2000 - 1000.0);
+        objects[i].velocity = (Vec3){ (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3 };
+    }
+    make_unit_cube(&objects[0], 1.0e3, 0.0, 0.0, 0.0);
+    make_unit_cube(&objects[1], 1.0e3, 1.2, 0.0, 0.0);
+    objects[1].velocity = (Vec3){ -1.0, 0.0, 0.0 };
+}
+
+static int vec3_same(Vec3 a, Vec3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static int objects_same(const PhysicsObject *a, const PhysicsObject *b, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!vec3_same(a[i].position, b[i].position) ||
+            !vec3_same(a[i].velocity, b[i].velocity) ||
+            !vec3_same(a[i].acceleration, b[i].acceleration))
+            return 0;
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Tests                                                                  */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Forty sim_step() calls of one tick reproduce a single forty-tick call
+ * bitwise, with the same work counters, for every integrator.
+ */
+static char *test_split_matches_single_call() {
+    enum { N = 12, TICKS = 40 };
+    const SimIntegrator integrators[6] = {
+        SIM_INTEGRATOR_VERLET, SIM_INTEGRATOR_BLOCK, SIM_INTEGRATOR_HERMITE,
+        SIM_INTEGRATOR_KDK, SIM_INTEGRATOR_YOSHIDA4, SIM_INTEGRATOR_FOREST_RUTH,
+    };
+    for (int s = 0; s < 6; s++) {
+        PhysicsObject whole[N], split[N];
+        make_scene(whole, N);
+        memcpy(split, whole, sizeof(whole));
+
+        SimConfig config;
+        sim_config_default(&config);
+        config.integrator = integrators[s];
+
+        SimStats whole_stats, split_stats;
+        sim_run_stats(whole, N, 0.05, TICKS, &config, &whole_stats);
+
+        SimContext *ctx = sim_context_create(&config);
+        mu_assert("create failed", ctx != NULL);
+        for (int tick = 0; tick < TICKS; tick++)
+            mu_assert("step failed", sim_step(ctx, split, N, 0.05, 1) == 0);
+        sim_context_stats(ctx, &split_stats);
+        sim_context_destroy(ctx);
+
+        mu_assert("state differs", objects_same(whole, split, N));
+        mu_assert("cubes did not collide", whole[1].velocity.x > -1.0);
+        mu_assert("step count differs", split_stats.steps == whole_stats.steps);
+        mu_assert("evaluation count differs",
+                  split_stats.force_evaluations == whole_stats.force_evaluations);
+        mu_assert("collision not counted", split_stats.peak_pairs >= 1);
+        mu_assert("pair capacity not reported",
+                  split_stats.pair_capacity >= split_stats.peak_pairs);
+        mu_assert("pair buffer sized for N^2",
+                  split_stats.pair_capacity < N * (N - 1) / 2);
+    }
+
+    /* The context's collision workspace reports what the scene needed. */
+    PhysicsObject objects[N];
+    make_scene(objects, N);
+    SimContext *ctx = sim_context_create(NULL);
+    mu_assert("create failed", ctx != NULL);
+    sim_step(ctx, objects, N, 0.05, 5);
+    CollisionUsage usage;
+    collision_workspace_usage(sim_context_collision(ctx), &usage);
+    mu_assert("candidates recorded", usage.candidate_high_water >= 1);
+    mu_assert("nodes recorded", usage.node_high_water >= 1);
+    sim_context_destroy(ctx);
+    return NULL;
+}
+
+/**
+ * A KDK context stepped one tick per call keeps its accelerations between
+ * calls: ten calls cost 1 + 10 gravity passes, where ten sim_run_stats()
+ * calls cost 2 each.
+ */
+static char *test_splitting_reuses_forces() {
+    enum { N = 8, TICKS = 10 };
+    PhysicsObject objects[N];
+    make_scene(objects, N);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = SIM_INTEGRATOR_KDK;
+
+    SimContext *ctx = sim_context_create(&config);
+    mu_assert("create failed", ctx != NULL);
+    for (int tick = 0; tick < TICKS; tick++)
+        sim_step(ctx, objects, N, 0.05, 1);
+    SimStats stats;
+    sim_context_stats(ctx, &stats);
+    sim_context_destroy(ctx);
+
+    long long per_call = 0;
+    for (int tick = 0; tick < TICKS; tick++) {
+        SimStats one;
+        sim_run_stats(objects, N, 0.05, 1, &config, &one);
+        per_call += one.force_evaluations;
+    }
+
+    mu_assert("context evaluations", stats.force_evaluations == N * (1LL + TICKS));
+    mu_assert("per-call evaluations", per_call == N * 2LL * TICKS);
+    return NULL;
+}
+
+/**
+ * min_time_step keeps the smallest step across sim_step() calls for every
+ * fixed-step integrator, rather than reporting the latest one.
+ */
+static char *test_min_time_step_across_calls() {
+    enum { N = 8 };
+    const SimIntegrator integrators[5] = {
+        SIM_INTEGRATOR_VERLET, SIM_INTEGRATOR_HERMITE, SIM_INTEGRATOR_KDK,
+        SIM_INTEGRATOR_YOSHIDA4, SIM_INTEGRATOR_FOREST_RUTH,
+    };
+    for (int s = 0; s < 5; s++) {
+        PhysicsObject objects[N];
+        make_scene(objects, N);
+
+        SimConfig config;
+        sim_config_default(&config);
+        config.integrator = integrators[s];
+
+        SimContext *ctx = sim_context_create(&config);
+        mu_assert("create failed", ctx != NULL);
+        sim_step(ctx, objects, N, 0.05, 2);
+        sim_step(ctx, objects, N, 0.2, 2);
+        SimStats stats;
+        sim_context_stats(ctx, &stats);
+        sim_context_destroy(ctx);
+
+        mu_assert("min step overwritten", stats.min_time_step == 0.05);
+    }
+    return NULL;
+}
+
+/**
+ * Invalidating, explicitly or by changing the body count, makes the next
+ * tick start from fresh forces, exactly as a new context would.
+ */
+static char *test_invalidate() {
+    enum { N = 8 };
+    PhysicsObject objects[N], fresh[N];
+    make_scene(objects, N);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = SIM_INTEGRATOR_HERMITE;
+
+    SimContext *ctx = sim_context_create(&config);
+    mu_assert("create failed", ctx != NULL);
+    sim_step(ctx, objects, N, 0.05, 5);
+
+    /* Drop the last two bodies: the context must not reuse their state. */
+    memcpy(fresh, objects, sizeof(objects));
+    mu_assert("step failed", sim_step(ctx, objects, N - 2, 0.05, 5) == 0);
+    sim_run_stats(fresh, N - 2, 0.05, 5, &config, NULL);
+    mu_assert("count change not invalidated", objects_same(objects, fresh, N - 2));
+
+    /* Edit a velocity between calls, as a keyframed object would. */
+    objects[3].velocity = (Vec3){ 2.0, 0.0, 0.0 };
+    memcpy(fresh, objects, sizeof(objects));
+    sim_context_invalidate(ctx);
+    sim_step(ctx, objects, N - 2, 0.05, 5);
+    sim_run_stats(fresh, N - 2, 0.05, 5, &config, NULL);
+    mu_assert("invalidate not honoured", objects_same(objects, fresh, N - 2));
+
+    sim_context_destroy(ctx);
+    return NULL;
+}
+
+/** A context created with NULL steps exactly as sim_run(). */
+static char *test_default_config() {
+    enum { N = 12 };
+    PhysicsObject a[N], b[N];
+    make_scene(a, N);
+    memcpy(b, a, sizeof(a));
+
+    sim_run(a, N, 0.05, 20);
+
+    SimContext *ctx = sim_context_create(NULL);
+    mu_assert("create failed", ctx != NULL);
+    sim_step(ctx, b, N, 0.05, 12);
+    sim_step(ctx, b, N, 0.05, 8);
+    sim_context_destroy(ctx);
+
+    mu_assert("default context differs from sim_run", objects_same(a, b, N));
+    sim_context_destroy(NULL);
+    return NULL;
+}
+
+/**
+ * Contexts share no solver state: two contexts stepped at the same time on
+ * separate threads each follow sim_run_stats() bitwise. The solvers chosen
+ * give per-body results independent of the thread count, so the serial
+ * reference is exact.
+ */
+static char *test_concurrent_contexts() {
+    enum { N = 24, TICKS = 10 };
+    const GravitySolver solvers[4] = {
+        GRAVITY_SOLVER_BARNES_HUT, GRAVITY_SOLVER_TILED,
+        GRAVITY_SOLVER_SIMD, GRAVITY_SOLVER_MIXED,
+    };
+    for (int s = 0; s < 4; s += 2) {
+        PhysicsObject ref[2][N], run[2][N];
+        SimConfig config[2];
+        for (int k = 0; k < 2; k++) {
+            make_scene(ref[k], N);
+            ref[k][5].velocity.y += 0.5 * k;  /* the two scenes differ */
+            memcpy(run[k], ref[k], sizeof(ref[k]));
+            sim_config_default(&config[k]);
+            config[k].gravity.solver = solvers[s + k];
+            mu_assert("reference run failed",
+                      sim_run_stats(ref[k], N, 0.05, TICKS, &config[k], NULL) == 0);
+        }
+
+        int rc[2] = { -1, -1 };
+        #pragma omp parallel for num_threads(2) schedule(static, 1)
+        for (int k = 0; k < 2; k++) {
+            SimContext *ctx = sim_context_create(&config[k]);
+            if (ctx) {
+                rc[k] = 0;
+                for (int tick = 0; tick < TICKS && rc[k] == 0; tick++)
+                    rc[k] = sim_step(ctx, run[k], N, 0.05, 1);
+            }
+            sim_context_destroy(ctx);
+        }
+
+        for (int k = 0; k < 2; k++) {
+            mu_assert("concurrent step failed", rc[k] == 0);
+            mu_assert("concurrent context differs", objects_same(ref[k], run[k], N));
+        }
+    }
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"split_matches_single_call",  test_split_matches_single_call},
+    {"splitting_reuses_forces",    test_splitting_reuses_forces},
+    {"min_time_step_across_calls", test_min_time_step_across_calls},
+    {"invalidate",                 test_invalidate},
+    {"default_config",             test_default_config},
+    {"concurrent_contexts",        test_concurrent_contexts},
+};
+
+int main(void) {
+    int failed = run_suite("SimContext", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
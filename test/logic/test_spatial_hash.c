@@ -0,0 +1,141 @@
+/**
+ * @file test_spatial_hash.c
+ * @brief Unit tests for the hashed uniform-grid broad phase.
+ *
+ * Tests cover: the cell size taken from the median body extent and bodies
+ * too large for the grid kept on their own list, plus the shared checks from
+ * broad_phase_fixtures.h run on the grid for mixed body sizes: brute-force
+ * candidates, and the same confirmed pairs and simulation results as the
+ * octree.
+ *
+ * @author Steven Kight
+ */
+
+#include "collision/spatial_hash.h"
+#include "broad_phase_fixtures.h"
+#include "test_runner.h"
+#include <math.h>
+
+/* ------------------------------------------------------------------ */
+/* Test fixtures                                                          */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Fragments scattered through a 20 m box: mostly unit cubes, with every
+ * seventh a 0.4 m chip, every eleventh a 2.5 m block and every hundredth a
+ * 12 m slab too large for the grid.
+ */
+static void make_fragments(PhysicsObject *objects, int count) {
+    srand(11);
+    for (int i = 0; i < count; i++) {
+        double side = 1.0;
+        if (i % 7 == 0)   side = 0.4;
+        if (i % 11 == 0)  side = 2.5;
+        if (i % 100 == 0) side = 12.0;
+        make_cube(&objects[i], side, rand() % 2000 * 0.01, rand() % 2000 * 0.01,
+                  rand() % 2000 * 0.01);
+    }
+}
+
+static int grid_candidates(void *phase, const CollisionBody *bodies, int count,
+                           CollisionPairBuffer *out) {
+    if (spatial_hash_build(phase, bodies, count) != 0) return -1;
+    return spatial_hash_query_pairs(phase, out);
+}
+
+/* ------------------------------------------------------------------ */
+/* Tests                                                                  */
+/* ------------------------------------------------------------------ */
+
+/**
+ * The cell side follows the median of the largest AABB extents: 2 m for
+ * three 2 m cubes and two 0.5 m cubes, whatever their order.
+ */
+static char *test_cell_size_from_median() {
+    PhysicsObject objects[5];
+    make_cube(&objects[0], 0.5, 0.0, 0.0, 0.0);
+    make_cube(&objects[1], 2.0, 3.0, 0.0, 0.0);
+    make_cube(&objects[2], 2.0, 6.0, 0.0, 0.0);
+    make_cube(&objects[3], 0.5, 9.0, 0.0, 0.0);
+    make_cube(&objects[4], 2.0, 12.0, 0.0, 0.0);
+
+    CollisionBody bodies[5];
+    make_bodies(objects, bodies, 5);
+
+    SpatialHash grid;
+    spatial_hash_init(&grid);
+    mu_assert("build failed", spatial_hash_build(&grid, bodies, 5) == 0);
+    mu_assert("cell size is not the median extent", grid.cell_size == SPATIAL_HASH_CELL_SCALE * 2.0);
+    mu_assert("no body should be too large", grid.large_count == 0);
+    spatial_hash_free(&grid);
+    return NULL;
+}
+
+/**
+ * The unit cubes set the cell size for the fragment field, and the four
+ * slabs span too many cells and go on the large-body list instead.
+ */
+static char *test_large_bodies_bypass_grid() {
+    enum { N = 400 };
+    static PhysicsObject objects[N];
+    static CollisionBody bodies[N];
+    make_fragments(objects, N);
+    make_bodies(objects, bodies, N);
+
+    SpatialHash grid;
+    spatial_hash_init(&grid);
+    mu_assert("build failed", spatial_hash_build(&grid, bodies, N) == 0);
+    mu_assert("cell size should follow the unit cubes", fabs(grid.cell_size - SPATIAL_HASH_CELL_SCALE) < 1e-9);
+    mu_assert("slabs should bypass the grid", grid.large_count == 4);
+    spatial_hash_free(&grid);
+    return NULL;
+}
+
+/**
+ * For mixed fragment sizes the candidates match brute force, slabs included
+ * through the large-body list; a second build over the same buffers (the
+ * second tick) gives the same answer.
+ */
+static char *test_matches_brute_force() {
+    enum { N = 400 };
+    static PhysicsObject objects[N];
+    make_fragments(objects, N);
+
+    SpatialHash grid;
+    spatial_hash_init(&grid);
+    char *message = check_matches_brute_force(objects, N, 2, 0.0, grid_candidates, &grid);
+    spatial_hash_free(&grid);
+    return message;
+}
+
+/**
+ * collision_detect_ws() confirms the same pairs with the spatial hash as
+ * with the octree.
+ */
+static char *test_detect_matches_octree() {
+    enum { N = 400 };
+    static PhysicsObject objects[N];
+    make_fragments(objects, N);
+    return check_detect_matches_octree(objects, N, 1, 0.0, COLLISION_BROAD_GRID);
+}
+
+/**
+ * A simulation selecting the spatial hash through SimConfig follows the
+ * octree run bitwise.
+ */
+static char *test_sim_broad_phase() {
+    return check_sim_matches_octree(COLLISION_BROAD_GRID);
+}
+
+static const TestCase tests[] = {
+    {"cell_size_from_median",     test_cell_size_from_median},
+    {"large_bodies_bypass_grid",  test_large_bodies_bypass_grid},
+    {"matches_brute_force",       test_matches_brute_force},
+    {"detect_matches_octree",     test_detect_matches_octree},
+    {"sim_broad_phase",           test_sim_broad_phase},
+};
+
+int main(void) {
+    int failed = run_suite("Spatial Hash", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_sweep_prune.c
+ * @brief Unit tests for the sweep-and-prune broad phase.
+ *
+ * Tests cover: incremental re-sorting on small motion and rebuilding on a
+ * count change, plus the shared checks from broad_phase_fixtures.h run on
+ * sweep and prune: brute-force candidates over several ticks of motion, and
+ * the same confirmed pairs and simulation results as the octree.
+ *
+ * @author Steven Kight
+ */
+
+#include "collision/sweep_prune.h"
+#include "broad_phase_fixtures.h"
+#include "test_runner.h"
+
+/* ------------------------------------------------------------------ */
+/* Tests                                                                  */
+/* ------------------------------------------------------------------ */
+
+static int sweep_candidates(void *phase, const CollisionBody *bodies, int count,
+                            CollisionPairBuffer *out) {
+    if (sweep_prune_update(phase, bodies, count) != 0) return -1;
+    return sweep_prune_query_pairs(phase, out);
+}
+
+/**
+ * Each tick of a drifting debris field the candidates match brute force —
+ * first from a rebuild, then from the pairs added and removed by
+ * incremental updates.
+ */
+static char *test_matches_brute_force() {
+    enum { N = 300 };
+    static PhysicsObject objects[N];
+    make_debris(objects, N);
+
+    SweepPrune sap;
+    sweep_prune_init(&sap);
+    char *message = check_matches_brute_force(objects, N, 10, 5.0, sweep_candidates, &sap);
+    sweep_prune_free(&sap);
+    return message;
+}
+
+/**
+ * After a small motion the lists are nearly sorted and need few swaps; a
+ * change in body count rebuilds from scratch.
+ */
+static char *test_incremental_sort() {
+    enum { N = 500 };
+    static PhysicsObject objects[N];
+    static CollisionBody bodies[N];
+    make_debris(objects, N);
+
+    SweepPrune sap;
+    CollisionPairBuffer out;
+    sweep_prune_init(&sap);
+    collision_pairs_init(&out);
+
+    make_bodies(objects, bodies, N);
+    sweep_prune_update(&sap, bodies, N);
+    mu_assert("rebuild should not count swaps", sap.swaps == 0);
+
+    drift(objects, N, 0.1);
+    make_bodies(objects, bodies, N);
+    sweep_prune_update(&sap, bodies, N);
+    mu_assert("small motion should need few swaps", sap.swaps > 0 && sap.swaps < N);
+
+    sweep_prune_update(&sap, bodies, N - 1);
+    mu_assert("count change not rebuilt", sap.count == N - 1 && sap.swaps == 0);
+    int n = sweep_prune_query_pairs(&sap, &out);
+    for (int k = 0; k < n; k++)
+        mu_assert("stale index after count change", out.pairs[k].index_b < N - 1);
+
+    sweep_prune_free(&sap);
+    collision_pairs_free(&out);
+    return NULL;
+}
+
+/**
+ * collision_detect_ws() confirms the same pairs as with the octree, tick
+ * after tick.
+ */
+static char *test_detect_matches_octree() {
+    enum { N = 400 };
+    static PhysicsObject objects[N];
+    make_debris(objects, N);
+    return check_detect_matches_octree(objects, N, 5, 1.0, COLLISION_BROAD_SWEEP);
+}
+
+/**
+ * A simulation selecting sweep and prune through SimConfig follows the
+ * octree run bitwise.
+ */
+static char *test_sim_broad_phase() {
+    return check_sim_matches_octree(COLLISION_BROAD_SWEEP);
+}
+
+static const TestCase tests[] = {
+    {"matches_brute_force",    test_matches_brute_force},
+    {"incremental_sort",       test_incremental_sort},
+    {"detect_matches_octree",  test_detect_matches_octree},
+    {"sim_broad_phase",        test_sim_broad_phase},
+};
+
+int main(void) {
+    int failed = run_suite("Sweep and Prune", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_symplectic.c
+ * @brief Unit tests for the symplectic splitting integrators.
+ *
+ * Tests cover: gravity passes per step (including first-same-as-last reuse),
+ * the convergence order of each scheme, bounded long-term energy error on an
+ * eccentric orbit, and Forest–Ruth beating Yoshida at equal force work.
+ *
+ * @author Steven Kight
+ */
+
+#include "sim.h"
+#include "symplectic.h"
+#include "test_runner.h"
+#include <math.h>
+#include <stdio.h>
+
+static const double G = GRAVITATIONAL_CONSTANT;
+
+static const double binary_mass = 1.0e20;  /* each member (kg) */
+static const double binary_a    = 1.0e3;   /* semi-major axis of the relative orbit (m) */
+
+static double binary_period(void) {
+    return 2.0 * M_PI * sqrt(pow(binary_a, 3.0) / (G * 2.0 * binary_mass));
+}
+
+/* Equal-mass binary of eccentricity @p e, started at apoapsis. */
+static void build_binary(PhysicsObject *objects, double e) {
+    const double gm    = G * 2.0 * binary_mass;
+    const double r_apo = binary_a * (1.0 + e);
+    const double v_apo = sqrt(gm * (1.0 - e) / r_apo);
+    object_init(&objects[0], binary_mass, -r_apo / 2.0, 0.0, 0.0);
+    object_init(&objects[1], binary_mass,  r_apo / 2.0, 0.0, 0.0);
+    objects[0].velocity = (Vec3){0.0, -v_apo / 2.0, 0.0};
+    objects[1].velocity = (Vec3){0.0,  v_apo / 2.0, 0.0};
+}
+
+static double binary_energy(const PhysicsObject *objects) {
+    double v0 = vec3_magnitude(objects[0].velocity);
+    double v1 = vec3_magnitude(objects[1].velocity);
+    double r  = vec3_magnitude(vec3_sub(objects[1].position, objects[0].position));
+    return 0.5 * binary_mass * (v0 * v0 + v1 * v1) - G * binary_mass * binary_mass / r;
+}
+
+/* Position error of body 1 after one circular orbit in @p steps steps. */
+static double one_orbit_error(SimIntegrator scheme, int steps) {
+    PhysicsObject objects[2];
+    build_binary(objects, 0.0);
+
+    SimConfig config;
+    sim_config_default(&config);
+    config.integrator = scheme;
+    sim_run_config(objects, 2, binary_period() / steps, steps, &config);
+
+    return vec3_magnitude(vec3_sub(objects[1].position, (Vec3){binary_a / 2.0, 0.0, 0.0}));
+}
+
+/*
+ * Largest relative energy error over @p orbits orbits of an e = 0.5 binary,
+ * sampled once per step, in windows of the first and last tenth of the run.
+ */
+static void energy_errors(SimIntegrator scheme, int steps_per_orbit, int orbits,
+                          double *early, double *late) {
+    PhysicsObject objects[2];
+    build_binary(objects, 0.5);
+    const double e0 = binary_energy(objects);
+
+    GravityConfig gravity;
+    gravity_config_default(&gravity);
+    SymplecticState state;
+    symplectic_state_init(&state);
+
+    const int total = steps_per_orbit * orbits;
+    const double dt = binary_period() / steps_per_orbit;
+    *early = *late = 0.0;
+    for (int step = 0; step < total; step++) {
+        symplectic_step(&state, scheme, objects, 2, dt, &gravity, NULL, NULL);
+        double err = fabs(binary_energy(objects) - e0) / fabs(e0);
+        if (step < total / 10 && err > *early) *early = err;
+        if (step >= total - total / 10 && err > *late) *late = err;
+    }
+    symplectic_state_free(&state);
+}
+
+/**
+ * KDK, Yoshida and Forest–Ruth take 1, 3 and 4 gravity passes per step; the
+ * kick-first schemes pay one extra pass on the very first step only.
+ */
+static char *test_evaluations_per_step() {
+    mu_assert("KDK passes",         symplectic_evaluations_per_step(SIM_INTEGRATOR_KDK) == 1);
+    mu_assert("Yoshida passes",     symplectic_evaluations_per_step(SIM_INTEGRATOR_YOSHIDA4) == 3);
+    mu_assert("Forest-Ruth passes", symplectic_evaluations_per_step(SIM_INTEGRATOR_FOREST_RUTH) == 4);
+    mu_assert("Verlet is not a splitting", symplectic_evaluations_per_step(SIM_INTEGRATOR_VERLET) == 0);
+
+    const SimIntegrator schemes[3] = {
+        SIM_INTEGRATOR_KDK, SIM_INTEGRATOR_YOSHIDA4, SIM_INTEGRATOR_FOREST_RUTH,
+    };
+    const long long first[3] = {1, 1, 0};
+    for (int s = 0; s < 3; s++) {
+        PhysicsObject objects[2];
+        build_binary(objects, 0.0);
+
+        SimConfig config;
+        sim_config_default(&config);
+        config.integrator = schemes[s];
+
+        SimStats stats;
+        sim_run_stats(objects, 2, 0.01, 10, &config, &stats);
+
+        long long expected = 2 * (first[s] + 10LL * symplectic_evaluations_per_step(schemes[s]));
+        mu_assert("force evaluation count", stats.force_evaluations == expected);
+        mu_assert("step count", stats.steps == 10);
+    }
+    return NULL;
+}
+
+/**
+ * Halving the step cuts the one-orbit error by ~4 for KDK and ~16 for the
+ * fourth-order schemes.
+ */
+static char *test_convergence_order() {
+    const SimIntegrator schemes[3] = {
+        SIM_INTEGRATOR_KDK, SIM_INTEGRATOR_YOSHIDA4, SIM_INTEGRATOR_FOREST_RUTH,
+    };
+    const char *names[3] = {"kdk", "yoshida4", "forest-ruth"};
+    const double min_ratio[3] = {3.5, 12.0, 12.0};
+
+    for (int s = 0; s < 3; s++) {
+        double coarse = one_orbit_error(schemes[s], 64);
+        double fine   = one_orbit_error(schemes[s], 128);
+        printf("    %-11s error %.3e m (P/64), %.3e m (P/128), ratio %.1f\n",
+               names[s], coarse, fine, coarse / fine);
+        mu_assert("convergence order too low", coarse / fine > min_ratio[s]);
+    }
+    return NULL;
+}
+
+/**
+ * Over 200 orbits of an e = 0.5 binary the energy error of a symplectic
+ * scheme oscillates but does not grow: the last tenth of the run is no worse
+ * than the first.
+ */
+static char *test_energy_bounded() {
+    double early, late;
+    energy_errors(SIM_INTEGRATOR_KDK, 200, 200, &early, &late);
+    printf("    kdk max |dE/E|: first 20 orbits %.3e, last 20 orbits %.3e\n", early, late);
+
+    mu_assert("KDK energy error drifted", late < 1.5 * early);
+    mu_assert("KDK energy error too large", late < 1e-2);
+    return NULL;
+}
+
+/**
+ * At equal gravity passes per orbit (240), Forest–Ruth's smaller error
+ * constant outweighs its shorter step count against Yoshida.
+ */
+static char *test_forest_ruth_beats_yoshida() {
+    double y_early, y_late, f_early, f_late;
+    energy_errors(SIM_INTEGRATOR_YOSHIDA4,    80, 20, &y_early, &y_late);
+    energy_errors(SIM_INTEGRATOR_FOREST_RUTH, 60, 20, &f_early, &f_late);
+    printf("    max |dE/E| at 240 passes/orbit: yoshida %.3e, forest-ruth %.3e\n",
+           y_late, f_late);
+
+    mu_assert("Forest-Ruth not more accurate per force evaluation", f_late < y_late);
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"evaluations_per_step",       test_evaluations_per_step},
+    {"convergence_order",          test_convergence_order},
+    {"energy_bounded",             test_energy_bounded},
+    {"forest_ruth_beats_yoshida",  test_forest_ruth_beats_yoshida},
+};
+
+int main(void) {
+    int failed = run_suite("Symplectic Integrators", tests,
+                           sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
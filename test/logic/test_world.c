@@ -0,0 +1,273 @@
+/**
+ * @file test_world.c
+ * @brief Unit tests for the structure-of-arrays PhysicsWorld.
+ *
+ * Tests cover: import/export round trip and growth, world_step against
+ * object_step, SoA gravity against the PhysicsObject solvers, collision
+ * detection over a world, and sim_run_world against sim_run_stats.
+ *
+ * @author Steven Kight
+ */
+
+#include "sim.h"
+#include "forces/gravity.h"
+#include "collision/collision.h"
+#include "test_runner.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Test fixtures                                                          */
+/* ------------------------------------------------------------------ */
+
+/* Unit cube centred on (x, y, z); same fixture as test_collision.c. */
+static void make_unit_cube(PhysicsObject *obj, double mass,
+                           double x, double y, double z) {
+    static int id = MESH_NONE;
+    if (id == MESH_NONE) {
+        static const Vec3 verts[8] = {
+            { -0.5, -0.5, -0.5 }, {  0.5, -0.5, -0.5 },
+            {  0.5,  0.5, -0.5 }, { -0.5,  0.5, -0.5 },
+            { -0.5, -0.5,  0.5 }, {  0.5, -0.5,  0.5 },
+            {  0.5,  0.5,  0.5 }, { -0.5,  0.5,  0.5 },
+        };
+        static const int faces[12][3] = {
+            {0, 1, 2}, {0, 2, 3}, {4, 6, 5}, {4, 7, 6}, {0, 3, 7}, {0, 7, 4},
+            {1, 5, 6}, {1, 6, 2}, {0, 4, 5}, {0, 5, 1}, {3, 2, 6}, {3, 6, 7},
+        };
+        id = mesh_register(verts, 8, faces, 12);
+    }
+    memset(obj, 0, sizeof(*obj));
+    obj->mass     = mass;
+    obj->position = (Vec3){ x, y, z };
+    obj->mesh_id  = id;
+}
+
+/* Deterministic cloud of point masses with varied velocities. */
+static void make_cloud(PhysicsObject *objects, int count) {
+    srand(7);
+    for (int i = 0; i < count; i++) {
+        object_init(&objects[i], 1.0e10 * (1 + rand() % 100),
+                    rand() % 2000 - 1000.0, rand() % 2000 - 1000.0,
+                    rand() % 2000 - 1000.0);
+        objects[i].velocity = (Vec3){ (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3,
+                                      (rand() % 200 - 100) * 1e-3 };
+        objects[i].softening = (i % 3 == 0) ? 5.0 : 0.0;
+    }
+}
+
+static int vec3_same(Vec3 a, Vec3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/* ------------------------------------------------------------------ */
+/* Storage                                                                */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Importing and exporting returns every field unchanged, and growing the
+ * world keeps the bodies already in it.
+ */
+static char *test_import_export_round_trip() {
+    PhysicsObject in[3], out[3];
+    make_unit_cube(&in[0], 2.0, 1.0, 2.0, 3.0);
+    make_cloud(&in[1], 2);
+    in[0].velocity     = (Vec3){ 4.0, 5.0, 6.0 };
+    in[0].acceleration = (Vec3){ 7.0, 8.0, 9.0 };
+    in[0].force        = (Vec3){ 1.5, 2.5, 3.5 };
+
+    PhysicsWorld world;
+    world_init(&world);
+    mu_assert("import failed", world_import(&world, in, 3) == 0);
+    mu_assert("count", world.count == 3);
+    mu_assert("grow failed", world_reserve(&world, 100) == 0);
+    mu_assert("capacity", world.capacity == 100);
+
+    memset(out, 0xff, sizeof(out));
+    world_export(&world, out);
+    for (int i = 0; i < 3; i++) {
+        mu_assert("mass",         out[i].mass == in[i].mass);
+        mu_assert("softening",    out[i].softening == in[i].softening);
+        mu_assert("position",     vec3_same(out[i].position, in[i].position));
+        mu_assert("velocity",     vec3_same(out[i].velocity, in[i].velocity));
+        mu_assert("acceleration", vec3_same(out[i].acceleration, in[i].acceleration));
+        mu_assert("force",        vec3_same(out[i].force, in[i].force));
+        mu_assert("mesh id",      out[i].mesh_id == in[i].mesh_id);
+    }
+    mu_assert("cube mesh lost", out[0].mesh_id != MESH_NONE);
+
+    world_free(&world);
+    mu_assert("freed", world.capacity == 0 && world.mass == NULL);
+    return NULL;
+}
+
+/**
+ * world_step() performs exactly object_step()'s arithmetic, so a world and
+ * the equivalent objects stay bitwise identical.
+ */
+static char *test_step_matches_object_step() {
+    enum { N = 16 };
+    PhysicsObject objects[N];
+    make_cloud(objects, N);
+    for (int i = 0; i < N; i++) {
+        objects[i].acceleration = (Vec3){ 0.1 * i, -0.2, 0.3 };
+        objects[i].force        = (Vec3){ 1.0e9, 2.0e9 * i, -3.0e9 };
+    }
+
+    PhysicsWorld world;
+    world_init(&world);
+    mu_assert("import failed", world_import(&world, objects, N) == 0);
+
+    world_step(&world, 0.37);
+    for (int i = 0; i < N; i++) object_step(&objects[i], 0.37);
+
+    for (int i = 0; i < N; i++) {
+        mu_assert("position differs",     vec3_same(world.position[i], objects[i].position));
+        mu_assert("velocity differs",     vec3_same(world.velocity[i], objects[i].velocity));
+        mu_assert("acceleration differs", vec3_same(world.acceleration[i], objects[i].acceleration));
+        mu_assert("force not reset",      vec3_same(world.force[i], (Vec3){0.0, 0.0, 0.0}));
+    }
+    world_free(&world);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* Hot loops                                                              */
+/* ------------------------------------------------------------------ */
+
+/**
+ * The SoA kernel reproduces newtonian_gravity_direct() and the softened
+ * kernel bitwise, and gravity_compute_world() matches gravity_compute() for
+ * every solver, softened or not.
+ */
+static char *test_gravity_matches_objects() {
+    enum { N = 64 };
+    PhysicsObject objects[N];
+    make_cloud(objects, N);
+
+    PhysicsWorld world;
+    world_init(&world);
+    mu_assert("import failed", world_import(&world, objects, N) == 0);
+
+    Vec3 expected[N], actual[N];
+    newtonian_gravity_direct(objects, N, expected);
+    newtonian_gravity_world(&world, GRAVITY_SOFTENING_NONE, 0.0, actual);
+    for (int i = 0; i < N; i++)
+        mu_assert("direct differs", vec3_same(actual[i], expected[i]));
+
+    newtonian_gravity_softened(objects, N, GRAVITY_SOFTENING_SPLINE, 2.0, expected);
+    newtonian_gravity_world(&world, GRAVITY_SOFTENING_SPLINE, 2.0, actual);
+    for (int i = 0; i < N; i++)
+        mu_assert("softened differs", vec3_same(actual[i], expected[i]));
+
+    const GravitySolver solvers[] = {
+        GRAVITY_SOLVER_DIRECT, GRAVITY_SOLVER_MATRIX, GRAVITY_SOLVER_BARNES_HUT,
+        GRAVITY_SOLVER_FMM, GRAVITY_SOLVER_SYMMETRIC, GRAVITY_SOLVER_SIMD,
+        GRAVITY_SOLVER_TILED, GRAVITY_SOLVER_MIXED, GRAVITY_SOLVER_PM,
+    };
+    GravityConfig config;
+    gravity_config_default(&config);
+    for (int soft = 0; soft < 2; soft++) {
+        config.softening        = soft ? GRAVITY_SOFTENING_SPLINE : GRAVITY_SOFTENING_NONE;
+        config.softening_length = soft ? 2.0 : 0.0;
+        for (size_t k = 0; k < sizeof(solvers) / sizeof(solvers[0]); k++) {
+            config.solver = solvers[k];
+            gravity_compute(&config, objects, N, expected);
+            gravity_compute_world(&config, &world, actual);
+            for (int i = 0; i < N; i++)
+                mu_assert("world solver differs", vec3_same(actual[i], expected[i]));
+        }
+    }
+
+    world_free(&world);
+    return NULL;
+}
+
+/**
+ * collision_detect_world() reports the same pairs as collision_detect() for
+ * a row of cubes where neighbours 0–1 and 2–3 overlap and 4 is isolated.
+ */
+static char *test_collision_matches_objects() {
+    PhysicsObject objects[5];
+    make_unit_cube(&objects[0], 1.0,  0.0, 0.0, 0.0);
+    make_unit_cube(&objects[1], 1.0,  0.8, 0.0, 0.0);
+    make_unit_cube(&objects[2], 1.0,  5.0, 0.0, 0.0);
+    make_unit_cube(&objects[3], 1.0,  5.5, 0.5, 0.0);
+    make_unit_cube(&objects[4], 1.0, 20.0, 0.0, 0.0);
+
+    PhysicsWorld world;
+    world_init(&world);
+    mu_assert("import failed", world_import(&world, objects, 5) == 0);
+
+    CollisionPair a[10], b[10];
+    int na = collision_detect(objects, 5, a, 10);
+    int nb = collision_detect_world(&world, b, 10);
+    mu_assert("expected two pairs", na == 2);
+    mu_assert("pair count differs", nb == na);
+    for (int k = 0; k < na; k++) {
+        int found = 0;
+        for (int m = 0; m < nb; m++)
+            found |= a[k].index_a == b[m].index_a && a[k].index_b == b[m].index_b;
+        mu_assert("pair missing from world result", found);
+    }
+
+    world_free(&world);
+    return NULL;
+}
+
+/**
+ * sim_run_world() with the Verlet integrator follows sim_run_stats() bitwise,
+ * including a collision between two cubes; other integrators round-trip
+ * through the PhysicsObject path.
+ */
+static char *test_sim_matches_objects() {
+    enum { N = 12 };
+    PhysicsObject objects[N];
+    make_cloud(objects, N);
+    make_unit_cube(&objects[0], 1.0e3, 0.0, 0.0, 0.0);
+    make_unit_cube(&objects[1], 1.0e3, 1.2, 0.0, 0.0);
+    objects[1].velocity = (Vec3){ -1.0, 0.0, 0.0 };
+
+    const SimIntegrator integrators[2] = { SIM_INTEGRATOR_VERLET, SIM_INTEGRATOR_KDK };
+    for (int s = 0; s < 2; s++) {
+        PhysicsObject reference[N];
+        memcpy(reference, objects, sizeof(objects));
+
+        PhysicsWorld world;
+        world_init(&world);
+        mu_assert("import failed", world_import(&world, objects, N) == 0);
+
+        SimConfig config;
+        sim_config_default(&config);
+        config.integrator = integrators[s];
+
+        SimStats ref_stats, world_stats;
+        sim_run_stats(reference, N, 0.05, 40, &config, &ref_stats);
+        sim_run_world(&world, 0.05, 40, &config, &world_stats);
+
+        for (int i = 0; i < N; i++) {
+            mu_assert("position differs", vec3_same(world.position[i], reference[i].position));
+            mu_assert("velocity differs", vec3_same(world.velocity[i], reference[i].velocity));
+        }
+        mu_assert("cubes did not collide", reference[1].velocity.x > -1.0);
+        mu_assert("step count differs", world_stats.steps == ref_stats.steps);
+        mu_assert("evaluation count differs",
+                  world_stats.force_evaluations == ref_stats.force_evaluations);
+        world_free(&world);
+    }
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"import_export_round_trip",   test_import_export_round_trip},
+    {"step_matches_object_step",   test_step_matches_object_step},
+    {"gravity_matches_objects",    test_gravity_matches_objects},
+    {"collision_matches_objects",  test_collision_matches_objects},
+    {"sim_matches_objects",        test_sim_matches_objects},
+};
+
+int main(void) {
+    int failed = run_suite("PhysicsWorld", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}
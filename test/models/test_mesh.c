@@ -0,0 +1,150 @@
+/**
+ * @file test_mesh.c
+ * @brief Unit tests for the mesh registry.
+ *
+ * Tests cover: registering and looking up meshes, ids shared by many objects,
+ * meshes of any size packed exactly into the pools, rejection of invalid
+ * input, and clearing the registry.
+ *
+ * @author Steven Kight
+ */
+
+#include "mesh.h"
+#include "test_runner.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const Vec3 tetra_verts[4] = {
+    { 0.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 },
+};
+static const int tetra_faces[4][3] = {
+    { 0, 2, 1 }, { 0, 1, 3 }, { 0, 3, 2 }, { 1, 2, 3 },
+};
+
+/**
+ * A registered mesh gets a positive id and mesh_get() returns a copy of its
+ * geometry; MESH_NONE and unknown ids look up to NULL.
+ */
+static char *test_register_and_get() {
+    mesh_registry_clear();
+
+    int id = mesh_register(tetra_verts, 4, tetra_faces, 4);
+    mu_assert("first id should be 1", id == 1);
+    mu_assert("count", mesh_registry_count() == 1);
+
+    const ObjectMesh *mesh = mesh_get(id);
+    mu_assert("lookup failed", mesh != NULL);
+    mu_assert("vertex count", mesh->vertex_count == 4);
+    mu_assert("face count", mesh->face_count == 4);
+    mu_assert_double_eq("vertex 3 z", mesh_vertices(mesh)[3].z, 1.0, 0.0);
+    mu_assert("face 3", mesh_faces(mesh)[3][0] == 1 && mesh_faces(mesh)[3][2] == 3);
+
+    mu_assert("MESH_NONE has no mesh", mesh_get(MESH_NONE) == NULL);
+    mu_assert("unknown id has no mesh", mesh_get(2) == NULL);
+    mu_assert("negative id has no mesh", mesh_get(-1) == NULL);
+    return NULL;
+}
+
+/**
+ * Many bodies reference one mesh by id, so a body is a small fraction of the
+ * geometry it uses, and ids stay valid as the registry grows.
+ */
+static char *test_shared_by_id() {
+    mesh_registry_clear();
+
+    int ids[100];
+    for (int k = 0; k < 100; k++) {
+        ids[k] = mesh_register(tetra_verts, 4, tetra_faces, 4);
+        mu_assert("registration failed", ids[k] == k + 1);
+    }
+
+    PhysicsObject objects[1000];
+    for (int i = 0; i < 1000; i++) {
+        object_init(&objects[i], 1.0, i, 0.0, 0.0);
+        objects[i].mesh_id = ids[i % 100];
+    }
+    mu_assert("new objects start without a mesh", MESH_NONE == 0);
+    mu_assert("object references mesh", mesh_get(objects[999].mesh_id) == mesh_get(100));
+    mu_assert("PhysicsObject should not embed geometry", sizeof(PhysicsObject) <= 128);
+    return NULL;
+}
+
+/**
+ * A 2000-vertex fan (far beyond the old 64-vertex inline limit) registers,
+ * and the pools hold exactly the vertices and faces registered — a small
+ * mesh next to it pays nothing for the large one.
+ */
+static char *test_any_size_packed() {
+    mesh_registry_clear();
+
+    enum { N = 2000 };
+    Vec3 *verts = malloc(N * sizeof(Vec3));
+    int (*faces)[3] = malloc((N - 2) * sizeof(faces[0]));
+    mu_assert("allocation failed", verts && faces);
+    for (int i = 0; i < N; i++) {
+        verts[i] = (Vec3){ cos(2.0 * M_PI * i / N), sin(2.0 * M_PI * i / N), 0.0 };
+    }
+    for (int f = 0; f < N - 2; f++) {
+        faces[f][0] = 0; faces[f][1] = f + 1; faces[f][2] = f + 2;
+    }
+
+    int small = mesh_register(tetra_verts, 4, tetra_faces, 4);
+    int large = mesh_register(verts, N, (const int (*)[3])faces, N - 2);
+    free(verts);
+    free(faces);
+    mu_assert("large mesh rejected", large == small + 1);
+
+    int total_verts, total_faces;
+    mesh_registry_usage(&total_verts, &total_faces);
+    mu_assert("vertex pool not exact", total_verts == 4 + N);
+    mu_assert("face pool not exact",   total_faces == 4 + N - 2);
+
+    const ObjectMesh *m = mesh_get(large);
+    mu_assert("large offsets", m->vertex_offset == 4 && m->face_offset == 4);
+    mu_assert("large counts", m->vertex_count == N && m->face_count == N - 2);
+    mu_assert("faces index own vertices", mesh_faces(m)[N - 3][2] == N - 1);
+    mu_assert_double_eq("last vertex", mesh_vertices(m)[N / 2].x, -1.0, 1e-12);
+    mu_assert_double_eq("small mesh intact", mesh_vertices(mesh_get(small))[1].x, 1.0, 0.0);
+    return NULL;
+}
+
+/** Empty meshes and out-of-range face indices are rejected. */
+static char *test_rejects_invalid() {
+    mesh_registry_clear();
+
+    const int bad_faces[1][3] = { { 0, 1, 4 } };
+    const int neg_faces[1][3] = { { 0, -1, 2 } };
+    mu_assert("no vertices",        mesh_register(tetra_verts, 0, tetra_faces, 4) == -1);
+    mu_assert("no faces",           mesh_register(tetra_verts, 4, tetra_faces, 0) == -1);
+    mu_assert("index out of range", mesh_register(tetra_verts, 4, bad_faces, 1) == -1);
+    mu_assert("negative index",     mesh_register(tetra_verts, 4, neg_faces, 1) == -1);
+    mu_assert("nothing registered", mesh_registry_count() == 0);
+    return NULL;
+}
+
+/** Clearing forgets every mesh and restarts ids at 1. */
+static char *test_clear() {
+    mesh_registry_clear();
+    mesh_register(tetra_verts, 4, tetra_faces, 4);
+    mesh_register(tetra_verts, 4, tetra_faces, 4);
+
+    mesh_registry_clear();
+    mu_assert("count after clear", mesh_registry_count() == 0);
+    mu_assert("old id gone", mesh_get(1) == NULL);
+    mu_assert("ids restart", mesh_register(tetra_verts, 4, tetra_faces, 4) == 1);
+    mesh_registry_clear();
+    return NULL;
+}
+
+static const TestCase tests[] = {
+    {"register_and_get", test_register_and_get},
+    {"shared_by_id",     test_shared_by_id},
+    {"any_size_packed",  test_any_size_packed},
+    {"rejects_invalid",  test_rejects_invalid},
+    {"clear",            test_clear},
+};
+
+int main(void) {
+    int failed = run_suite("Mesh Registry", tests, sizeof(tests) / sizeof(tests[0]));
+    return finish_suite(failed);
+}